@@ -18,55 +18,143 @@
  */
 
 #include <stdio.h>           // Biblioteca padrão de entrada e saída
-#include <stdlib.h>          // Biblioteca para manipulação de memória e funções rand()
+#include <stdlib.h>          // Biblioteca para manipulação de memória
 #include <string.h>          // Biblioteca para manipulação de strings
 #include "pico/stdlib.h"     // Biblioteca padrão do Raspberry Pi Pico
-#include "hardware/timer.h"  // Biblioteca para manipulação de timers no RP2040
-#include "hardware/pwm.h"    // Biblioteca para controle de PWM
-#include "hardware/clocks.h" // Biblioteca para manipulação de clocks
-#include "hardware/gpio.h"   // Biblioteca para manipulação de GPIOs
-#include "hardware/i2c.h"    // Biblioteca para comunicação I2C
+#include "hardware/sync.h"   // __wfi na espera de baixo consumo
+#include "pico/stdio_usb.h"  // Host USB presente (decide entre sono e dormant)
 #include "inc/ssd1306.h"     // Biblioteca para comunicação com o display OLED
+#include "inc/reaction_stats.h" // Estatísticas online dos tempos de reação
+#include "inc/result_log.h"     // Registro persistente dos resultados na flash
+#include "inc/telemetry.h"      // Telemetria binária pela USB
+#include "inc/trace.h"          // Trace de eventos em RAM
+#include "inc/random.h"         // Gerador aleatório semeado pelo ROSC
+#include "inc/multi_capture.h"  // Captura simultânea de vários jogadores
+#include "inc/tone.h"           // Tons e melodias no buzzer
+#include "inc/pcm.h"            // Áudio amostrado no buzzer por DMA
+#include "inc/led_fx.h"         // Efeitos nos LEDs pelo IRQ de wrap do PWM
+#include "inc/power.h"          // Dormant com despertar pelo botão A
+#include "inc/clock_scale.h"    // clk_sys por fase do jogo
+#include "inc/ram_capture.h"    // Caminho de captura em SRAM (opcional)
+#include "inc/boot.h"           // Tempos das fases do boot
+#include "inc/hal.h"            // Tempo, entradas, saídas e barramento do display
+#include "inc/game.h"           // Máquina de estados da rodada
+#include "inc/stimulus.h"       // Estímulos dos modos de escolha e vai/não vai
+#include "inc/irq_latency.h"    // Diagnóstico de latência de IRQ
+#include "inc/anim.h"           // Animações no display a partir da flash
+#include "inc/anim_best.h"      // Animação de recorde pessoal (tools/anim_encode)
 
 // Definição dos pinos utilizados no projeto
 #define BUTTON_START 5 // Botão A - Inicia o jogo
 #define BUTTON_STOP 6  // Botão B - Captura o tempo de reação
+#define BUTTON_JOYSTICK 22 // Botão do joystick - Jogador 2 no modo multijogador
 #define LED_GREEN 11   // LED Verde - Indica preparação (via PWM)
 #define LED_RED 13     // LED Vermelho - Indica reação (via PWM)
 #define BUZZER 21      // Buzzer para emitir som ao acionar o LED vermelho
 #define I2C_SDA 14     // Pino SDA para o display OLED
 #define I2C_SCL 15     // Pino SCL para o display OLED
+#define LATENCY_PROBE_PIN 18 // Gerador de bordas do diagnóstico de latência (deixar desconectado)
 
-// Definição dos parâmetros para o PWM dos LEDs
-#define LED_PWM_WRAP 1000         /**< Valor de wrap do PWM para os LEDs (define o período) */
-#define LED_ON (LED_PWM_WRAP / 8) /**< Nível de PWM para 50% do duty cycle (LED aceso com brilho reduzido) */
+// Brilho dos LEDs acesos, perceptual (0 a 255); inc/led_fx.h aplica a correção de gama
+#define LED_ON 99 /**< Nível de PWM 125 de 1000 (LED aceso com brilho reduzido) */
+
+// Modos de jogo registrados no log de resultados
+#define GAME_MODE_SIMPLE 0 /**< Reação simples: um estímulo, um botão */
+#define GAME_MODE_MULTI 1  /**< Vários jogadores; o índice do jogador vai nos bits 4-7 do modo */
+#define GAME_MODE_CHOICE 2 /**< Escolha: cada estímulo pede um botão; o índice do estímulo nos bits 4-7 */
+#define GAME_MODE_GO_NO_GO 3 /**< Vai/não vai: reagir só aos estímulos "vai"; índice nos bits 4-7 */
+
+// Botões dos jogadores no modo multijogador (ativos em 0, com pull-up): J1 é o botão B,
+// J2 o do joystick e J3/J4 ficam em GPIOs livres do conector de expansão
+const uint8_t player_buttons[multi_capture_max_players] = {BUTTON_STOP, BUTTON_JOYSTICK, 16, 17};
+#define PLAYERS_DEFAULT 1     /**< Jogadores no boot; 'P' + dígito pela USB troca (1 a 4) */
+#define MULTI_TIMEOUT_MS 3000 /**< Fim da rodada multijogador se alguém não pressionar */
+#define IDLE_TIMEOUT_MS 60000 /**< Espera sem atividade até o baixo consumo (0: nunca) */
+#define SESSION_ROUNDS_DEFAULT 0 /**< Rodadas por sessão no boot; 'S' + número pela USB troca (0: avulsas) */
+#define SESSION_ITI_MS 1500      /**< Na sessão, resultado na tela até a próxima preparação */
+#define SESSION_ROUNDS_MAX 99    /**< Maior sessão ('S' aceita dois dígitos) */
+#define CHOICE_WINDOW_MS 1500    /**< Prazo de resposta nos modos de escolha e vai/não vai */
+#define STIMULUS_CLOCK_LEAD_US 5000 /**< Clock alto antes do estímulo agendado (religa o PLL) */
+#define STIMULUS_SCREEN_LEAD_US 1000 /**< Laço acordado antes da tela invertida agendada (espera ativa) */
+#define LATENCY_SAMPLES 2000     /**< Bordas medidas por carga no diagnóstico de latência ('L') */
+#define LATENCY_ALARM_US 50      /**< Período do alarme da carga de alarmes do diagnóstico */
+#define LATENCY_LOAD_TIMEOUT_MS 5000 /**< Prazo de cada carga do diagnóstico (2000 bordas levam ~1 s) */
+#define DEBOUNCE_MS 50           /**< Intervalo mínimo entre leituras do botão A */
+#define LOOP_WAIT_MAX_MS 100     /**< Maior espera do laço sem prazo nem interrupção */
+#define LOOP_USB_FRAME_US 1000   /**< Com a FIFO do CDC cheia, nova tentativa no próximo quadro USB */
+
+// Melodia da queima de largada (descendente), tocada sem bloquear o laço principal
+const tone_note_t capture_data(false_start_melody) false_start_melody[] = {
+    {.frequency_hz = 784, .duration_ms = 120, .volume = 255},
+    {.frequency_hz = 0, .duration_ms = 40},
+    {.frequency_hz = 523, .duration_ms = 120, .volume = 255},
+    {.frequency_hz = 0, .duration_ms = 40},
+    {.frequency_hz = 262, .duration_ms = 400, .volume = 255},
+};
+
+// Estímulos dos modos de escolha ('M2': botão B ou do joystick) e vai/não vai ('M3': botão
+// B só nos "vai"), sorteados por peso a cada rodada (inc/stimulus.h)
+const stimulus_t capture_data(choice_stimuli) choice_stimuli[] = {
+    {.name = "VERM", .kind = stimulus_led, .pin = LED_RED, .level = LED_ON, .button = BUTTON_STOP, .weight = 1},
+    {.name = "AGUDO", .kind = stimulus_tone, .note = {.frequency_hz = 3000, .duration_ms = 300, .volume = 255},
+     .button = BUTTON_STOP, .weight = 1},
+    {.name = "VERDE", .kind = stimulus_led, .pin = LED_GREEN, .level = LED_ON, .button = BUTTON_JOYSTICK, .weight = 1},
+    {.name = "TELA", .kind = stimulus_screen, .button = BUTTON_JOYSTICK, .weight = 1},
+};
+const stimulus_t capture_data(go_no_go_stimuli) go_no_go_stimuli[] = {
+    {.name = "VERM", .kind = stimulus_led, .pin = LED_RED, .level = LED_ON, .button = BUTTON_STOP, .weight = 2},
+    {.name = "AGUDO", .kind = stimulus_tone, .note = {.frequency_hz = 3000, .duration_ms = 300, .volume = 255},
+     .button = BUTTON_STOP, .weight = 1},
+    {.name = "VERDE", .kind = stimulus_led, .pin = LED_GREEN, .level = LED_ON, .button = stimulus_no_go, .weight = 1},
+    {.name = "GRAVE", .kind = stimulus_tone, .note = {.frequency_hz = 400, .duration_ms = 300, .volume = 255},
+     .button = stimulus_no_go, .weight = 1},
+};
+
+// Atraso entre "PREPARAR" e o estímulo (inc/random.h): uniforme, exponencial ou tabela.
+// Ex.: {.kind = foreperiod_exponential, .min_ms = 1000, .max_ms = 5000, .mean_ms = 1200}
+const foreperiod_dist_t foreperiod = {.kind = foreperiod_uniform, .min_ms = 1000, .max_ms = 5000};
 
 // Variáveis globais para controle do jogo
-bool game_running = false;                  /**< Indica se o jogo está em execução */
+game_t game;                                /**< Rodada em andamento (inc/game.h) */
 bool reaction_phase = false;                /**< Indica se o jogador deve reagir */
-absolute_time_t start_time, reaction_time;  /**< Armazena os tempos de início e de reação */
-volatile bool buzzer_active = false;        /**< Indica se o buzzer está ativo */
-volatile bool false_start_detected = false; /**< Indica se houve uma queima de largada */
-volatile bool button_b_pressed = false;     /**< Indica se o botão B foi pressionado */
+uint64_t start_time, reaction_time;         /**< Instantes do estímulo e da reação (µs) */
+volatile bool response_captured = false;    /**< Resposta da rodada capturada (botão B no modo simples) */
+reaction_stats_t player_stats;              /**< Estatísticas acumuladas do jogador */
+uint8_t game_state = telemetry_state_idle;  /**< Último estado reportado pela telemetria */
+uint8_t player_count = PLAYERS_DEFAULT;     /**< Jogadores na próxima rodada */
+multi_capture_t players;                    /**< Tempos de cada jogador no modo multijogador */
+uint32_t idle_since_ms;                     /**< Última atividade (rodada, botão A ou USB) */
+bool idle_asleep = false;                   /**< Painel e PWM desligados até o botão A */
+uint8_t display_boot_step = 0;              /**< Etapa do display no boot (display_boot_service) */
+char display_last[8 * 15 + 1] = "PRESSIONE A    PARA COMECAR!"; /**< Tela atual, redesenhada quando o painel volta */
+bool usb_host_present = false;              /**< Host USB conectado na volta anterior do laço */
+uint32_t next_foreperiod_ms;                /**< Atraso sorteado para a próxima rodada */
+reaction_stats_t session_stats;             /**< Tempos da sessão em andamento */
+uint32_t session_times_us[SESSION_ROUNDS_MAX]; /**< Tempos da sessão, na ordem (mediana exata no resumo) */
+uint8_t session_false_starts;               /**< Queimas de largada da sessão em andamento */
+uint32_t session_last_us;                   /**< Último tempo da sessão (0: rodada sem tempo) */
+uint8_t game_mode = GAME_MODE_SIMPLE;       /**< Simples, escolha ou vai/não vai ('M' pela USB) */
+const stimulus_t *stimuli;                  /**< Estímulos do modo (NULL no simples) */
+size_t stimuli_count;
+const stimulus_t *stimulus_current;         /**< Estímulo sorteado para a rodada (NULL no simples) */
+stimulus_stats_t stimulus_stats[stimulus_max]; /**< Resultados por tipo de estímulo do modo */
+hal_alarm_t stimulus_alarm;                 /**< Alarme do início do estímulo */
+volatile uint64_t stimulus_onset_us;        /**< Início real do estímulo (0: ainda não) */
+volatile uint8_t response_pin;              /**< Botão da resposta capturada */
+irq_latency_stats_t latency_stats[irq_load_count]; /**< Último diagnóstico de latência, por carga */
+anim_player_t anim;                         /**< Animação na tela (inc/anim.h) */
+uint32_t debounce_last_ms;                  /**< Última leitura do botão A (debounce_button) */
+
+// Etapas do display no boot: os comandos de inicialização e uma página por vez da 1ª tela
+#define DISPLAY_BOOT_DONE (1 + ssd1306_n_pages)
 
 /**
- * @brief Exibe um texto no display OLED, quebrando linhas automaticamente.
+ * @brief Desenha um texto num quadro do display, quebrando linhas a cada 15 caracteres.
  *
- * Cada linha comporta até 15 caracteres. Essa função utiliza as funções da
- * biblioteca ssd1306 para desenhar strings e renderizar o conteúdo no display.
- *
- * @param text Mensagem a ser exibida no display.
+ * @param ssd Quadro de ssd1306_buffer_length bytes, apagado antes do desenho.
  */
-void display_text(const char *text)
+void display_render(const char *text, uint8_t *ssd)
 {
-    struct render_area frame_area = {
-        .start_column = 0,
-        .end_column = ssd1306_width - 1,
-        .start_page = 0,
-        .end_page = ssd1306_n_pages - 1};
-
-    calculate_render_area_buffer_length(&frame_area);
-    uint8_t ssd[ssd1306_buffer_length];
     memset(ssd, 0, ssd1306_buffer_length);
 
     int y = 0;
@@ -83,92 +171,189 @@ void display_text(const char *text)
         if (y >= ssd1306_height)
             break;
     }
-
-    render_on_display(ssd, &frame_area);
 }
 
 /**
- * @brief Inicializa o PWM no pino do buzzer.
+ * @brief Exibe um texto no display OLED, quebrando linhas automaticamente.
  *
- * Configura o pino especificado para funcionar como saída PWM, define
- * o divisor de clock e inicializa o PWM com duty cycle 0.
+ * Cada linha comporta até 15 caracteres. Essa função utiliza as funções da
+ * biblioteca ssd1306 para desenhar strings e renderizar o conteúdo no display.
  *
- * @param pin Pino do buzzer.
+ * @param text Mensagem a ser exibida no display.
  */
-void pwm_init_buzzer(uint pin)
+void display_text(const char *text)
 {
-    gpio_set_function(pin, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(pin);
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 4.0f); // Ajusta divisor de clock
-    pwm_init(slice_num, &config, true);
-    pwm_set_gpio_level(pin, 0); // Desliga o PWM inicialmente
+    if (text != display_last)
+    {
+        snprintf(display_last, sizeof(display_last), "%s", text);
+    }
+
+    // Durante uma animação a tela nova só é guardada, e aparece quando ela termina; o início
+    // de uma rodada interrompe a animação
+    if (anim_playing(&anim))
+    {
+        if (!game_timing(&game))
+            return;
+        anim_stop(&anim);
+    }
+
+    // Antes do fim do boot do display, esta tela substitui a inicial: completa só os comandos
+    bool boot_pending = display_boot_step != DISPLAY_BOOT_DONE;
+    if (boot_pending && display_boot_step == 0 && ssd1306_probe())
+    {
+        ssd1306_init();
+    }
+    display_boot_step = DISPLAY_BOOT_DONE;
+
+    // Sem display (ausente no boot ou fora de linha), nada é desenhado nem enviado: a tela
+    // fica em display_last até ele voltar
+    if (ssd1306_online())
+    {
+        struct render_area frame_area = {
+            .start_column = 0,
+            .end_column = ssd1306_width - 1,
+            .start_page = 0,
+            .end_page = ssd1306_n_pages - 1};
+
+        calculate_render_area_buffer_length(&frame_area);
+        uint8_t ssd[ssd1306_buffer_length];
+        display_render(text, ssd);
+
+        // O envio roda no clock alto, mantido pelas telas seguidas; o da fase volta em
+        // clock_scale_service
+        clock_scale_render(hal_time_ms());
+        uint64_t flush_start = hal_time_us();
+        render_on_display(ssd, &frame_area);
+        telemetry_push_at(flush_start, telemetry_type_display, (uint32_t)(hal_time_us() - flush_start), frame_area.buffer_length);
+    }
+    if (boot_pending)
+    {
+        boot_mark(boot_phase_display);
+    }
 }
 
 /**
- * @brief Inicializa o PWM para controle de um LED.
+ * @brief Avança a inicialização do display no boot, uma etapa por chamada.
  *
- * Configura o pino especificado para funcionar como saída PWM, define
- * um período fixo (wrap) e deixa o LED inicialmente desligado.
+ * Chamada do laço principal: os botões já funcionam enquanto o painel é configurado (uma
+ * transação com todos os comandos) e a tela inicial é enviada uma página por vez (~3 ms
+ * cada a 400 kHz, no clock da espera), em vez de um quadro inteiro bloqueando o laço.
+ */
+void display_boot_service()
+{
+    if (display_boot_step == DISPLAY_BOOT_DONE)
+        return;
+
+    if (display_boot_step == 0)
+    {
+        // Sem resposta no endereço: unidade sem display (o laço continua procurando)
+        if (ssd1306_probe())
+        {
+            ssd1306_init();
+        }
+    }
+    else if (ssd1306_online())
+    {
+        uint8_t page = display_boot_step - 1;
+        struct render_area page_area = {
+            .start_column = 0,
+            .end_column = ssd1306_width - 1,
+            .start_page = page,
+            .end_page = page};
+        calculate_render_area_buffer_length(&page_area);
+
+        uint8_t ssd[ssd1306_buffer_length];
+        display_render(display_last, ssd);
+        render_on_display(ssd + page * ssd1306_width, &page_area);
+    }
+
+    // Sem painel, o boot do display termina aqui; se ele aparecer, a tela vem inteira
+    if (!ssd1306_online() || ++display_boot_step == DISPLAY_BOOT_DONE)
+    {
+        display_boot_step = DISPLAY_BOOT_DONE;
+        boot_mark(boot_phase_display);
+    }
+}
+
+/**
+ * @brief Exibe o resultado da rodada seguido das estatísticas acumuladas.
+ *
+ * A primeira linha recebe o cabeçalho (ex.: o tempo da rodada) e as demais mostram
+ * contagem, média, mínimo/máximo, desvio padrão e os percentis P50/P90/P99.
  *
- * @param pin Pino do LED.
+ * @param header Texto da primeira linha (até 15 caracteres).
  */
-void pwm_init_led(uint pin)
+void display_stats_screen(const char *header)
 {
-    gpio_set_function(pin, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(pin);
-    pwm_config config = pwm_get_default_config();
-    pwm_init(slice_num, &config, true);
-    pwm_set_wrap(slice_num, LED_PWM_WRAP);
-    pwm_set_gpio_level(pin, 0); // LED desligado inicialmente
+    char screen[8 * 15 + 1];
+    int len = snprintf(screen, sizeof(screen), "%-15.15s", header);
+    reaction_stats_format(&player_stats, screen + len, sizeof(screen) - len);
+    display_text(screen);
 }
 
 /**
- * @brief Callback chamado para desligar o buzzer após um tempo determinado.
+ * @brief Registra uma transição de estado do jogo na telemetria.
  *
- * Esta função é chamada pelo sistema de alarmes para interromper o som no buzzer.
+ * @param state Novo estado (telemetry_state_*).
+ */
+void set_game_state(uint8_t state)
+{
+    trace_event(trace_state, state);
+    telemetry_push(telemetry_type_state, state, game_state);
+    game_state = state;
+}
+
+/**
+ * @brief Guarda uma rodada no registro da flash (inc/result_log.h).
  *
- * @param id Identificador do alarme (não utilizado)
- * @param user_data Ponteiro para dados do usuário (não utilizado)
- * @return int64_t 0, para indicar que não há necessidade de reiniciar o alarme.
+ * Só é chamada depois da reação: com o lote em RAM cheio, ele é gravado aqui mesmo (o XIP
+ * fica suspenso por ~1 ms, ou ~45 ms quando um setor precisa ser apagado) e a rodada entra
+ * no lote seguinte, em vez de ser descartada.
  */
-int64_t stop_buzzer(alarm_id_t id, void *user_data)
+void log_round(uint32_t timestamp_ms, uint32_t reaction_us, uint8_t flags, uint8_t mode)
 {
-    pwm_set_gpio_level(BUZZER, 0);
-    buzzer_active = false;
-    return 0;
+    if (!result_log_append(timestamp_ms, reaction_us, flags, mode) && result_log_service(timestamp_ms, true))
+    {
+        result_log_append(timestamp_ms, reaction_us, flags, mode);
+    }
 }
 
 /**
  * @brief Emite um som curto no buzzer para alertar o jogador.
  *
- * Configura o PWM do buzzer para gerar uma nota com 50% de duty cycle por um tempo determinado.
+ * Toca uma nota única pelo sequenciador (inc/tone.h), que desliga o buzzer no alarme;
+ * não interrompe um som em andamento.
  *
  * @param frequency Frequência da nota (Hz)
  * @param duration_ms Duração da nota (ms)
  */
-void buzzer_beep(uint frequency, uint duration_ms)
+void capture_func(buzzer_beep)(uint frequency, uint duration_ms)
 {
-    if (buzzer_active)
-        return;
-
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER);
-    uint32_t clock_freq = clock_get_hz(clk_sys);
-    uint32_t top = clock_freq / frequency - 1;
+    static tone_note_t beep;
 
-    pwm_set_wrap(slice_num, top);
-    pwm_set_gpio_level(BUZZER, top / 2); // 50% de duty cycle
-    buzzer_active = true;
+    if (tone_playing())
+        return;
 
-    add_alarm_in_ms(duration_ms, stop_buzzer, NULL, false);
+    beep = (tone_note_t){.frequency_hz = frequency, .duration_ms = duration_ms, .volume = 255};
+    tone_play(&beep, 1);
 }
 
 /**
  * @brief Inicia o temporizador do jogo, marcando o tempo inicial.
  */
-void start_timer()
+void capture_func(start_timer)()
 {
-    start_time = get_absolute_time();
+    start_time = hal_time_us();
+}
+
+/**
+ * @brief Calcula o tempo de reação do jogador em microssegundos.
+ *
+ * @return uint32_t Tempo decorrido em microssegundos.
+ */
+uint32_t get_elapsed_time_us()
+{
+    return reaction_time - start_time;
 }
 
 /**
@@ -180,7 +365,7 @@ void start_timer()
  */
 uint32_t get_elapsed_time()
 {
-    return absolute_time_diff_us(start_time, reaction_time) / 1000;
+    return get_elapsed_time_us() / 1000;
 }
 
 /**
@@ -194,103 +379,807 @@ uint32_t get_elapsed_time()
  */
 bool debounce_button(uint gpio)
 {
-    static uint32_t last_time = 0;
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
+    uint32_t current_time = hal_time_ms();
 
-    if (current_time - last_time < 50)
+    if (current_time - debounce_last_ms < DEBOUNCE_MS)
     {
         return false;
     }
 
-    last_time = current_time;
-    return gpio_get(gpio) == 0;
+    debounce_last_ms = current_time;
+    return hal_input_pressed(gpio);
 }
 
 /**
- * @brief Inicia uma nova rodada do jogo.
+ * @brief Passo do estímulo: apresentação, início da contagem e captura armada.
  *
- * Configura o estado inicial do jogo, atualiza o display e controla os LEDs e buzzer
- * para sinalizar a preparação e o início da fase de reação.
+ * No modo simples, LED vermelho e beep; nos de escolha, o estímulo sorteado (a tela já foi
+ * invertida por stimulus_screen_service). A contagem começa depois da apresentação.
  */
-void start_game()
+void capture_func(fire_stimulus)()
 {
-    if (!game_running)
+    if (stimulus_current)
+    {
+        stimulus_on(stimulus_current);
+    }
+    else
+    {
+        // Desliga o LED verde e liga o LED vermelho com PWM
+        led_fx_set(LED_GREEN, 0);
+        led_fx_set(LED_RED, LED_ON);
+
+        // Emite um beep curto com o buzzer
+        buzzer_beep(3000, 300);
+    }
+    start_timer();
+    if (player_count > 1)
+    {
+        multi_capture_arm(&players, start_time);
+    }
+    reaction_phase = true;
+}
+
+/**
+ * @brief Estímulo apresentado: telemetria com o atraso sobre o agendado e o início para a
+ * máquina, que passa à reação quando vê stimulus_onset_us.
+ */
+void capture_func(mark_stimulus_onset)()
+{
+    uint64_t late_us = start_time - game.phase_end_us;
+    telemetry_push_at(start_time, telemetry_type_stimulus, stimulus_current ? stimulus_current - stimuli : 0xFF,
+                      late_us > 0xFFFFFFFF ? 0xFFFFFFFF : late_us);
+    stimulus_onset_us = start_time;
+}
+
+/**
+ * @brief Alarme do início do estímulo, agendado pela máquina da rodada (game.phase_end_us).
+ *
+ * Todos os estímulos, menos a tela (stimulus_screen_service), saem daqui: do IRQ do
+ * temporizador, não de uma volta do laço principal.
+ */
+int64_t capture_func(stimulus_alarm_fired)(hal_alarm_t alarm, void *data)
+{
+    (void)alarm;
+    (void)data;
+    stimulus_alarm = 0;
+    fire_stimulus();
+    mark_stimulus_onset();
+    return 0;
+}
+
+// Estímulo da rodada apresentado pelo laço principal (a tela), não pelo alarme
+bool stimulus_from_loop()
+{
+    return stimulus_current && stimulus_current->kind == stimulus_screen;
+}
+
+/**
+ * @brief Tela invertida no instante agendado, pelo laço principal.
+ *
+ * A escrita I2C bloqueia e, numa falha, recupera o barramento: fica fora do IRQ do alarme e
+ * não disputa o driver com as telas, que também saem do laço. O laço acorda
+ * STIMULUS_SCREEN_LEAD_US antes (loop_wait) e espera ativamente até o instante. A contagem
+ * começa quando a escrita termina, com os IRQs desligados como no alarme, então a captura
+ * do callback vê start_time e reaction_phase juntos. O painel ainda leva de 0 a um quadro
+ * (ssd1306_frame_us) para mostrar a inversão em cada linha (inc/stimulus.h).
+ */
+void stimulus_screen_service()
+{
+    if (game.state != telemetry_state_foreperiod || stimulus_onset_us || !stimulus_from_loop() ||
+        hal_time_us() + STIMULUS_SCREEN_LEAD_US < game.phase_end_us)
+        return;
+
+    hal_busy_wait_until(game.phase_end_us);
+    stimulus_screen_on();
+    uint32_t irq_state = save_and_disable_interrupts();
+    fire_stimulus();
+    mark_stimulus_onset();
+    restore_interrupts(irq_state);
+}
+
+/**
+ * @brief Na preparação, sobe o clock um pouco antes do estímulo agendado.
+ *
+ * Religar o PLL fica fora da janela de reação; o alarme conta pelo cristal.
+ */
+void stimulus_clock_service()
+{
+    if (game.state == telemetry_state_foreperiod && clock_scale_phase() != clock_phase_reaction &&
+        hal_time_us() + STIMULUS_CLOCK_LEAD_US >= game.phase_end_us)
+    {
+        clock_scale_set(clock_phase_reaction);
+    }
+}
+
+/**
+ * @brief Tela da preparação; na sessão, com a rodada e o tempo anterior.
+ */
+void round_prepare_screen()
+{
+    if (!game.session_rounds)
     {
-        game_running = true;
-        reaction_phase = false;
-        false_start_detected = false;
-        button_b_pressed = false;
         display_text("PREPARAR...!");
+        return;
+    }
+
+    // Na sessão o resultado anterior continua na tela durante a preparação
+    char screen[3 * 15 + 1];
+    if (game.session_round == 1)
+    {
+        reaction_stats_init(&session_stats);
+        session_false_starts = 0;
+        session_last_us = 0;
+    }
+    char round[20];
+    snprintf(round, sizeof(round), "RODADA %u DE %u", game.session_round, game.session_rounds);
+    int len = snprintf(screen, sizeof(screen), "%-15.15s%-15s", round, "PREPARAR...!");
+    if (game.session_round > 1)
+    {
+        if (session_last_us)
+            snprintf(screen + len, sizeof(screen) - len, "ULT. %.1f MS", session_last_us / 1000.0f);
+        else
+            snprintf(screen + len, sizeof(screen) - len, "ULT. SEM TEMPO");
+    }
+    display_text(screen);
+}
+
+/**
+ * @brief Início da rodada (game_action_prepare): LED verde, tela de preparação e o alarme
+ * do estímulo.
+ *
+ * O LED vem antes da tela: a preparação conta do passo da máquina, e o envio ao display
+ * leva ~23 ms. O alarme é armado depois da tela, então o estímulo nunca disputa o I2C com
+ * ela. Nos modos de escolha os LEDs são estímulos, e só a tela indica a preparação.
+ */
+void round_prepare()
+{
+    reaction_phase = false;
+    response_captured = false;
+    stimulus_onset_us = 0;
+    next_foreperiod_ms = foreperiod_sample_ms(&foreperiod);
+    stimulus_current = stimuli ? &stimuli[stimulus_pick(stimuli, stimuli_count)] : NULL;
+
+    // Liga o LED verde com brilho reduzido; a preparação conta a partir daqui
+    if (!stimuli)
+    {
+        led_fx_set(LED_GREEN, LED_ON);
+    }
+    clock_scale_set(clock_phase_foreperiod);
+    set_game_state(telemetry_state_foreperiod);
+    round_prepare_screen();
+    if (!stimulus_from_loop())
+    {
+        stimulus_alarm = hal_alarm_at_us(game.phase_end_us, stimulus_alarm_fired, NULL);
+    }
+}
+
+/**
+ * @brief Guarda um tempo na sessão em andamento (0: rodada sem tempo).
+ */
+void session_add(uint32_t elapsed_us)
+{
+    if (!game.session_rounds)
+        return;
+    session_last_us = elapsed_us;
+    if (elapsed_us && session_stats.count < SESSION_ROUNDS_MAX)
+    {
+        session_times_us[session_stats.count] = elapsed_us;
+        reaction_stats_add(&session_stats, elapsed_us);
+    }
+}
+
+/**
+ * @brief Mediana exata dos tempos da sessão (média dos dois centrais com número par).
+ *
+ * Ordena session_times_us no lugar: só é chamada no resumo, quando a sessão terminou.
+ */
+uint32_t session_median_us()
+{
+    uint32_t count = session_stats.count;
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        uint32_t value = session_times_us[i];
+        uint32_t j = i;
+        while (j > 0 && session_times_us[j - 1] > value)
+        {
+            session_times_us[j] = session_times_us[j - 1];
+            j--;
+        }
+        session_times_us[j] = value;
+    }
+
+    if (count % 2)
+        return session_times_us[count / 2];
+    return (uint32_t)(((uint64_t)session_times_us[count / 2 - 1] + session_times_us[count / 2] + 1) / 2);
+}
+
+/**
+ * @brief Queima de largada (game_action_false_start): registro, tela, melodia e LEDs.
+ *
+ * @param early Pinos pressionados na preparação (com um jogador, o botão B e, nos modos de
+ *              escolha, o do joystick).
+ */
+void round_false_start(uint32_t early)
+{
+    uint8_t mode = game_mode;
+
+    // O estímulo não sai; se o alarme chegou a disparar junto com a pressão, é retirado
+    hal_alarm_cancel(stimulus_alarm);
+    stimulus_alarm = 0;
+    reaction_phase = false;
+    if (stimulus_current)
+    {
+        stimulus_off(stimulus_current);
+    }
+    session_false_starts++;
+    session_add(0);
+    set_game_state(telemetry_state_false_start);
+    if (player_count > 1)
+    {
+        uint8_t player = 0;
+        while (!(early & (1u << player_buttons[player])))
+            player++;
+        mode = GAME_MODE_MULTI | (player << 4);
+
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "MUITO CEDO J%u", player + 1);
+        telemetry_push(telemetry_type_round, 0, result_flag_false_start | (mode << 8));
+        display_text(buffer);
+    }
+    else
+    {
+        telemetry_push(telemetry_type_round, 0, result_flag_false_start | (mode << 8));
+        display_text("MUITO CEDO!");
+    }
+    tone_play(false_start_melody, count_of(false_start_melody));
+    // Desliga o LED verde
+    led_fx_set(LED_GREEN, 0);
+    // Pisca o LED vermelho três vezes no IRQ do PWM, enquanto a mensagem fica na tela
+    led_fx_blink(LED_RED, LED_ON, 200, 200, 3);
+    log_round(hal_time_ms(), 0, result_flag_false_start, mode);
+}
+
+/**
+ * @brief Estímulo apresentado pelo alarme (game_action_stimulus): estado e tela de reação.
+ *
+ * Nos modos de escolha a tela continua a da preparação, para não antecipar a resposta.
+ */
+void round_stimulus()
+{
+    // Normalmente já subiu em stimulus_clock_service
+    clock_scale_set(clock_phase_reaction);
+    set_game_state(telemetry_state_reaction);
+    if (!stimuli)
+    {
+        display_text(player_count > 1 ? "PRESSIONEM JA!" : "PRESSIONE B    PARA MARCAR!");
+    }
+}
+
+/**
+ * @brief Registra e exibe o tempo da rodada de um jogador (botão B).
+ */
+void finish_single_round()
+{
+    uint32_t elapsed_us = get_elapsed_time_us();
+    uint32_t elapsed_time = elapsed_us / 1000;
+    clock_scale_set(clock_phase_idle);
+    // Desliga o LED vermelho via PWM
+    led_fx_set(LED_RED, 0);
+
+    tone_cancel();
+
+    set_game_state(telemetry_state_result);
+    telemetry_push(telemetry_type_round, elapsed_us, GAME_MODE_SIMPLE << 8);
+    trace_event(trace_round, elapsed_time > 0xFFFF ? 0xFFFF : elapsed_time);
+    bool best = player_stats.count > 0 && elapsed_us < player_stats.min_us;
+    reaction_stats_add(&player_stats, elapsed_us);
+    log_round(hal_time_ms(), elapsed_us, 0, GAME_MODE_SIMPLE);
+    session_add(elapsed_us);
+
+    // Recorde pessoal: a animação vem antes, e a tela do tempo aparece quando ela termina. Na
+    // sessão a tela do resultado dura pouco, e a animação não entra
+    if (best && !game.session_rounds && ssd1306_online())
+    {
+        anim_start(&anim, &anim_best, hal_time_ms());
+    }
+
+    char buffer[20];
+    sprintf(buffer, "Tempo: %.1f ms", (float)elapsed_time);
+    display_stats_screen(buffer);
+}
+
+/**
+ * @brief Registra e exibe a rodada dos modos de escolha e vai/não vai.
+ *
+ * A resposta é julgada contra o estímulo sorteado (inc/stimulus.h); o registro (telemetria
+ * e flash) leva o tempo, os bits de erro ou omissão e o índice do estímulo no modo. A tela
+ * mostra o resultado e, por tipo de estímulo, acertos, rodadas e a média dos acertos.
+ */
+void finish_choice_round()
+{
+    size_t index = stimulus_current - stimuli;
+    stimulus_outcome_t outcome = stimulus_judge(stimulus_current, response_captured ? response_pin : stimulus_no_response);
+    uint32_t elapsed_us = response_captured ? get_elapsed_time_us() : 0;
+    uint8_t mode = game_mode | (index << 4);
+    uint8_t flags = stimulus_result_flags(outcome);
+
+    stimulus_off(stimulus_current);
+    clock_scale_set(clock_phase_idle);
+    set_game_state(telemetry_state_result);
+    telemetry_push(telemetry_type_round, elapsed_us, flags | (mode << 8));
+    log_round(hal_time_ms(), elapsed_us, flags, mode);
+    stimulus_stats_add(&stimulus_stats[index], outcome, elapsed_us);
+    session_add(outcome == stimulus_hit ? elapsed_us : 0);
+    if (outcome == stimulus_hit)
+    {
+        uint32_t elapsed_time = elapsed_us / 1000;
+        trace_event(trace_round, elapsed_time > 0xFFFF ? 0xFFFF : elapsed_time);
+    }
+
+    char screen[8 * 15 + 1];
+    char line[20];
+    switch (outcome)
+    {
+    case stimulus_hit:
+        snprintf(line, sizeof(line), "CERTO %.1f MS", elapsed_us / 1000.0f);
+        break;
+    case stimulus_error:
+        snprintf(line, sizeof(line), stimulus_current->button == stimulus_no_go ? "NAO ERA PARA IR" : "BOTAO ERRADO");
+        break;
+    case stimulus_miss:
+        snprintf(line, sizeof(line), "SEM RESPOSTA");
+        break;
+    case stimulus_withheld:
+        snprintf(line, sizeof(line), "CERTO: ESPEROU");
+        break;
+    }
+    int len = snprintf(screen, sizeof(screen), "%-15.15s%s", line, stimulus_stats_header);
+    for (size_t i = 0; i < stimuli_count && len < (int)sizeof(screen) - 1; i++)
+    {
+        len += stimulus_stats_format(&stimulus_stats[i], stimuli[i].name, screen + len, sizeof(screen) - len);
+    }
+    display_text(screen);
+}
+
+/**
+ * @brief Encerra uma rodada multijogador e exibe a classificação.
+ *
+ * Chamada quando todos pressionaram ou após MULTI_TIMEOUT_MS (game_action_result). Cada
+ * jogador que pressionou
+ * gera um registro de rodada (telemetria e flash) com o próprio tempo, em ordem de
+ * classificação; quem não pressionou não gera registro.
+ */
+void finish_multi_round()
+{
+    multi_capture_disarm(&players);
+    clock_scale_set(clock_phase_idle);
+    led_fx_set(LED_RED, 0);
+    tone_cancel();
+    set_game_state(telemetry_state_result);
+
+    uint8_t order[multi_capture_max_players];
+    size_t ranked = multi_capture_rank(&players, order);
+    uint32_t now_ms = hal_time_ms();
+    for (size_t place = 0; place < ranked; place++)
+    {
+        uint8_t mode = GAME_MODE_MULTI | (order[place] << 4);
+        uint32_t elapsed_us = multi_capture_reaction_us(&players, order[place]);
+        telemetry_push(telemetry_type_round, elapsed_us, mode << 8);
+        log_round(now_ms, elapsed_us, 0, mode);
+    }
+    if (ranked > 0)
+    {
+        uint32_t winner_ms = multi_capture_reaction_us(&players, order[0]) / 1000;
+        trace_event(trace_round, winner_ms > 0xFFFF ? 0xFFFF : winner_ms);
+    }
+    // Na sessão multijogador, o tempo da rodada é o do vencedor
+    session_add(ranked > 0 ? multi_capture_reaction_us(&players, order[0]) : 0);
+
+    char screen[8 * 15 + 1];
+    multi_capture_format(&players, screen, sizeof(screen));
+    display_text(screen);
+}
 
-        // Liga o LED verde com PWM (50% brightness)
-        pwm_set_gpio_level(LED_GREEN, LED_ON);
+/**
+ * @brief Fim da tela de resultado ou de queima (game_action_idle): volta à tela inicial.
+ */
+void round_idle()
+{
+    reaction_phase = false;
+    response_captured = false;
+    clock_scale_set(clock_phase_idle);
+    display_text("PRESSIONE A    PARA COMECAR!");
+    set_game_state(telemetry_state_idle);
+}
 
-        uint delay_ms = 1000 + (rand() % 4000);
-        for (uint i = 0; i < delay_ms / 10; i++)
+/**
+ * @brief Fim da última rodada da sessão (game_action_summary): resumo na tela inicial.
+ *
+ * Melhor tempo, média e mediana (exata, de session_times_us) da sessão, em ms, e as
+ * queimas de largada; o resumo fica na tela até o botão A iniciar a próxima sessão.
+ */
+void round_summary()
+{
+    char line[5][20];
+    char screen[7 * 15 + 1];
+    uint32_t count = session_stats.count;
+
+    reaction_phase = false;
+    response_captured = false;
+    clock_scale_set(clock_phase_idle);
+
+    snprintf(line[0], sizeof(line[0]), "SESSAO %u EM MS", game.session_rounds);
+    if (count)
+    {
+        snprintf(line[1], sizeof(line[1]), "MELHOR %.1f", session_stats.min_us / 1000.0f);
+        snprintf(line[2], sizeof(line[2]), "MEDIA %.1f", reaction_stats_mean_us(&session_stats) / 1000.0f);
+        snprintf(line[3], sizeof(line[3]), "MEDIANA %.1f", session_median_us() / 1000.0f);
+    }
+    else
+    {
+        snprintf(line[1], sizeof(line[1]), "SEM TEMPOS");
+        line[2][0] = line[3][0] = '\0';
+    }
+    snprintf(line[4], sizeof(line[4]), "QUEIMAS %u", session_false_starts);
+    snprintf(screen, sizeof(screen), "%-15.15s%-15.15s%-15.15s%-15.15s%-15.15sPRESSIONE A    PARA COMECAR!", line[0], line[1],
+             line[2], line[3], line[4]);
+    display_text(screen);
+    set_game_state(telemetry_state_idle);
+
+    // Fim da sessão: as rodadas ainda no lote vão para a flash já, sem esperar o lote ocioso
+    result_log_service(hal_time_ms(), true);
+}
+
+/**
+ * @brief Aplica o modo e o número de jogadores à captura e à máquina da rodada.
+ *
+ * Nos modos de escolha, qualquer botão de resposta na preparação queima a largada, e a
+ * reação termina em CHOICE_WINDOW_MS mesmo sem resposta.
+ */
+void game_configure()
+{
+    multi_capture_init(&players, player_buttons, player_count);
+    if (stimuli)
+        game_init(&game, (1u << BUTTON_STOP) | (1u << BUTTON_JOYSTICK), CHOICE_WINDOW_MS);
+    else
+        game_init(&game, players.pin_mask, player_count > 1 ? MULTI_TIMEOUT_MS : 0);
+}
+
+/**
+ * @brief Troca o número de jogadores (fora de uma rodada).
+ *
+ * Com mais de um jogador o modo volta ao simples.
+ *
+ * @param count Jogadores, de 1 (reação simples com o botão B) a multi_capture_max_players.
+ */
+void set_player_count(uint8_t count)
+{
+    char screen[3 * 15 + 1];
+
+    player_count = count;
+    if (count > 1)
+    {
+        game_mode = GAME_MODE_SIMPLE;
+        stimuli = NULL;
+        stimuli_count = 0;
+    }
+    game_configure();
+    snprintf(screen, sizeof(screen), "%u JOGADOR%-6.6sPRESSIONE A    PARA COMECAR!", count, count > 1 ? "ES" : "");
+    display_text(screen);
+}
+
+/**
+ * @brief Troca o modo de jogo (fora de uma rodada); os de escolha são de um jogador.
+ *
+ * @param mode GAME_MODE_SIMPLE, GAME_MODE_CHOICE ou GAME_MODE_GO_NO_GO; os resultados por
+ *             tipo de estímulo recomeçam.
+ */
+void set_game_mode(uint8_t mode)
+{
+    char screen[3 * 15 + 1];
+
+    game_mode = mode;
+    stimuli = mode == GAME_MODE_CHOICE ? choice_stimuli : mode == GAME_MODE_GO_NO_GO ? go_no_go_stimuli : NULL;
+    stimuli_count = mode == GAME_MODE_CHOICE ? count_of(choice_stimuli)
+                    : mode == GAME_MODE_GO_NO_GO ? count_of(go_no_go_stimuli) : 0;
+    stimulus_stats_reset(stimulus_stats, stimulus_max);
+    player_count = 1;
+    game_configure();
+    snprintf(screen, sizeof(screen), "%-15sPRESSIONE A    PARA COMECAR!",
+             mode == GAME_MODE_CHOICE ? "MODO ESCOLHA" : mode == GAME_MODE_GO_NO_GO ? "MODO VAI NAO" : "MODO SIMPLES");
+    display_text(screen);
+}
+
+/**
+ * @brief Troca o número de rodadas por sessão (fora de uma rodada).
+ *
+ * @param rounds Rodadas seguidas a cada pressão do botão A (0: rodadas avulsas).
+ */
+void set_session_rounds(uint8_t rounds)
+{
+    char screen[3 * 15 + 1];
+
+    game_session(&game, rounds, SESSION_ITI_MS);
+    if (rounds)
+        snprintf(screen, sizeof(screen), "SESSAO DE %-5uPRESSIONE A    PARA COMECAR!", rounds);
+    else
+        snprintf(screen, sizeof(screen), "%-15sPRESSIONE A    PARA COMECAR!", "RODADAS AVULSAS");
+    display_text(screen);
+}
+
+// Carga de alarmes do diagnóstico de latência: um IRQ do timer a cada LATENCY_ALARM_US
+int64_t latency_alarm_load(hal_alarm_t alarm, void *data)
+{
+    (void)alarm;
+    (*(volatile uint32_t *)data)++;
+    return -LATENCY_ALARM_US;
+}
+
+/**
+ * @brief Diagnóstico de latência de IRQ ('L' pela USB, fora de uma rodada).
+ *
+ * Mede LATENCY_SAMPLES bordas do gerador em LATENCY_PROBE_PIN (inc/irq_latency.h) sob cada
+ * carga de fundo, em sequência: nenhuma, a fila da telemetria sempre cheia, telas seguidas
+ * no display, um alarme a cada LATENCY_ALARM_US e o núcleo 1 ocupado. Tudo no clock da
+ * janela de reação, o mesmo da captura real. No fim, os histogramas vão pela telemetria
+ * (telemetry_type_latency) e a tela mostra média e máximo de cada carga.
+ *
+ * Uma carga que não junta as amostras em LATENCY_LOAD_TIMEOUT_MS (pino ligado a algo, IRQ
+ * de borda que não chega) encerra o diagnóstico: ela e as seguintes ficam sem amostras
+ * ("0 AMOSTRAS" na tela). O alarme e o núcleo 1 param do mesmo jeito nos dois casos.
+ */
+void latency_diagnostic()
+{
+    char screen[8 * 15 + 1];
+    volatile uint32_t alarm_count = 0;
+    uint32_t filler = 0;
+    bool timed_out = false;
+
+    clock_scale_set(clock_phase_reaction);
+    irq_latency_start(LATENCY_PROBE_PIN);
+    for (uint8_t load = 0; load < irq_load_count; load++)
+    {
+        if (timed_out)
+        {
+            irq_latency_reset(&latency_stats[load]);
+            continue;
+        }
+        snprintf(screen, sizeof(screen), "%-15s%-15s", "LATENCIA IRQ", irq_latency_load_names[load]);
+        display_text(screen);
+
+        hal_alarm_t alarm = 0;
+        if (load == irq_load_alarm)
+        {
+            alarm = hal_alarm_at_us(hal_time_us() + LATENCY_ALARM_US, latency_alarm_load, (void *)&alarm_count);
+        }
+        else if (load == irq_load_core1)
         {
-            sleep_ms(10);
-            if (gpio_get(BUTTON_STOP) == 0)
+            irq_latency_core1_start();
+        }
+
+        irq_latency_measure(&latency_stats[load]);
+        uint32_t deadline_ms = hal_time_ms() + LATENCY_LOAD_TIMEOUT_MS;
+        while (irq_latency_measured() < LATENCY_SAMPLES)
+        {
+            if ((int32_t)(hal_time_ms() - deadline_ms) >= 0)
             {
-                false_start_detected = true;
+                timed_out = true;
                 break;
             }
+            if (load == irq_load_usb)
+            {
+                while (telemetry_free())
+                {
+                    telemetry_push(telemetry_type_latency, (load << 8) | irq_latency_record_filler, filler++);
+                }
+                telemetry_service();
+            }
+            else if (load == irq_load_i2c)
+            {
+                display_text(screen);
+            }
+            else
+            {
+                hal_time_us(); // Espera ocupada, como no laço do jogo
+            }
         }
+        irq_latency_measure(NULL);
+        if (timed_out)
+            irq_latency_reset(&latency_stats[load]);
 
-        if (false_start_detected)
+        hal_alarm_cancel(alarm);
+        if (load == irq_load_core1)
         {
-            display_text("MUITO CEDO!");
-            // Desliga o LED verde
-            pwm_set_gpio_level(LED_GREEN, 0);
-            // Pisca o LED vermelho três vezes (50% brightness)
-            for (int j = 0; j < 3; j++)
-            {
-                pwm_set_gpio_level(LED_RED, LED_ON);
-                sleep_ms(200);
-                pwm_set_gpio_level(LED_RED, 0);
-                sleep_ms(200);
-            }
-            game_running = false;
-            reaction_phase = false;
-            sleep_ms(2000);
-            display_text("PRESSIONE A    PARA COMECAR!");
-            return;
+            irq_latency_core1_stop();
         }
+    }
+    irq_latency_stop();
+    clock_scale_set(clock_phase_idle);
 
-        // Desliga o LED verde e liga o LED vermelho com PWM
-        pwm_set_gpio_level(LED_GREEN, 0);
-        pwm_set_gpio_level(LED_RED, LED_ON);
+    int len = snprintf(screen, sizeof(screen), "%-15s%-15s", "LATENCIA IRQ", irq_latency_header);
+    for (uint8_t load = 0; load < irq_load_count; load++)
+    {
+        irq_latency_report(load, &latency_stats[load]);
+        len += irq_latency_format(&latency_stats[load], irq_latency_load_names[load], screen + len, sizeof(screen) - len);
+    }
+    display_text(screen);
+}
 
-        // Emite um beep curto com o buzzer
-        buzzer_beep(3000, 300);
-        start_timer();
-        reaction_phase = true;
-        display_text("PRESSIONE B    PARA MARCAR!");
+/**
+ * @brief Sai do baixo consumo: PWM e painel de volta, com o tempo até ficar pronto no trace.
+ *
+ * A pressão do botão A que acordou não inicia uma rodada: espera-se que ele seja solto.
+ *
+ * @param wake_us Instante do despertar (hal_time_us).
+ */
+void idle_wake(uint64_t wake_us)
+{
+    // Depois do dormant os clocks são os do boot: a fase atual refaz o clock e os divisores
+    clock_scale_set(clock_scale_phase());
+    clock_scale_service(hal_time_ms());
+    hal_output_enable(LED_GREEN, true);
+    hal_output_enable(LED_RED, true);
+    hal_output_enable(BUZZER, true);
+    ssd1306_send_command(ssd1306_set_display | 0x01); // Painel ligado; a GDDRAM manteve a tela
+    idle_asleep = false;
+
+    uint64_t ready_us = hal_time_us() - wake_us;
+    trace_event(trace_wake, ready_us > 0xFFFF ? 0xFFFF : ready_us);
+
+    while (hal_input_pressed(BUTTON_START))
+    {
+        hal_sleep_ms(10);
     }
+    hal_sleep_ms(50); // Bounce da soltura
+    idle_since_ms = hal_time_ms();
 }
 
 /**
- * @brief Callback de interrupção para o botão de parada (B).
+ * @brief Entra no baixo consumo da espera por um novo jogo.
+ *
+ * Grava os resultados pendentes, silencia o buzzer, apaga os LEDs, para as fatias de PWM
+ * e desliga o painel. Sem host USB, o RP2040 fica em dormant até o botão A (inc/power.h) e
+ * a função só retorna acordada; com host, o laço principal passa a esperar em __wfi, e a
+ * telemetria e os comandos continuam funcionando.
+ */
+void idle_sleep()
+{
+    result_log_service(hal_time_ms(), true);
+    tone_cancel();
+    pcm_stop();
+    led_fx_stop(LED_GREEN);
+    led_fx_stop(LED_RED);
+    hal_output_enable(LED_GREEN, false);
+    hal_output_enable(LED_RED, false);
+    hal_output_enable(BUZZER, false);
+    ssd1306_send_command(ssd1306_set_display); // Painel desligado
+    idle_asleep = true;
+
+    if (!stdio_usb_connected())
+    {
+        idle_wake(power_dormant_until_low(BUTTON_START));
+    }
+}
+
+/**
+ * @brief Callback de interrupção dos botões.
  *
  * Quando o botão B é pressionado, e se o jogo estiver em andamento e na fase de reação,
- * marca o tempo de reação.
+ * marca o tempo de reação (só a primeira borda de descida; as do bounce são ignoradas).
+ * No modo multijogador, qualquer borda amostra o banco inteiro de uma vez: jogadores que
+ * pressionaram antes dessa leitura empatam, independente da ordem de despacho dos IRQs.
+ * Todas as bordas dos dois botões vão para a telemetria, o que permite capturar sessões
+ * reais e reproduzi-las na simulação no host. As bordas do gerador do diagnóstico de
+ * latência só alimentam o histograma, antes de qualquer outra coisa.
  *
  * @param gpio Pino que gerou a interrupção.
  * @param events Máscara dos eventos que ocorreram.
  */
-void gpio_callback(uint gpio, uint32_t events)
+void capture_func(gpio_callback)(uint gpio, uint32_t events)
 {
-    if (gpio == BUTTON_STOP && game_running && reaction_phase)
+    if (gpio == LATENCY_PROBE_PIN)
     {
-        reaction_time = get_absolute_time();
-        button_b_pressed = true;
+        irq_latency_sample();
+        return;
     }
+
+    uint64_t now = hal_time_us();
+    trace_event(trace_gpio_irq, gpio | (events << 8));
+
+    if (players.armed)
+    {
+        // A borda deste pino conta mesmo que o nível já tenha voltado (pulso mais curto que a latência)
+        uint32_t pressed = hal_input_bank();
+        if (events & hal_edge_fall)
+            pressed |= 1u << gpio;
+        multi_capture_sample(&players, pressed, now);
+    }
+    else if ((gpio == BUTTON_STOP || (stimuli && gpio == BUTTON_JOYSTICK)) && (events & hal_edge_fall) &&
+             reaction_phase && player_count == 1 && !response_captured)
+    {
+        reaction_time = now;
+        response_pin = gpio;
+        response_captured = true;
+    }
+
+    // Só depois da captura: a telemetria apenas copia o evento para a fila. Com bounce as
+    // duas bordas podem chegar no mesmo IRQ; o nível atual diz qual veio por último
+    uint32_t level = (events & hal_edge_rise) ? 1 : 0;
+    if ((events & hal_edge_rise) && (events & hal_edge_fall))
+    {
+        level = !hal_input_pressed(gpio);
+        telemetry_push_at(now, telemetry_type_input, gpio, !level);
+    }
+    telemetry_push_at(now, telemetry_type_input, gpio, level);
+}
+
+// Antecipa wake_us para um prazo em ms do laço (hal_time_ms); prazo vencido acorda agora
+static uint64_t loop_deadline_ms(uint64_t wake_us, uint64_t now_us, uint32_t due_ms)
+{
+    int32_t remaining_ms = (int32_t)(due_ms - (uint32_t)(now_us / 1000));
+    uint64_t due_us = remaining_ms > 0 ? now_us + (uint64_t)remaining_ms * 1000 : now_us;
+    return due_us < wake_us ? due_us : wake_us;
+}
+
+/**
+ * @brief Espera até o próximo prazo do laço principal ou até uma interrupção.
+ *
+ * Botões, alarmes (o estímulo), USB, DMA e PWM acordam o núcleo pelos seus IRQs; o resto do
+ * que o laço faz tem prazo: a fase da rodada, as trocas de clock (antes do estímulo e depois
+ * dos envios ao display), o próximo quadro da animação, a nova procura do painel, a gravação
+ * do lote incompleto, o baixo consumo e a releitura do botão A pressionado dentro do
+ * debounce. Com trabalho já pendente
+ * (boot do display, trace ou telemetria com espaço no CDC, comando na USB) não espera.
+ *
+ * @param command Comando lido da USB nesta volta (< 0: nenhum).
+ */
+void loop_wait(int command)
+{
+    if (display_boot_step != DISPLAY_BOOT_DONE || trace_dumping() || command >= 0 ||
+        (telemetry_pending() && telemetry_writable()))
+        return;
+
+    uint64_t now_us = hal_time_us();
+    uint64_t wake_us = now_us + (uint64_t)LOOP_WAIT_MAX_MS * 1000;
+
+    // FIFO do CDC cheia: o host a esvazia a cada quadro USB
+    if (telemetry_pending() && now_us + LOOP_USB_FRAME_US < wake_us)
+        wake_us = now_us + LOOP_USB_FRAME_US;
+
+    if (game.phase_end_us && game.phase_end_us < wake_us)
+        wake_us = game.phase_end_us;
+    if (game.state == telemetry_state_foreperiod && clock_scale_phase() != clock_phase_reaction &&
+        game.phase_end_us - STIMULUS_CLOCK_LEAD_US < wake_us)
+        wake_us = game.phase_end_us > STIMULUS_CLOCK_LEAD_US ? game.phase_end_us - STIMULUS_CLOCK_LEAD_US : now_us;
+    if (game.state == telemetry_state_foreperiod && stimulus_from_loop() &&
+        game.phase_end_us - STIMULUS_SCREEN_LEAD_US < wake_us)
+        wake_us = game.phase_end_us > STIMULUS_SCREEN_LEAD_US ? game.phase_end_us - STIMULUS_SCREEN_LEAD_US : now_us;
+
+    if (anim_playing(&anim))
+        wake_us = loop_deadline_ms(wake_us, now_us, anim.next_ms);
+    if (!game_timing(&game) && !ssd1306_online())
+        wake_us = loop_deadline_ms(wake_us, now_us, ssd1306_retry_at_ms());
+    if (!game_timing(&game) && result_log_pending())
+        wake_us = loop_deadline_ms(wake_us, now_us, result_log_idle_flush_at_ms());
+    if (clock_scale_render_held())
+        wake_us = loop_deadline_ms(wake_us, now_us, clock_scale_render_until_ms());
+    if (game_idle(&game) && IDLE_TIMEOUT_MS > 0)
+        wake_us = loop_deadline_ms(wake_us, now_us, idle_since_ms + IDLE_TIMEOUT_MS);
+    if (hal_input_pressed(BUTTON_START))
+        wake_us = loop_deadline_ms(wake_us, now_us, debounce_last_ms + DEBOUNCE_MS);
+
+    if (wake_us > now_us)
+        hal_wait_until(wake_us);
 }
 
 /**
  * @brief Função principal.
  *
- * Inicializa o hardware (I2C, display OLED, botões, LEDs e PWM para buzzer e LEDs),
- * e entra em loop infinito monitorando os botões para iniciar e controlar o jogo.
+ * Inicializa o hardware (botões, LEDs e PWM para buzzer e LEDs, depois USB e I2C) e entra
+ * em loop infinito que lê as entradas e executa as ações da máquina da rodada (inc/game.h),
+ * sem esperas bloqueantes; o display OLED é inicializado pelo próprio laço, e os tempos de
+ * cada fase vão para o trace (inc/boot.h).
  *
  * Os LEDs agora são acionados via PWM, garantindo que mesmo quando "ligados" o brilho seja
  * limitado a 50% do máximo.
@@ -299,77 +1188,223 @@ void gpio_callback(uint gpio, uint32_t events)
  */
 int main()
 {
-    // Inicializa as interfaces padrão (UART, USB, etc.)
-    stdio_init_all();
+    boot_mark(boot_phase_main);
 
-    // Inicializa a interface I2C para o display OLED
-    i2c_init(i2c1, ssd1306_i2c_clock * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+    // Semeia o gerador com o ROSC: cada boot sorteia uma sequência diferente de atrasos
+    random_init();
+    next_foreperiod_ms = foreperiod_sample_ms(&foreperiod);
 
-    // Inicializa o display OLED e exibe mensagem inicial
-    ssd1306_init();
-    display_text("PRESSIONE A    PARA COMECAR!");
+    reaction_stats_init(&player_stats);
+
+    // Boot rápido: botões, LEDs e buzzer antes de USB, flash e display (inc/boot.h)
 
     // Configura os botões como entradas com pull-up interno
-    gpio_init(BUTTON_START);
-    gpio_init(BUTTON_STOP);
-    gpio_set_dir(BUTTON_START, GPIO_IN);
-    gpio_set_dir(BUTTON_STOP, GPIO_IN);
-    gpio_pull_up(BUTTON_START);
-    gpio_pull_up(BUTTON_STOP);
-
-    // Inicializa os LEDs para PWM
-    pwm_init_led(LED_GREEN);
-    pwm_init_led(LED_RED);
-    // Inicialmente, ambos os LEDs estão desligados
-    pwm_set_gpio_level(LED_GREEN, 0);
-    pwm_set_gpio_level(LED_RED, 0);
-
-    // Inicializa o buzzer com PWM
-    pwm_init_buzzer(BUZZER);
-
-    // Configura a interrupção para o botão B (BUTTON_STOP)
-    gpio_set_irq_enabled_with_callback(BUTTON_STOP, GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
+    hal_input_init(BUTTON_START);
+    hal_input_init(BUTTON_STOP);
+
+    // Botões dos demais jogadores (J1 é o próprio botão B)
+    for (uint i = 1; i < multi_capture_max_players; i++)
+    {
+        hal_input_init(player_buttons[i]);
+    }
+    game_configure();
+    game_session(&game, SESSION_ROUNDS_DEFAULT, SESSION_ITI_MS);
+
+    // Inicializa os LEDs para PWM (ambos apagados), com efeitos pelo IRQ de wrap
+    led_fx_init(LED_GREEN);
+    led_fx_init(LED_RED);
+
+    // Inicializa o buzzer com PWM (divisor e wrap são escolhidos a cada nota)
+    tone_init(BUZZER);
+    pcm_init(BUZZER);
+
+    // Inicializa a interface I2C para o display OLED (o painel em si vem depois, no laço)
+    ssd1306_bus_init(I2C_SDA, I2C_SCL, ssd1306_i2c_clock * 1000);
+    clock_scale_init(hal_display_i2c, ssd1306_i2c_clock * 1000);
+
+    // Daqui em diante o clk_sys segue a fase do jogo (inc/clock_scale.h)
+    clock_scale_set(clock_phase_idle);
+
+    // Configura a interrupção dos botões: B (ou, no multijogador, qualquer jogador) marca a
+    // reação; as duas bordas de todos os botões vão para a telemetria
+    hal_input_events(BUTTON_STOP, gpio_callback);
+    hal_input_events(BUTTON_START, gpio_callback);
+    for (uint i = 1; i < multi_capture_max_players; i++)
+    {
+        hal_input_events(player_buttons[i], gpio_callback);
+    }
+    boot_mark(boot_phase_inputs);
+
+    // Inicializa as interfaces padrão (UART, USB, etc.); a enumeração segue pelo IRQ da USB,
+    // sem esperar pelo host
+    stdio_init_all();
+
+    // Retoma o registro de resultados a partir da flash
+    result_log_init();
 
     // Loop principal do jogo
     while (true)
     {
-        // Verifica se o botão A foi pressionado com debounce
-        if (debounce_button(BUTTON_START))
+        // Display inicializado aos poucos, sem atrasar a primeira leitura dos botões
+        display_boot_service();
+
+        // Fora da preparação e da reação (tela inicial, resultado, queima e o intervalo da
+        // sessão), grava na flash o lote cheio ou ocioso; o XIP fica suspenso durante a
+        // gravação, então isso nunca acontece na janela de reação
+        if (!game_timing(&game))
         {
-            if (!game_running)
+            result_log_service(hal_time_ms(), false);
+        }
+
+        // Painel fora de linha (sem ACK ou barramento preso): novas tentativas em segundo
+        // plano, fora da preparação e da reação; quando ele volta, a tela atual é refeita
+        if (!game_timing(&game) && ssd1306_bus_service(hal_time_ms()))
+        {
+            anim_stop(&anim);
+            display_text(display_last);
+        }
+
+        // Próximo quadro da animação; no fim (ou com o painel fora de linha) a tela guardada
+        // por display_text volta
+        if (anim_playing(&anim) && (!ssd1306_online() || !anim_service(&anim, hal_time_ms())))
+        {
+            anim_stop(&anim);
+            display_text(display_last);
+        }
+
+        // Comandos pela USB: 'T' envia o trace em RAM (inc/trace.h) pela telemetria; 'P' e
+        // um dígito trocam o número de jogadores, 'M' e um dígito o modo (0 simples, 2 escolha,
+        // 3 vai/não vai) e 'S' e até dois dígitos o número de rodadas por sessão, e 'L' roda o
+        // diagnóstico de latência de IRQ, fora de uma rodada
+        int command = getchar_timeout_us(0);
+        if (command == 'T')
+        {
+            trace_request_dump();
+        }
+        else if (command == 'P' && game_idle(&game))
+        {
+            int digit = getchar_timeout_us(1000);
+            if (digit >= '1' && digit < '1' + multi_capture_max_players)
+            {
+                set_player_count(digit - '0');
+            }
+        }
+        else if (command == 'M' && game_idle(&game))
+        {
+            int digit = getchar_timeout_us(1000);
+            if (digit == '0' + GAME_MODE_SIMPLE || digit == '0' + GAME_MODE_CHOICE || digit == '0' + GAME_MODE_GO_NO_GO)
+            {
+                set_game_mode(digit - '0');
+            }
+        }
+        else if (command == 'S' && game_idle(&game))
+        {
+            int rounds = 0;
+            for (int i = 0; i < 2; i++)
             {
-                start_game();
+                int digit = getchar_timeout_us(1000);
+                if (digit < '0' || digit > '9')
+                    break;
+                rounds = rounds * 10 + digit - '0';
             }
-            sleep_ms(300);
+            set_session_rounds(rounds);
+        }
+        else if (command == 'L' && game_idle(&game))
+        {
+            latency_diagnostic();
         }
+        trace_service();
 
-        // Se o jogo estiver em execução e o botão B foi pressionado
-        if (game_running && reaction_phase && button_b_pressed)
+        // A cada conexão de um host, os tempos do boot e os contadores do barramento do display
+        // voltam para a telemetria (sem host, ela descarta o que é produzido)
+        bool usb_connected = stdio_usb_connected();
+        if (usb_connected && !usb_host_present)
         {
-            uint32_t elapsed_time = get_elapsed_time();
-            // Desliga o LED vermelho via PWM
-            pwm_set_gpio_level(LED_RED, 0);
+            boot_report();
+            boot_mark(boot_phase_usb);
+            ssd1306_bus_report();
+        }
+        usb_host_present = usb_connected;
 
-            stop_buzzer(0, NULL);
+        // Envia a telemetria pendente pela USB, em porções que não bloqueiam
+        telemetry_service();
 
-            char buffer[20];
-            sprintf(buffer, "Tempo: %.1f ms", (float)elapsed_time);
-            display_text(buffer);
+        // Sem atividade por IDLE_TIMEOUT_MS, a espera passa a baixo consumo. No sono com
+        // host USB o laço só roda a cada interrupção, e o botão A apenas acorda
+        if (!game_idle(&game) || command >= 0)
+        {
+            idle_since_ms = hal_time_ms();
+        }
+        if (idle_asleep)
+        {
+            if (hal_input_pressed(BUTTON_START))
+            {
+                idle_wake(hal_time_us());
+            }
+            else
+            {
+                __wfi();
+            }
+            continue;
+        }
+        if (IDLE_TIMEOUT_MS > 0 && hal_time_ms() - idle_since_ms >= IDLE_TIMEOUT_MS)
+        {
+            idle_sleep();
+            continue;
+        }
 
-            sleep_ms(5000);
+        // A tela invertida sai antes da leitura das entradas: uma pressão depois dela já é reação
+        stimulus_clock_service();
+        stimulus_screen_service();
 
-            // Reseta o estado do jogo
-            game_running = false;
-            reaction_phase = false;
-            false_start_detected = false;
-            button_b_pressed = false;
+        // Uma volta da rodada (inc/game.h): o botão A com debounce, o banco de entradas
+        // (queima de largada de qualquer jogador) e a captura feita pelo callback
+        game_input_t input = {
+            .start = debounce_button(BUTTON_START),
+            .pressed = hal_input_bank(),
+            .captured = player_count > 1 ? multi_capture_complete(&players) : response_captured,
+            .foreperiod_ms = next_foreperiod_ms,
+            .onset_us = stimulus_onset_us,
+        };
+        if (input.start)
+        {
+            idle_since_ms = hal_time_ms();
+        }
 
-            display_text("PRESSIONE A    PARA COMECAR!");
+        switch (game_step(&game, &input, hal_time_us()))
+        {
+        case game_action_prepare:
+            round_prepare();
+            break;
+        case game_action_false_start:
+            round_false_start(game.early);
+            break;
+        case game_action_stimulus:
+            round_stimulus();
+            break;
+        case game_action_result:
+            reaction_phase = false;
+            if (stimuli)
+                finish_choice_round();
+            else if (player_count > 1)
+                finish_multi_round();
+            else
+                finish_single_round();
+            break;
+        case game_action_idle:
+            round_idle();
+            break;
+        case game_action_summary:
+            round_summary();
+            break;
+        default:
+            break;
         }
+
+        // Descida de clock pendente (fim da fase ou da rajada de telas), e então nada a fazer
+        // até o próximo prazo ou interrupção: o núcleo espera em vez de girar
+        clock_scale_service(hal_time_ms());
+        loop_wait(command);
     }
 
     return 0;
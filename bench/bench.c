@@ -0,0 +1,332 @@
+// Microbenchmarks dos caminhos quentes de renderização, do driver do display e dos formatadores.
+//
+// Cada caso é calibrado até um lote durar ~20 ms e medido em 5 lotes; a saída é CSV
+// (uma linha por caso) com o melhor lote e a mediana, por operação:
+//
+//   bench,platform,unit,iterations,best,median
+//
+// No host a unidade é ns (CLOCK_MONOTONIC; o I2C é o modelo da simulação, então
+// display_text mede só o custo de CPU). No RP2040 é ciclos de clk_sys, medidos com o
+// SysTick (24 bits, lotes bem abaixo do estouro), e o CSV sai pela USB a cada tecla
+// recebida. Comparar o CSV de duas versões da firmware mostra regressões.
+//
+// Os casos cpp_* repetem os do driver do display com o driver em C++ (inc/ssd1306.hpp,
+// bench_driver.cpp); o tamanho do código dos dois sai do alvo bench_code_size.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "inc/hal.h"
+#include "inc/ssd1306.h"
+#include "inc/reaction_stats.h"
+#include "inc/telemetry.h"
+#include "inc/tone.h"
+#include "inc/pcm.h"
+#include "inc/game.h"
+#include "inc/anim.h"
+#include "inc/anim_best.h"
+
+#if LIGEIRINHO_HOST_SIM
+#include <time.h>
+#define bench_platform "host"
+#define bench_unit "ns"
+#else
+#include "pico/stdio_usb.h"
+#include "hardware/structs/systick.h"
+#define bench_platform "rp2040"
+#define bench_unit "cycles"
+#endif
+
+#define bench_repeats 5
+#define bench_batch_us 20000
+
+// Funções de Ligeirinho.c (compilado com main renomeada)
+void display_text(const char *text);
+
+// Casos do driver em C++ (bench_driver.cpp)
+void bench_cpp_draw_string(void);
+void bench_cpp_draw_char(void);
+void bench_cpp_draw_line(void);
+void bench_cpp_set_pixel(void);
+void bench_cpp_clear(void);
+void bench_cpp_flush(void);
+
+static uint8_t framebuffer[ssd1306_buffer_length];
+static reaction_stats_t stats;
+static uint8_t frame[telemetry_max_frame];
+static char text[128];
+static volatile uint32_t sink;
+static tone_divider_t divider;
+static uint8_t adpcm[pcm_chunk_samples / 2];
+static const pcm_clip_t adpcm_clip = {
+    .format = pcm_format_ima_adpcm, .sample_rate = 8000, .samples = pcm_chunk_samples, .data = adpcm};
+static pcm_decoder_t decoder;
+static uint16_t levels[pcm_chunk_samples];
+static game_t game;
+
+// Impede que o compilador elimine ou junte iterações que só escrevem na memória
+static inline void bench_clobber(void)
+{
+    __asm volatile("" ::: "memory");
+}
+
+// ---------------------------------------------------------------------------------------
+// Relógio do benchmark
+
+#if LIGEIRINHO_HOST_SIM
+
+static void bench_clock_init(void)
+{
+}
+
+static uint64_t bench_ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_ticks_per_us(void)
+{
+    return 1000;
+}
+
+#else
+
+static void bench_clock_init(void)
+{
+    // Contador decrescente de 24 bits no clock do processador
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;
+}
+
+// Diferenças são tomadas módulo 2^24; lotes ficam muito abaixo de 134 ms a 125 MHz
+static uint64_t bench_ticks(void)
+{
+    return 0x00FFFFFF - systick_hw->cvr;
+}
+
+static uint64_t bench_ticks_per_us(void)
+{
+    return clock_get_hz(clk_sys) / 1000000;
+}
+
+#endif
+
+static uint64_t bench_elapsed(uint64_t start, uint64_t end)
+{
+#if LIGEIRINHO_HOST_SIM
+    return end - start;
+#else
+    return (end - start) & 0x00FFFFFF;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------
+// Casos
+
+static void case_display_text(void)
+{
+    display_text("PRESSIONE B    PARA MARCAR!");
+}
+
+static void case_draw_string(void)
+{
+    ssd1306_draw_string(framebuffer, 2, 8, "PRESSIONE A    ");
+}
+
+static void case_draw_char(void)
+{
+    ssd1306_draw_char(framebuffer, 64, 32, 'M');
+}
+
+static void case_draw_line(void)
+{
+    ssd1306_draw_line(framebuffer, 0, 0, ssd1306_width - 1, ssd1306_height - 1, true);
+}
+
+static void case_set_pixel(void)
+{
+    ssd1306_set_pixel(framebuffer, 77, 21, true);
+}
+
+// Quadro inteiro pelo barramento da firmware (no host, só o custo de CPU)
+static void case_render(void)
+{
+    struct render_area area = {.start_column = 0, .end_column = ssd1306_width - 1, .start_page = 0,
+                               .end_page = ssd1306_n_pages - 1, .buffer_length = ssd1306_buffer_length};
+    render_on_display(framebuffer, &area);
+}
+
+static void case_clear(void)
+{
+    memset(framebuffer, 0, sizeof(framebuffer));
+}
+
+static void case_stats_format(void)
+{
+    sink = reaction_stats_format(&stats, text, sizeof(text));
+}
+
+static void case_header_format(void)
+{
+    sink = snprintf(text, sizeof(text), "Tempo: %.1f ms", 251.0f);
+}
+
+static void case_telemetry_encode(void)
+{
+    sink = telemetry_encode(telemetry_type_round, 123456789, 251234, 0, frame);
+}
+
+static void case_tone_divider(void)
+{
+    sink = tone_divider(125000000, 2093, &divider);
+}
+
+// Um bloco inteiro, como no IRQ de fim de bloco do DMA
+static void case_pcm_decode_chunk(void)
+{
+    pcm_decoder_init(&decoder, &adpcm_clip, 255);
+    sink = pcm_decode(&decoder, levels, pcm_chunk_samples);
+}
+
+// O clipe de recorde inteiro (todos os quadros) aplicado ao quadro, sem envio
+static void case_anim_apply_clip(void)
+{
+    anim_span_t spans[ssd1306_n_pages];
+    size_t offset = 0;
+    for (int i = 0; i < anim_best.frames; i++)
+        offset += anim_apply(framebuffer, anim_best.data + offset, anim_best.length - offset, spans);
+    sink = offset;
+}
+
+// Uma rodada inteira de dois jogadores, com um passo ocioso entre as transições
+static void case_game_round(void)
+{
+    game_input_t input = {.foreperiod_ms = 2000};
+    uint32_t actions = 0;
+
+    game_init(&game, (1u << 5) | (1u << 6), 1000);
+    input.start = true;
+    actions += game_step(&game, &input, 0);
+    input.start = false;
+    actions += game_step(&game, &input, 1000000);
+    input.onset_us = 2000000;
+    actions += game_step(&game, &input, 2000010);
+    input.captured = true;
+    actions += game_step(&game, &input, 2250000);
+    actions += game_step(&game, &input, 7250000);
+    sink = actions;
+}
+
+static const struct
+{
+    const char *name;
+    void (*run)(void);
+} cases[] = {
+    {"display_text", case_display_text},
+    {"ssd1306_draw_string", case_draw_string},
+    {"ssd1306_draw_char", case_draw_char},
+    {"ssd1306_draw_line", case_draw_line},
+    {"ssd1306_set_pixel", case_set_pixel},
+    {"framebuffer_clear", case_clear},
+    {"render_on_display", case_render},
+    {"cpp_draw_string", bench_cpp_draw_string},
+    {"cpp_draw_char", bench_cpp_draw_char},
+    {"cpp_draw_line", bench_cpp_draw_line},
+    {"cpp_set_pixel", bench_cpp_set_pixel},
+    {"cpp_framebuffer_clear", bench_cpp_clear},
+    {"cpp_flush", bench_cpp_flush},
+    {"reaction_stats_format", case_stats_format},
+    {"header_format", case_header_format},
+    {"telemetry_encode", case_telemetry_encode},
+    {"tone_divider", case_tone_divider},
+    {"pcm_decode_chunk", case_pcm_decode_chunk},
+    {"anim_apply_clip", case_anim_apply_clip},
+    {"game_round", case_game_round},
+};
+
+// ---------------------------------------------------------------------------------------
+// Execução
+
+static uint64_t run_batch(void (*run)(void), uint32_t iterations)
+{
+    uint64_t start = bench_ticks();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        run();
+        bench_clobber();
+    }
+    return bench_elapsed(start, bench_ticks());
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void run_case(const char *name, void (*run)(void))
+{
+    // Dobra o lote até a duração alvo (também serve de aquecimento)
+    uint64_t target = bench_batch_us * bench_ticks_per_us();
+    uint32_t iterations = 1;
+    while (iterations < (1u << 30) && run_batch(run, iterations) < target)
+        iterations *= 2;
+
+    uint64_t batches[bench_repeats];
+    for (int r = 0; r < bench_repeats; r++)
+        batches[r] = run_batch(run, iterations);
+    qsort(batches, bench_repeats, sizeof(batches[0]), compare_u64);
+
+    printf("%s,%s,%s,%lu,%.2f,%.2f\n", name, bench_platform, bench_unit, (unsigned long)iterations,
+           (double)batches[0] / iterations, (double)batches[bench_repeats / 2] / iterations);
+}
+
+static void run_all(void)
+{
+    printf("bench,platform,unit,iterations,best,median\n");
+    for (size_t i = 0; i < count_of(cases); i++)
+        run_case(cases[i].name, cases[i].run);
+    fflush(stdout);
+}
+
+int main()
+{
+    stdio_init_all();
+    bench_clock_init();
+
+    // Mesmo display e barramento da firmware, para display_text passar pelo caminho real
+    ssd1306_bus_init(14, 15, ssd1306_i2c_clock * 1000);
+    ssd1306_init();
+
+    // Estatísticas com uma sessão típica, para o formatador percorrer todos os campos
+    reaction_stats_init(&stats);
+    srand(1);
+    for (int i = 0; i < 200; i++)
+        reaction_stats_add(&stats, 180000 + rand() % 240000);
+
+    // Nibbles variados, para o decodificador percorrer a tabela de passos
+    for (size_t i = 0; i < sizeof(adpcm); i++)
+        adpcm[i] = (uint8_t)rand();
+
+#if LIGEIRINHO_HOST_SIM
+    run_all();
+#else
+    while (true)
+    {
+        while (!stdio_usb_connected())
+            sleep_ms(100);
+        run_all();
+
+        // Nova rodada a cada tecla recebida pela serial
+        while (getchar_timeout_us(1000000) == PICO_ERROR_TIMEOUT)
+            tight_loop_contents();
+    }
+#endif
+    return 0;
+}
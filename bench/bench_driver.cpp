@@ -0,0 +1,54 @@
+// Casos do driver do display em C++ (inc/ssd1306.hpp), lado a lado com os do driver em C em
+// bench.c; a conferência de que os dois desenham o mesmo quadro está em tests/test_ssd1306_cpp.cpp.
+
+#include "inc/ssd1306.hpp"
+
+namespace
+{
+
+using Display64 = ligeirinho::Ssd1306<128, 64>;
+
+static_assert(Display64::kBufferLength == ssd1306_buffer_length, "mesmo quadro do driver em C");
+
+Display64 display;
+
+} // namespace
+
+// Todas as funções do modelo no binário, inclusive as que os casos inlinam: é o tamanho que
+// tools/code_size.cmake compara com o do driver em C
+template class ligeirinho::Ssd1306<128, 64>;
+
+extern "C"
+{
+
+void bench_cpp_draw_string(void)
+{
+    display.draw_string(2, 8, "PRESSIONE A    ");
+}
+
+void bench_cpp_draw_char(void)
+{
+    display.draw_char(64, 32, 'M');
+}
+
+void bench_cpp_draw_line(void)
+{
+    display.draw_line(0, 0, Display64::kWidth - 1, Display64::kHeight - 1, true);
+}
+
+void bench_cpp_set_pixel(void)
+{
+    display.set_pixel(77, 21, true);
+}
+
+void bench_cpp_clear(void)
+{
+    display.clear();
+}
+
+void bench_cpp_flush(void)
+{
+    display.flush();
+}
+
+} // extern "C"
@@ -0,0 +1,37 @@
+// Substituto de hardware/clocks.h: frequências dos clocks simulados, trocadas por
+// clock_configure e clock_stop (antes do dormant) e restauradas por runtime_init_clocks
+#ifndef _HARDWARE_CLOCKS_H
+#define _HARDWARE_CLOCKS_H
+
+#include "pico.h"
+
+enum clock_index
+{
+    clk_gpout0 = 0,
+    clk_gpout1,
+    clk_gpout2,
+    clk_gpout3,
+    clk_ref,
+    clk_sys,
+    clk_peri,
+    clk_usb,
+    clk_adc,
+    clk_rtc,
+    CLK_COUNT
+};
+
+#define XOSC_HZ _u(12000000)
+
+// Fontes usadas para rodar do cristal (hardware/regs/clocks.h)
+#define CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC _u(0x2)
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF _u(0x0)
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS _u(0x0)
+
+uint32_t clock_get_hz(enum clock_index clk_index);
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+void clock_stop(enum clock_index clk_index);
+
+// Reprograma o PLL do sistema; clk_peri acompanha clk_sys, como na SDK
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+
+#endif
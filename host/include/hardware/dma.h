@@ -0,0 +1,105 @@
+// Substituto de hardware/dma.h: canais com transferências por bloco, ritmo dos DMA timers
+// e encadeamento. Cada bloco acontece inteiro no instante em que terminaria no hardware
+// (as escritas intermediárias num registrador fixo não são observáveis na simulação).
+#ifndef _HARDWARE_DMA_H
+#define _HARDWARE_DMA_H
+
+#include "pico.h"
+
+#define NUM_DMA_CHANNELS 12
+#define NUM_DMA_TIMERS 4
+
+// Mesmo leiaute do registrador CTRL do RP2040
+#define DMA_CH0_CTRL_TRIG_EN_BITS 0x00000001u
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB 2
+#define DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS 0x0000000cu
+#define DMA_CH0_CTRL_TRIG_INCR_READ_BITS 0x00000010u
+#define DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS 0x00000020u
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB 11
+#define DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS 0x00007800u
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB 15
+#define DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS 0x001f8000u
+
+#define DREQ_DMA_TIMER0 0x3b
+#define DREQ_FORCE 0x3f
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+typedef struct
+{
+    uint32_t ctrl;
+} dma_channel_config;
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_READ_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_READ_BITS);
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->ctrl = incr ? (c->ctrl | DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS);
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) | (dreq << DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB);
+}
+
+static inline void channel_config_set_chain_to(dma_channel_config *c, uint chain_to)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) | (chain_to << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB);
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->ctrl = (c->ctrl & ~DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) | ((uint)size << DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+}
+
+static inline void channel_config_set_enable(dma_channel_config *c, bool enable)
+{
+    c->ctrl = enable ? (c->ctrl | DMA_CH0_CTRL_TRIG_EN_BITS) : (c->ctrl & ~DMA_CH0_CTRL_TRIG_EN_BITS);
+}
+
+// Padrão da SDK: 32 bits, leitura incrementa, escrita fixa, sem DREQ, encadeado a si mesmo
+static inline dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {0};
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, DREQ_FORCE);
+    channel_config_set_chain_to(&c, channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_enable(&c, true);
+    return c;
+}
+
+static inline uint dma_get_timer_dreq(uint timer_num)
+{
+    return DREQ_DMA_TIMER0 + timer_num;
+}
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+int dma_claim_unused_timer(bool required);
+void dma_timer_unclaim(uint timer);
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger);
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+
+#endif
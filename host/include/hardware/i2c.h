@@ -0,0 +1,24 @@
+// Substituto de hardware/i2c.h: as escritas vão para o modelo de SSD1306 da simulação
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+extern i2c_inst_t *const sim_i2c0;
+extern i2c_inst_t *const sim_i2c1;
+
+#define i2c0 sim_i2c0
+#define i2c1 sim_i2c1
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                        uint timeout_us);
+
+#endif
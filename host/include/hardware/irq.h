@@ -0,0 +1,17 @@
+// Substituto de hardware/irq.h: IRQs de wrap do PWM e de DMA, despachados como os demais
+// callbacks
+#ifndef _HARDWARE_IRQ_H
+#define _HARDWARE_IRQ_H
+
+#include "pico.h"
+
+#define PWM_IRQ_WRAP 4
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif
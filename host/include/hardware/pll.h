@@ -0,0 +1,15 @@
+// Substituto de hardware/pll.h: só o desligamento, antes do dormant
+#ifndef _HARDWARE_PLL_H
+#define _HARDWARE_PLL_H
+
+#include "pico.h"
+
+typedef struct sim_pll *PLL;
+
+extern PLL const sim_pll_sys, sim_pll_usb;
+#define pll_sys sim_pll_sys
+#define pll_usb sim_pll_usb
+
+void pll_deinit(PLL pll);
+
+#endif
@@ -0,0 +1,86 @@
+// Substituto de hardware/pwm.h: fatias de PWM com wrap, divisor e níveis observáveis
+#ifndef _HARDWARE_PWM_H
+#define _HARDWARE_PWM_H
+
+#include "pico.h"
+
+#define NUM_PWM_SLICES 8
+
+// Registradores das fatias (hardware/structs/pwm.h), para DMA: escritas em cc feitas por
+// um canal de DMA simulado chegam ao PWM como pwm_set_chan_level
+typedef struct
+{
+    volatile uint32_t csr;
+    volatile uint32_t div;
+    volatile uint32_t ctr;
+    volatile uint32_t cc;
+    volatile uint32_t top;
+} pwm_slice_hw_t;
+
+typedef struct
+{
+    pwm_slice_hw_t slice[NUM_PWM_SLICES];
+} pwm_hw_t;
+
+extern pwm_hw_t sim_pwm_hw;
+#define pwm_hw (&sim_pwm_hw)
+
+typedef struct
+{
+    uint32_t csr;
+    uint32_t div; // Divisor em ponto fixo 8.4
+    uint32_t top;
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint gpio)
+{
+    return (gpio >> 1u) & 7u;
+}
+
+static inline uint pwm_gpio_to_channel(uint gpio)
+{
+    return gpio & 1u;
+}
+
+static inline pwm_config pwm_get_default_config(void)
+{
+    pwm_config c = {.csr = 0, .div = 1u << 4, .top = 0xFFFF};
+    return c;
+}
+
+static inline void pwm_config_set_clkdiv(pwm_config *c, float div)
+{
+    c->div = (uint32_t)(div * (float)(1u << 4));
+}
+
+static inline void pwm_config_set_clkdiv_int_frac(pwm_config *c, uint8_t integer, uint8_t fract)
+{
+    c->div = ((uint32_t)integer << 4) | fract;
+}
+
+static inline void pwm_config_set_clkdiv_int(pwm_config *c, uint div)
+{
+    c->div = div << 4;
+}
+
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap)
+{
+    c->top = wrap;
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract);
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice_num, bool enabled);
+void pwm_set_irq_enabled(uint slice_num, bool enabled);
+void pwm_clear_irq(uint slice_num);
+uint32_t pwm_get_irq_status_mask(void);
+
+// Contador da fatia no instante atual; dentro do callback de GPIO, no instante de entrada do
+// modelo de latência de IRQ (sim.c)
+uint16_t pwm_get_counter(uint slice_num);
+
+#endif
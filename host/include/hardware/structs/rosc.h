@@ -0,0 +1,16 @@
+// Substituto de hardware/structs/rosc.h: só o bit aleatório do oscilador em anel
+#ifndef _HARDWARE_STRUCTS_ROSC_H
+#define _HARDWARE_STRUCTS_ROSC_H
+
+#include "pico.h"
+
+typedef struct
+{
+    uint32_t randombit;
+} rosc_hw_t;
+
+// Cada acesso a rosc_hw traz um bit novo, derivado da semente da simulação (--seed)
+rosc_hw_t *sim_rosc_hw(void);
+#define rosc_hw (sim_rosc_hw())
+
+#endif
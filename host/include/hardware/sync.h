@@ -0,0 +1,17 @@
+// Substituto de hardware/sync.h: mascarar interrupções adia os callbacks simulados
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include "pico.h"
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+// Aguarda o próximo evento simulado (alarme ou borda de entrada)
+void __wfi(void);
+
+static inline void __dmb(void)
+{
+}
+
+#endif
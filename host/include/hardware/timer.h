@@ -0,0 +1,11 @@
+// Substituto de hardware/timer.h: o temporizador de 1 MHz é o relógio da simulação
+#ifndef _HARDWARE_TIMER_H
+#define _HARDWARE_TIMER_H
+
+#include "pico/time.h"
+
+void busy_wait_us_32(uint32_t delay_us);
+void busy_wait_us(uint64_t delay_us);
+void busy_wait_until(absolute_time_t target);
+
+#endif
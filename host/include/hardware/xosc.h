@@ -0,0 +1,9 @@
+// Substituto de hardware/xosc.h: dormant espera, em tempo virtual, por uma borda de despertar
+#ifndef _HARDWARE_XOSC_H
+#define _HARDWARE_XOSC_H
+
+#include "pico.h"
+
+void xosc_dormant(void);
+
+#endif
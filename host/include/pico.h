@@ -0,0 +1,50 @@
+// Substituto de pico.h para a simulação no host: tipos e macros básicos da SDK
+#ifndef _PICO_H
+#define _PICO_H
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+// No host não há XIP: as seções de RAM são apenas anotações
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name) func_name
+#define __no_inline_not_in_flash_func(func_name) __attribute__((noinline)) func_name
+#define __time_critical_func(func_name) func_name
+#define __isr
+#define __unused __attribute__((unused))
+#define __force_inline inline __attribute__((always_inline))
+
+#define NUM_CORES 2
+
+// A simulação executa tudo no núcleo 0; testes de estado por núcleo trocam o número com
+// sim_set_core (sim.h)
+extern uint sim_core_num;
+
+static inline uint get_core_num(void)
+{
+    return sim_core_num;
+}
+
+#define hard_assert(x) assert(x)
+#define tight_loop_contents() ((void)0)
+
+enum pico_error_codes
+{
+    PICO_OK = 0,
+    PICO_ERROR_NONE = 0,
+    PICO_ERROR_TIMEOUT = -1,
+    PICO_ERROR_GENERIC = -2,
+    PICO_ERROR_NO_DATA = -3,
+    PICO_ERROR_NOT_PERMITTED = -4,
+    PICO_ERROR_INVALID_ARG = -5,
+    PICO_ERROR_IO = -6,
+};
+
+#endif
@@ -0,0 +1,8 @@
+// Substituto de pico/binary_info.h: metadados do binário não existem no host
+#ifndef _PICO_BINARY_INFO_H
+#define _PICO_BINARY_INFO_H
+
+#define bi_decl(...)
+#define bi_2pins_with_func(...)
+
+#endif
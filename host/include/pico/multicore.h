@@ -0,0 +1,11 @@
+// Substituto de pico/multicore.h: o núcleo 1 não executa na simulação; lançá-lo só liga a
+// disputa pelo barramento no modelo de latência de IRQ (sim.c)
+#ifndef _PICO_MULTICORE_H
+#define _PICO_MULTICORE_H
+
+#include "pico.h"
+
+void multicore_launch_core1(void (*entry)(void));
+void multicore_reset_core1(void);
+
+#endif
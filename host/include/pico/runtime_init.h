@@ -0,0 +1,9 @@
+// Substituto de pico/runtime_init.h: a reconfiguração dos clocks do boot
+#ifndef _PICO_RUNTIME_INIT_H
+#define _PICO_RUNTIME_INIT_H
+
+#include "pico.h"
+
+void runtime_init_clocks(void);
+
+#endif
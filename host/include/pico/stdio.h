@@ -0,0 +1,12 @@
+// Substituto de pico/stdio.h: a saída da firmware vai para o arquivo de stdio da simulação
+#ifndef _PICO_STDIO_H
+#define _PICO_STDIO_H
+
+#include "pico.h"
+
+bool stdio_init_all(void);
+int putchar_raw(int c);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_flush(void);
+
+#endif
@@ -0,0 +1,10 @@
+// Substituto de pico/stdio_usb.h: o "host USB" fica conectado, a não ser que a simulação
+// desligue (sim_set_usb_connected)
+#ifndef _PICO_STDIO_USB_H
+#define _PICO_STDIO_USB_H
+
+#include "pico.h"
+
+bool stdio_usb_connected(void);
+
+#endif
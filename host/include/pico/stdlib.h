@@ -0,0 +1,10 @@
+// Substituto de pico/stdlib.h para a simulação no host
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include "pico.h"
+#include "pico/stdio.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#endif
@@ -0,0 +1,78 @@
+// Substituto de pico/time.h: tempo, sleeps e alarmes sobre o relógio da simulação
+#ifndef _PICO_TIME_H
+#define _PICO_TIME_H
+
+#include "pico.h"
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+uint64_t time_us_64(void);
+
+// Leitura direta de TIMERAWL: não atende eventos nem conta como espera ocupada
+uint32_t time_us_32(void);
+
+static inline absolute_time_t get_absolute_time(void)
+{
+    return time_us_64();
+}
+
+static inline uint64_t to_us_since_boot(absolute_time_t t)
+{
+    return t;
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us)
+{
+    return us;
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000);
+}
+
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us)
+{
+    return t + us;
+}
+
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms)
+{
+    return t + (uint64_t)ms * 1000;
+}
+
+static inline absolute_time_t make_timeout_time_us(uint64_t us)
+{
+    return delayed_by_us(get_absolute_time(), us);
+}
+
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return delayed_by_ms(get_absolute_time(), ms);
+}
+
+static inline bool time_reached(absolute_time_t t)
+{
+    return time_us_64() >= t;
+}
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void sleep_until(absolute_time_t target);
+
+// WFE com prazo: volta no prazo ou na primeira interrupção (true se o prazo chegou)
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+#endif
@@ -0,0 +1,10 @@
+// Substituto de tusb.h: só o espaço livre na FIFO de envio do CDC, modelado em sim.c
+// (esvazia no ritmo da USB full-speed, ou não esvazia com sim_set_usb_stalled)
+#ifndef _TUSB_H_
+#define _TUSB_H_
+
+#include "pico.h"
+
+uint32_t tud_cdc_write_available(void);
+
+#endif
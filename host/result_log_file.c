@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "inc/result_log.h"
+#include "result_log_file.h"
+
+// Imagem da região em memória, espelhada num arquivo a cada operação
+static uint8_t region[result_log_size];
+static char region_path[512];
+static bool region_loaded;
+static int tear_after = -1; // Bytes programados antes da "queda de energia" (-1: desativado)
+
+static void region_sync(uint32_t offset, uint32_t length)
+{
+    FILE *file = fopen(region_path, "r+b");
+    if (!file)
+        file = fopen(region_path, "w+b");
+    if (!file)
+        return;
+
+    if (offset == 0 && length == result_log_size)
+    {
+        fwrite(region, 1, result_log_size, file);
+    }
+    else
+    {
+        fseek(file, offset, SEEK_SET);
+        fwrite(region + offset, 1, length, file);
+    }
+    fclose(file);
+}
+
+// Abre (ou cria apagada) a imagem da flash; sem chamada explícita usa LIGEIRINHO_FLASH_FILE
+// ou LIGEIRINHO_FLASH_DEFAULT
+void result_log_file_open(const char *path)
+{
+    snprintf(region_path, sizeof(region_path), "%s", path);
+    memset(region, 0xFF, sizeof(region));
+
+    FILE *file = fopen(region_path, "rb");
+    size_t length = 0;
+    if (file)
+    {
+        length = fread(region, 1, sizeof(region), file);
+        fclose(file);
+    }
+    if (length != sizeof(region))
+        region_sync(0, result_log_size);
+
+    region_loaded = true;
+}
+
+// Simula uma queda de energia: a próxima programação grava só os primeiros 'bytes' bytes
+void result_log_file_tear_after(int bytes)
+{
+    tear_after = bytes;
+}
+
+// Sem --flash nem LIGEIRINHO_FLASH_FILE a imagem fica no diretório da build (host/CMakeLists.txt),
+// nunca no diretório em que a simulação foi chamada
+#ifndef LIGEIRINHO_FLASH_DEFAULT
+#error "LIGEIRINHO_FLASH_DEFAULT: caminho padrão da imagem da flash"
+#endif
+
+static void region_ensure_loaded(void)
+{
+    if (!region_loaded)
+    {
+        const char *path = getenv("LIGEIRINHO_FLASH_FILE");
+        result_log_file_open(path ? path : LIGEIRINHO_FLASH_DEFAULT);
+    }
+}
+
+const uint8_t *result_log_port_region(void)
+{
+    region_ensure_loaded();
+    return region;
+}
+
+bool result_log_port_erase_sector(uint32_t offset)
+{
+    region_ensure_loaded();
+    uint32_t length = result_log_sector_size;
+
+    if (tear_after >= 0)
+    {
+        // Apagamento interrompido: só parte do setor volta a 0xFF
+        length = (uint32_t)tear_after < length ? (uint32_t)tear_after : length;
+        tear_after = -1;
+        memset(region + offset, 0xFF, length);
+        region_sync(offset, result_log_sector_size);
+        return false;
+    }
+
+    memset(region + offset, 0xFF, length);
+    region_sync(offset, length);
+    return true;
+}
+
+bool result_log_port_program_page(uint32_t offset, const uint8_t *data)
+{
+    region_ensure_loaded();
+    uint32_t length = result_log_page_size;
+    bool ok = true;
+
+    if (tear_after >= 0)
+    {
+        length = (uint32_t)tear_after < length ? (uint32_t)tear_after : length;
+        tear_after = -1;
+        ok = false;
+    }
+
+    // NOR: a programação só leva bits de 1 para 0
+    for (uint32_t i = 0; i < length; i++)
+    {
+        region[offset + i] &= data[i];
+    }
+    region_sync(offset, result_log_page_size);
+    return ok;
+}
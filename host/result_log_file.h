@@ -0,0 +1,8 @@
+#ifndef result_log_file_h
+#define result_log_file_h
+
+// Porta de arquivo do registro de resultados para builds no host
+void result_log_file_open(const char *path);
+void result_log_file_tear_after(int bytes);
+
+#endif
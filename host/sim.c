@@ -0,0 +1,1980 @@
+// Implementação da SDK do Pico para a simulação no host.
+//
+// Os "IRQs" (alarmes e bordas de GPIO) são despachados cooperativamente: toda chamada da
+// firmware à SDK passa por sim_poll, que entrega os eventos vencidos. Callbacks não se
+// aninham e ficam adiados enquanto as interrupções estiverem mascaradas.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "pico/runtime_init.h"
+#include "pico/multicore.h"
+#include "hardware/structs/rosc.h"
+#include "inc/ssd1306_font.h"
+#include "inc/telemetry.h"
+#include "sim.h"
+
+// ---------------------------------------------------------------------------------------
+// Relógio virtual
+//
+// O tempo só anda quando a firmware espera (sleeps, __wfi: salto direto ao próximo evento)
+// ou consulta o relógio/os pinos fora de um IRQ (laços de espera ocupada: cada leitura
+// custa poll_quantum_us). Nada depende do relógio do host, então uma sessão é reproduzível.
+
+static uint64_t virtual_us;
+static uint32_t poll_quantum_us = 10;
+
+uint64_t sim_now_us(void)
+{
+    return virtual_us;
+}
+
+void sim_set_poll_quantum(uint32_t quantum_us)
+{
+    poll_quantum_us = quantum_us ? quantum_us : 1;
+}
+
+static void clock_wait_until(uint64_t time_us)
+{
+    if (time_us > virtual_us)
+        virtual_us = time_us;
+}
+
+// ---------------------------------------------------------------------------------------
+// Fila de eventos (heap mínimo por tempo e ordem de criação)
+
+typedef enum
+{
+    event_alarm,
+    event_input,
+    event_call,
+    event_dma,
+    event_pwm_wrap,
+    event_pwm_edge,
+    event_cancelled,
+} event_kind_t;
+
+typedef struct
+{
+    uint64_t time_us;
+    uint64_t seq;
+    event_kind_t kind;
+    alarm_id_t id;
+    alarm_callback_t callback;
+    sim_call_t call;
+    void *user_data;
+    uint pin; // Também o canal, em event_dma, e a fatia, em event_pwm_wrap
+    bool level;
+    uint64_t edge_ns; // Instante exato da borda, em event_pwm_edge
+} sim_timer_t;
+
+static sim_timer_t *heap;
+static size_t heap_size, heap_capacity;
+static uint64_t next_seq;
+static alarm_id_t next_alarm_id = 1;
+
+static bool timer_before(const sim_timer_t *a, const sim_timer_t *b)
+{
+    return a->time_us < b->time_us || (a->time_us == b->time_us && a->seq < b->seq);
+}
+
+static void heap_push(sim_timer_t timer)
+{
+    if (heap_size == heap_capacity)
+    {
+        heap_capacity = heap_capacity ? heap_capacity * 2 : 64;
+        heap = realloc(heap, heap_capacity * sizeof(*heap));
+    }
+
+    timer.seq = next_seq++;
+    size_t i = heap_size++;
+    while (i > 0 && timer_before(&timer, &heap[(i - 1) / 2]))
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = timer;
+}
+
+static sim_timer_t heap_pop(void)
+{
+    sim_timer_t top = heap[0];
+    sim_timer_t last = heap[--heap_size];
+    size_t i = 0;
+
+    while (true)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= heap_size)
+            break;
+        if (child + 1 < heap_size && timer_before(&heap[child + 1], &heap[child]))
+            child++;
+        if (!timer_before(&heap[child], &last))
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (heap_size > 0)
+        heap[i] = last;
+    return top;
+}
+
+// ---------------------------------------------------------------------------------------
+// Estado dos periféricos
+
+typedef struct
+{
+    uint8_t function;
+    bool out;
+    bool pull_up, pull_down;
+    bool out_value;
+    int8_t driven; // Nível forçado externamente (-1: nenhum)
+    bool level;
+    uint32_t irq_mask;
+    uint32_t irq_pending;
+    uint32_t dormant_mask;    // Eventos que acordam do dormant
+    uint32_t dormant_pending;
+    uint64_t edge_ns;         // Primeira borda pendente (modelo de latência de IRQ)
+    bool edge_event;          // Há um event_pwm_edge na fila
+} sim_pin_t;
+
+typedef struct
+{
+    uint32_t div; // 8.4
+    uint16_t top;
+    uint16_t cc[2];
+    bool enabled;
+    bool irq_enabled;
+    bool wrap_pending; // Há um event_pwm_wrap na fila
+    uint64_t start_ns; // Contador em 0 (pwm_init ou religada)
+} sim_slice_t;
+
+struct i2c_inst
+{
+    uint index;
+    uint baudrate;
+    uint32_t peri_hz; // clk_peri quando o divisor foi calculado
+};
+
+static sim_pin_t pins[NUM_BANK0_GPIOS];
+static sim_slice_t slices[NUM_PWM_SLICES];
+static gpio_irq_callback_t gpio_callback_fn;
+#define CLOCK_BOOT_HZ                                                                        \
+    {                                                                                        \
+        [clk_ref] = 12000000, [clk_sys] = 125000000, [clk_peri] = 125000000,                 \
+        [clk_usb] = 48000000, [clk_adc] = 48000000,  [clk_rtc] = 46875                       \
+    }
+static const uint32_t clock_boot_hz[CLK_COUNT] = CLOCK_BOOT_HZ;
+static uint32_t clock_hz[CLK_COUNT] = CLOCK_BOOT_HZ;
+
+static struct i2c_inst i2c_instances[2] = {{.index = 0}, {.index = 1}};
+i2c_inst_t *const sim_i2c0 = &i2c_instances[0];
+i2c_inst_t *const sim_i2c1 = &i2c_instances[1];
+
+static uint32_t pins_with_edges; // Pinos com irq_pending desde o último despacho
+static int irq_depth;
+static bool irq_masked;
+static bool polling;
+
+static sim_observer_t observer;
+static void *observer_data;
+static FILE *stdio_file;
+static sim_exit_hook_t exit_hook;
+
+static void emit(sim_event_t event)
+{
+    event.time_us = sim_now_us();
+    if (observer)
+        observer(&event, observer_data);
+}
+
+// ---------------------------------------------------------------------------------------
+// Latência de IRQ (modelo)
+//
+// Os tempos em µs da simulação não mudam: a latência de entrada num callback de GPIO só
+// aparece em leituras de ciclo dentro do callback (pwm_get_counter) e em sim_irq_report.
+// A entrada leva model.entry ciclos de clk_sys a partir da borda, depois do fim dos handlers
+// que já ocupavam o núcleo: alarmes, wrap do PWM, DMA, o próprio callback de GPIO, os pacotes
+// da USB (um IRQ a cada 64 bytes de stdio) e as seções com interrupções mascaradas, cada um
+// pelos ciclos do modelo, em fila. Com o núcleo 1 rodando, cada entrada ganha de 0 a
+// model.core1 ciclos de disputa pelo barramento, numa sequência fixa (a sessão continua
+// reproduzível). Os custos padrão são estimativas para calibrar com o diagnóstico 'L' da
+// placa.
+
+static sim_irq_model_t irq_model = {
+    .entry = 100, .gpio = 500, .alarm = 700, .pwm = 300, .dma = 3000, .usb = 1500, .masked = 50, .core1 = 20};
+static uint64_t busy_start_ns, busy_until_ns; // Handlers em fila desde busy_start_ns
+static int64_t irq_entry_offset_ns;            // Entrada no callback de GPIO em andamento - agora
+static bool core1_running;
+static uint32_t core1_jitter = 1;
+static uint32_t usb_packet_bytes;
+static bool core_event; // Registrador de eventos do WFE: um IRQ atendido desde a última espera
+
+typedef struct
+{
+    uint64_t count, sum_ns;
+    uint64_t max_ns;
+} sim_irq_stats_t;
+
+static sim_irq_stats_t irq_stats[NUM_BANK0_GPIOS];
+
+static uint64_t now_ns(void)
+{
+    return virtual_us * 1000;
+}
+
+static uint64_t cycles_ns(uint32_t cycles)
+{
+    return (uint64_t)cycles * 1000000000 / clock_hz[clk_sys];
+}
+
+// Um handler ocupa o núcleo por cycles, a partir de start_ns ou do fim do anterior
+static void irq_busy(uint64_t start_ns, uint32_t cycles)
+{
+    if (start_ns >= busy_until_ns)
+        busy_start_ns = busy_until_ns = start_ns;
+    busy_until_ns += cycles_ns(cycles);
+}
+
+// Instante de entrada no callback de uma borda em edge_ns, entregue agora
+static uint64_t irq_entry_ns(uint64_t edge_ns)
+{
+    // Entrega adiada (interrupções mascaradas): a entrada não acontece antes de agora
+    uint64_t start = now_ns() >= edge_ns + 1000 ? now_ns() : edge_ns;
+    if (start >= busy_start_ns && start < busy_until_ns)
+        start = busy_until_ns;
+
+    uint32_t cycles = irq_model.entry;
+    if (core1_running && irq_model.core1)
+    {
+        core1_jitter = core1_jitter * 1103515245u + 12345u;
+        cycles += (core1_jitter >> 16) % (irq_model.core1 + 1);
+    }
+    return start + cycles_ns(cycles);
+}
+
+bool sim_set_irq_model(const char *spec)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t *cycles;
+    } fields[] = {{"entry", &irq_model.entry}, {"gpio", &irq_model.gpio},     {"alarm", &irq_model.alarm},
+                  {"pwm", &irq_model.pwm},     {"dma", &irq_model.dma},       {"usb", &irq_model.usb},
+                  {"masked", &irq_model.masked}, {"core1", &irq_model.core1}};
+
+    while (*spec)
+    {
+        size_t length = strcspn(spec, "=");
+        char *end;
+        size_t i = 0;
+        while (i < sizeof(fields) / sizeof(fields[0]) &&
+               (strlen(fields[i].name) != length || strncmp(fields[i].name, spec, length)))
+            i++;
+        if (i == sizeof(fields) / sizeof(fields[0]) || spec[length] != '=')
+            return false;
+
+        unsigned long cycles = strtoul(spec + length + 1, &end, 10);
+        if (end == spec + length + 1 || (*end && *end != ','))
+            return false;
+        *fields[i].cycles = (uint32_t)cycles;
+        spec = *end ? end + 1 : end;
+    }
+    return true;
+}
+
+void sim_irq_report(FILE *out)
+{
+    for (uint pin = 0; pin < NUM_BANK0_GPIOS; pin++)
+    {
+        const sim_irq_stats_t *stats = &irq_stats[pin];
+        if (stats->count)
+            fprintf(out, "sim: latencia de IRQ do GPIO %u: %" PRIu64 " bordas, media %" PRIu64 " ns, maximo %" PRIu64 " ns\n",
+                    pin, stats->count, stats->sum_ns / stats->count, stats->max_ns);
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// Despacho
+
+static void deliver_gpio_irqs(void)
+{
+    // Caminho comum nos laços de espera ocupada: nenhuma borda desde o último despacho
+    if (!pins_with_edges)
+        return;
+    pins_with_edges = 0;
+
+    for (uint pin = 0; pin < NUM_BANK0_GPIOS; pin++)
+    {
+        uint32_t events = pins[pin].irq_pending & pins[pin].irq_mask;
+        pins[pin].irq_pending = 0;
+        if (events && gpio_callback_fn)
+        {
+            uint64_t entry_ns = irq_entry_ns(pins[pin].edge_ns);
+            sim_irq_stats_t *stats = &irq_stats[pin];
+            uint64_t latency_ns = entry_ns - pins[pin].edge_ns;
+            stats->count++;
+            stats->sum_ns += latency_ns;
+            if (latency_ns > stats->max_ns)
+                stats->max_ns = latency_ns;
+
+            irq_entry_offset_ns = (int64_t)(entry_ns - now_ns());
+            irq_depth++;
+            gpio_callback_fn(pin, events);
+            irq_depth--;
+            irq_entry_offset_ns = 0;
+            irq_busy(entry_ns, irq_model.gpio);
+            core_event = true;
+        }
+    }
+}
+
+static void dma_complete(uint channel);
+static void pwm_wrap(uint slice_num, uint64_t time_us);
+static void pwm_edge(uint gpio, uint64_t edge_ns);
+static void pwm_schedule_edges(uint slice_num);
+
+static void dispatch(sim_timer_t timer)
+{
+    if (timer.kind == event_cancelled)
+        return;
+    if (timer.kind == event_input)
+    {
+        sim_gpio_drive(timer.pin, timer.level);
+        return;
+    }
+    if (timer.kind == event_call)
+    {
+        timer.call(timer.user_data);
+        return;
+    }
+    if (timer.kind == event_dma)
+    {
+        dma_complete(timer.pin);
+        return;
+    }
+    if (timer.kind == event_pwm_wrap)
+    {
+        pwm_wrap(timer.pin, timer.time_us);
+        return;
+    }
+    if (timer.kind == event_pwm_edge)
+    {
+        pwm_edge(timer.pin, timer.edge_ns);
+        return;
+    }
+
+    irq_busy(now_ns(), irq_model.alarm);
+    core_event = true;
+    irq_depth++;
+    int64_t next = timer.callback(timer.id, timer.user_data);
+    irq_depth--;
+
+    // Semântica da SDK: >0 reagenda a partir do retorno, <0 a partir do horário previsto
+    if (next != 0)
+    {
+        timer.time_us = next > 0 ? sim_now_us() + (uint64_t)next : timer.time_us + (uint64_t)(-next);
+        heap_push(timer);
+    }
+}
+
+// Entrega tudo que venceu; chamada na entrada de toda função da SDK simulada
+static void sim_poll(void)
+{
+    if (irq_depth > 0 || irq_masked || polling)
+        return;
+
+    polling = true;
+    deliver_gpio_irqs();
+    while (heap_size > 0 && heap[0].time_us <= sim_now_us())
+    {
+        dispatch(heap_pop());
+        deliver_gpio_irqs();
+    }
+    polling = false;
+}
+
+// Custo de uma leitura num laço de espera ocupada; nunca passa do próximo evento, para que
+// bordas e alarmes sejam entregues no instante exato
+static void sim_busy_poll(void)
+{
+    if (irq_depth == 0 && !irq_masked && !polling)
+    {
+        uint64_t next = virtual_us + poll_quantum_us;
+        if (heap_size > 0 && heap[0].time_us > virtual_us && heap[0].time_us < next)
+            next = heap[0].time_us;
+        virtual_us = next;
+    }
+    sim_poll();
+}
+
+// Espera até o instante indicado, atendendo eventos no caminho
+static void sim_wait_until(uint64_t time_us)
+{
+    while (true)
+    {
+        sim_poll();
+        if (sim_now_us() >= time_us)
+            return;
+
+        uint64_t next = time_us;
+        if (heap_size > 0 && heap[0].time_us < next && irq_depth == 0 && !irq_masked)
+            next = heap[0].time_us;
+        clock_wait_until(next);
+    }
+}
+
+// ---------------------------------------------------------------------------------------
+// pico/time.h
+
+uint64_t time_us_64(void)
+{
+    sim_busy_poll();
+    return sim_now_us();
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)virtual_us;
+}
+
+void sleep_until(absolute_time_t target)
+{
+    sim_wait_until(target);
+}
+
+void sleep_us(uint64_t us)
+{
+    sim_wait_until(sim_now_us() + us);
+}
+
+void busy_wait_us(uint64_t delay_us)
+{
+    sleep_us(delay_us);
+}
+
+void busy_wait_us_32(uint32_t delay_us)
+{
+    sleep_us(delay_us);
+}
+
+void busy_wait_until(absolute_time_t target)
+{
+    sim_wait_until(target);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000);
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    if (time <= sim_now_us() && !fire_if_past)
+        return 0;
+
+    sim_timer_t timer = {
+        .time_us = time,
+        .kind = event_alarm,
+        .id = next_alarm_id++,
+        .callback = callback,
+        .user_data = user_data,
+    };
+    heap_push(timer);
+    return timer.id;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_at(sim_now_us() + us, callback, user_data, fire_if_past);
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    // Cancelamento preguiçoso: o evento continua na fila, mas é ignorado no despacho
+    for (size_t i = 0; i < heap_size; i++)
+    {
+        if (heap[i].kind == event_alarm && heap[i].id == alarm_id)
+        {
+            heap[i].kind = event_cancelled;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/sync.h
+
+uint32_t save_and_disable_interrupts(void)
+{
+    uint32_t previous = irq_masked;
+    irq_masked = true;
+    return previous;
+}
+
+void restore_interrupts(uint32_t status)
+{
+    if (irq_masked && !status)
+        irq_busy(now_ns(), irq_model.masked);
+    irq_masked = status != 0;
+    sim_poll();
+}
+
+// Salta até o prazo ou até o primeiro evento que atender um IRQ; um IRQ atendido antes
+// (durante o trabalho do laço) faz a espera voltar na hora, como no Cortex-M0+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp)
+{
+    sim_poll();
+    while (!core_event && sim_now_us() < timeout_timestamp)
+    {
+        uint64_t next = timeout_timestamp;
+        if (heap_size > 0 && heap[0].time_us < next && irq_depth == 0 && !irq_masked)
+            next = heap[0].time_us;
+        clock_wait_until(next);
+        sim_poll();
+    }
+    core_event = false;
+    return sim_now_us() >= timeout_timestamp;
+}
+
+void __wfi(void)
+{
+    if (heap_size > 0)
+        sim_wait_until(heap[0].time_us);
+    else
+        sim_poll();
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/gpio.h
+
+static bool pin_level(const sim_pin_t *pin)
+{
+    if (pin->driven >= 0)
+        return pin->driven;
+    if (pin->out && pin->function == GPIO_FUNC_SIO)
+        return pin->out_value;
+    return pin->pull_up;
+}
+
+static void panel_scl_rise(uint gpio);
+
+// Recalcula o nível do pino e registra a borda para o IRQ
+static void pin_update(uint gpio)
+{
+    sim_pin_t *pin = &pins[gpio];
+    bool level = pin_level(pin);
+
+    if (level != pin->level)
+    {
+        pin->level = level;
+        if (level)
+            panel_scl_rise(gpio);
+        if (!pin->irq_pending)
+            pin->edge_ns = now_ns();
+        pin->irq_pending |= level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+        pin->dormant_pending |= (level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL) & pin->dormant_mask;
+        pins_with_edges |= 1u << gpio;
+    }
+}
+
+void gpio_init(uint gpio)
+{
+    sim_poll();
+    pins[gpio].function = GPIO_FUNC_SIO;
+    pins[gpio].out = false;
+    pins[gpio].out_value = false;
+    pin_update(gpio);
+    pins[gpio].irq_pending = 0;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    pins[gpio].function = fn;
+    pwm_schedule_edges(pwm_gpio_to_slice_num(gpio));
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    pins[gpio].out = out;
+    pin_update(gpio);
+}
+
+void gpio_set_pulls(uint gpio, bool up, bool down)
+{
+    pins[gpio].pull_up = up;
+    pins[gpio].pull_down = down;
+    pin_update(gpio);
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    sim_poll();
+    if (pins[gpio].out_value != value)
+    {
+        pins[gpio].out_value = value;
+        pin_update(gpio);
+        emit((sim_event_t){.kind = sim_event_output, .pin = gpio, .value = value});
+    }
+}
+
+bool gpio_get(uint gpio)
+{
+    sim_busy_poll();
+    return pins[gpio].level;
+}
+
+uint32_t gpio_get_all(void)
+{
+    sim_busy_poll();
+    uint32_t all = 0;
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        all |= (uint32_t)pins[gpio].level << gpio;
+    }
+    return all;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled)
+{
+    // Como no hardware, bordas antigas são descartadas ao habilitar
+    pins[gpio].irq_pending &= ~event_mask;
+    if (enabled)
+        pins[gpio].irq_mask |= event_mask;
+    else
+        pins[gpio].irq_mask &= ~event_mask;
+    pwm_schedule_edges(pwm_gpio_to_slice_num(gpio));
+}
+
+void gpio_set_irq_callback(gpio_irq_callback_t callback)
+{
+    gpio_callback_fn = callback;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+    gpio_set_irq_callback(callback);
+}
+
+void gpio_set_dormant_irq_enabled(uint gpio, uint32_t event_mask, bool enabled)
+{
+    pins[gpio].dormant_pending &= ~event_mask;
+    if (enabled)
+        pins[gpio].dormant_mask |= event_mask;
+    else
+        pins[gpio].dormant_mask &= ~event_mask;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask)
+{
+    pins[gpio].irq_pending &= ~event_mask;
+    pins[gpio].dormant_pending &= ~event_mask;
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/pwm.h
+
+static void pwm_emit(uint gpio)
+{
+    if (pins[gpio].function != GPIO_FUNC_PWM)
+        return;
+
+    const sim_slice_t *slice = &slices[pwm_gpio_to_slice_num(gpio)];
+    emit((sim_event_t){.kind = sim_event_pwm,
+                       .pin = gpio,
+                       .value = slice->cc[pwm_gpio_to_channel(gpio)],
+                       .wrap = slice->top});
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start)
+{
+    slices[slice_num].div = c->div;
+    slices[slice_num].top = (uint16_t)c->top;
+    slices[slice_num].cc[0] = slices[slice_num].cc[1] = 0;
+    slices[slice_num].enabled = start;
+    slices[slice_num].start_ns = now_ns();
+    pwm_schedule_edges(slice_num);
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap)
+{
+    slices[slice_num].top = wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider)
+{
+    slices[slice_num].div = (uint32_t)(divider * 16.0f);
+}
+
+void pwm_set_clkdiv_int_frac(uint slice_num, uint8_t integer, uint8_t fract)
+{
+    slices[slice_num].div = ((uint32_t)integer << 4) | fract;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled)
+{
+    if (enabled && !slices[slice_num].enabled)
+        slices[slice_num].start_ns = now_ns();
+    slices[slice_num].enabled = enabled;
+    pwm_schedule_edges(slice_num);
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level)
+{
+    sim_poll();
+    if (slices[slice_num].cc[chan] == level)
+        return;
+
+    slices[slice_num].cc[chan] = level;
+    sim_pwm_hw.slice[slice_num].cc = slices[slice_num].cc[0] | ((uint32_t)slices[slice_num].cc[1] << 16);
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        if (pwm_gpio_to_slice_num(gpio) == slice_num && pwm_gpio_to_channel(gpio) == chan)
+            pwm_emit(gpio);
+    }
+    pwm_schedule_edges(slice_num);
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level)
+{
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/dma.h e hardware/irq.h
+//
+// Um bloco inteiro é copiado no instante em que o último item seria transferido: com DREQ
+// de um DMA timer, trans_count / (clk_sys * X / Y) depois do disparo; sem DREQ (ou com
+// outro DREQ), no mesmo instante. O fim do bloco dispara o canal encadeado e o IRQ.
+
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    const volatile uint8_t *read_addr;
+    volatile uint8_t *write_addr;
+    uint32_t trans_count;
+    dma_channel_config config;
+    bool irq0_enabled;
+} sim_dma_channel_t;
+
+static sim_dma_channel_t dma_channels[NUM_DMA_CHANNELS];
+static uint32_t dma_timer_fraction[NUM_DMA_TIMERS];
+static uint32_t dma_timers_claimed, dma_ints0;
+static irq_handler_t irq_handlers[DMA_IRQ_1 + 1];
+static uint32_t irqs_enabled;
+
+pwm_hw_t sim_pwm_hw;
+
+int dma_claim_unused_channel(bool required)
+{
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+        if (!dma_channels[channel].claimed)
+        {
+            dma_channels[channel].claimed = true;
+            return (int)channel;
+        }
+    }
+    if (required)
+    {
+        fprintf(stderr, "sim: nenhum canal de DMA livre\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    dma_channels[channel].claimed = false;
+}
+
+int dma_claim_unused_timer(bool required)
+{
+    for (uint timer = 0; timer < NUM_DMA_TIMERS; timer++)
+    {
+        if (!(dma_timers_claimed & (1u << timer)))
+        {
+            dma_timers_claimed |= 1u << timer;
+            return (int)timer;
+        }
+    }
+    if (required)
+    {
+        fprintf(stderr, "sim: nenhum DMA timer livre\n");
+        abort();
+    }
+    return -1;
+}
+
+void dma_timer_unclaim(uint timer)
+{
+    dma_timers_claimed &= ~(1u << timer);
+}
+
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator)
+{
+    dma_timer_fraction[timer] = ((uint32_t)numerator << 16) | denominator;
+}
+
+// Duração de um bloco no ritmo do DREQ configurado
+static uint64_t dma_block_us(const sim_dma_channel_t *ch)
+{
+    uint dreq = (ch->config.ctrl & DMA_CH0_CTRL_TRIG_TREQ_SEL_BITS) >> DMA_CH0_CTRL_TRIG_TREQ_SEL_LSB;
+    if (dreq < DREQ_DMA_TIMER0 || dreq >= DREQ_DMA_TIMER0 + NUM_DMA_TIMERS)
+        return 0;
+
+    uint32_t fraction = dma_timer_fraction[dreq - DREQ_DMA_TIMER0];
+    uint64_t numerator = fraction >> 16, denominator = fraction & 0xFFFF;
+    if (!numerator || !denominator)
+        return UINT64_MAX; // Timer parado: o canal nunca termina
+    return (uint64_t)ch->trans_count * denominator * 1000000 / ((uint64_t)clock_hz[clk_sys] * numerator);
+}
+
+static void dma_cancel_pending(uint channel)
+{
+    for (size_t i = 0; i < heap_size; i++)
+    {
+        if (heap[i].kind == event_dma && heap[i].pin == channel)
+            heap[i].kind = event_cancelled;
+    }
+}
+
+void dma_channel_start(uint channel)
+{
+    sim_dma_channel_t *ch = &dma_channels[channel];
+    if (!(ch->config.ctrl & DMA_CH0_CTRL_TRIG_EN_BITS))
+        return;
+
+    dma_cancel_pending(channel);
+    ch->busy = true;
+    uint64_t duration = dma_block_us(ch);
+    if (duration != UINT64_MAX)
+        heap_push((sim_timer_t){.time_us = sim_now_us() + duration, .kind = event_dma, .pin = channel});
+}
+
+static bool dma_is_pwm(volatile uint8_t *addr)
+{
+    volatile uint8_t *base = (volatile uint8_t *)&sim_pwm_hw;
+    return addr >= base && addr < base + sizeof(sim_pwm_hw);
+}
+
+// Registradores de periférico replicam escritas estreitas nas outras faixas do barramento
+static void dma_write_pwm(volatile uint8_t *addr, uint32_t value, uint size)
+{
+    volatile uint8_t *base = (volatile uint8_t *)&sim_pwm_hw;
+    size_t offset = (size_t)(addr - base) & ~(size_t)3;
+    uint32_t word = size == 1 ? value * 0x01010101u : size == 2 ? value * 0x00010001u : value;
+    uint slice = (uint)(offset / sizeof(pwm_slice_hw_t));
+    size_t reg = offset % sizeof(pwm_slice_hw_t);
+
+    if (reg == offsetof(pwm_slice_hw_t, cc))
+    {
+        pwm_set_chan_level(slice, 0, (uint16_t)word);
+        pwm_set_chan_level(slice, 1, (uint16_t)(word >> 16));
+    }
+    else if (reg == offsetof(pwm_slice_hw_t, top))
+    {
+        pwm_set_wrap(slice, (uint16_t)word);
+        sim_pwm_hw.slice[slice].top = word;
+    }
+}
+
+static void dma_complete(uint channel)
+{
+    sim_dma_channel_t *ch = &dma_channels[channel];
+    uint32_t ctrl = ch->config.ctrl;
+    uint size = 1u << ((ctrl & DMA_CH0_CTRL_TRIG_DATA_SIZE_BITS) >> DMA_CH0_CTRL_TRIG_DATA_SIZE_LSB);
+    bool incr_read = ctrl & DMA_CH0_CTRL_TRIG_INCR_READ_BITS, incr_write = ctrl & DMA_CH0_CTRL_TRIG_INCR_WRITE_BITS;
+
+    // Só o último item escrito num endereço fixo de periférico é visível
+    for (uint32_t i = 0; i < ch->trans_count; i++)
+    {
+        uint32_t value = 0;
+        memcpy(&value, (const void *)ch->read_addr, size);
+        if (!dma_is_pwm(ch->write_addr))
+            memcpy((void *)ch->write_addr, &value, size);
+        else if (incr_write || i + 1 == ch->trans_count)
+            dma_write_pwm(ch->write_addr, value, size);
+        if (incr_read)
+            ch->read_addr += size;
+        if (incr_write)
+            ch->write_addr += size;
+    }
+    ch->busy = false;
+
+    uint chain_to = (ctrl & DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS) >> DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB;
+    if (chain_to != channel)
+        dma_channel_start(chain_to);
+
+    if (ch->irq0_enabled)
+    {
+        dma_ints0 |= 1u << channel;
+        if ((irqs_enabled & (1u << DMA_IRQ_0)) && irq_handlers[DMA_IRQ_0])
+        {
+            irq_busy(now_ns(), irq_model.dma);
+            core_event = true;
+            irq_depth++;
+            irq_handlers[DMA_IRQ_0]();
+            irq_depth--;
+        }
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger)
+{
+    sim_dma_channel_t *ch = &dma_channels[channel];
+    ch->config = *config;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    ch->trans_count = transfer_count;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_config(uint channel, const dma_channel_config *config, bool trigger)
+{
+    dma_channels[channel].config = *config;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger)
+{
+    dma_channels[channel].read_addr = read_addr;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger)
+{
+    dma_channels[channel].trans_count = trans_count;
+    if (trigger)
+        dma_channel_start(channel);
+}
+
+void dma_channel_abort(uint channel)
+{
+    dma_cancel_pending(channel);
+    dma_channels[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    sim_poll();
+    return dma_channels[channel].busy;
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    dma_channels[channel].irq0_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return dma_ints0 & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    dma_ints0 &= ~(1u << channel);
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    irqs_enabled = enabled ? irqs_enabled | (1u << num) : irqs_enabled & ~(1u << num);
+}
+
+// IRQ de wrap do PWM: com o IRQ da fatia habilitado, um evento a cada período do contador
+// (div * (top + 1) / clk_sys, lido a cada wrap); sem ele, nenhum evento na fila
+
+static uint32_t pwm_intr;
+
+static uint64_t pwm_period_us(uint slice_num)
+{
+    const sim_slice_t *slice = &slices[slice_num];
+    uint64_t period = (uint64_t)slice->div * (slice->top + 1u) * 1000000 / ((uint64_t)clock_hz[clk_sys] * 16);
+    return period ? period : 1;
+}
+
+static void pwm_schedule_wrap(uint slice_num, uint64_t from_us)
+{
+    slices[slice_num].wrap_pending = true;
+    heap_push((sim_timer_t){.time_us = from_us + pwm_period_us(slice_num), .kind = event_pwm_wrap, .pin = slice_num});
+}
+
+static void pwm_wrap(uint slice_num, uint64_t time_us)
+{
+    sim_slice_t *slice = &slices[slice_num];
+    slice->wrap_pending = false;
+    if (!slice->irq_enabled)
+        return;
+
+    pwm_intr |= 1u << slice_num;
+    if ((irqs_enabled & (1u << PWM_IRQ_WRAP)) && irq_handlers[PWM_IRQ_WRAP])
+    {
+        irq_busy(now_ns(), irq_model.pwm);
+        core_event = true;
+        irq_depth++;
+        irq_handlers[PWM_IRQ_WRAP]();
+        irq_depth--;
+    }
+    if (slice->irq_enabled && !slice->wrap_pending)
+        pwm_schedule_wrap(slice_num, time_us);
+}
+
+void pwm_set_irq_enabled(uint slice_num, bool enabled)
+{
+    sim_poll();
+    sim_slice_t *slice = &slices[slice_num];
+    slice->irq_enabled = enabled;
+    if (enabled && !slice->wrap_pending)
+        pwm_schedule_wrap(slice_num, sim_now_us());
+    else if (!enabled && slice->wrap_pending)
+    {
+        for (size_t i = 0; i < heap_size; i++)
+        {
+            if (heap[i].kind == event_pwm_wrap && heap[i].pin == slice_num)
+                heap[i].kind = event_cancelled;
+        }
+        slice->wrap_pending = false;
+    }
+}
+
+void pwm_clear_irq(uint slice_num)
+{
+    pwm_intr &= ~(1u << slice_num);
+}
+
+uint32_t pwm_get_irq_status_mask(void)
+{
+    return pwm_intr;
+}
+
+// Bordas da saída de PWM: um pino com função PWM, nível > 0 e IRQ de subida habilitado
+// (o gerador do diagnóstico de latência, inc/irq_latency.h) sobe a cada wrap do contador.
+// O instante exato de cada subida (em ns) vai para o modelo de latência; as descidas, na
+// comparação, não são simuladas.
+
+static double pwm_tick_ns(const sim_slice_t *slice)
+{
+    return slice->div * 1e9 / (16.0 * clock_hz[clk_sys]);
+}
+
+static bool pwm_edge_source(uint gpio)
+{
+    const sim_pin_t *pin = &pins[gpio];
+    const sim_slice_t *slice = &slices[pwm_gpio_to_slice_num(gpio)];
+    return pin->function == GPIO_FUNC_PWM && (pin->irq_mask & GPIO_IRQ_EDGE_RISE) && slice->enabled &&
+           slice->cc[pwm_gpio_to_channel(gpio)] > 0;
+}
+
+// Agenda a próxima subida dos pinos da fatia que geram bordas (cancelamento preguiçoso: a
+// condição é conferida de novo na borda)
+static void pwm_schedule_edges(uint slice_num)
+{
+    const sim_slice_t *slice = &slices[slice_num];
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        if (pwm_gpio_to_slice_num(gpio) != slice_num || pins[gpio].edge_event || !pwm_edge_source(gpio))
+            continue;
+
+        double period_ns = pwm_tick_ns(slice) * (slice->top + 1.0);
+        uint64_t wraps = (uint64_t)((now_ns() - slice->start_ns) / period_ns) + 1;
+        double exact = slice->start_ns + wraps * period_ns;
+        uint64_t edge_ns = (uint64_t)exact;
+        if (edge_ns < exact)
+            edge_ns++;
+
+        pins[gpio].edge_event = true;
+        heap_push((sim_timer_t){.time_us = (edge_ns + 999) / 1000, .kind = event_pwm_edge, .pin = gpio, .edge_ns = edge_ns});
+    }
+}
+
+static void pwm_edge(uint gpio, uint64_t edge_ns)
+{
+    pins[gpio].edge_event = false;
+    if (!pwm_edge_source(gpio))
+        return;
+
+    if (!pins[gpio].irq_pending)
+        pins[gpio].edge_ns = edge_ns;
+    pins[gpio].irq_pending |= GPIO_IRQ_EDGE_RISE;
+    pins_with_edges |= 1u << gpio;
+    pwm_schedule_edges(pwm_gpio_to_slice_num(gpio));
+}
+
+// O contador segue o clk_sys atual desde start_ns; dentro do callback de GPIO, lido no
+// instante de entrada do modelo
+uint16_t pwm_get_counter(uint slice_num)
+{
+    sim_busy_poll();
+    const sim_slice_t *slice = &slices[slice_num];
+    if (!slice->enabled)
+        return 0;
+
+    uint64_t now = now_ns() + irq_entry_offset_ns;
+    if (now < slice->start_ns)
+        return 0;
+    return (uint16_t)((uint64_t)((now - slice->start_ns) / pwm_tick_ns(slice)) % (slice->top + 1u));
+}
+
+// ---------------------------------------------------------------------------------------
+// pico/multicore.h
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    (void)entry;
+    core1_running = true;
+}
+
+void multicore_reset_core1(void)
+{
+    core1_running = false;
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/clocks.h
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    return clock_hz[clk_index];
+}
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq)
+{
+    (void)src;
+    (void)auxsrc;
+    if (freq > src_freq)
+        return false;
+    clock_hz[clk_index] = freq;
+    return true;
+}
+
+void clock_stop(enum clock_index clk_index)
+{
+    clock_hz[clk_index] = 0;
+}
+
+// Mesma busca da SDK: VCO de 750 a 1600 MHz a partir do XOSC, dois pós-divisores de 1 a 7
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    uint32_t reference_khz = XOSC_HZ / 1000;
+    for (uint32_t fbdiv = 320; fbdiv >= 16; fbdiv--)
+    {
+        uint32_t vco_khz = fbdiv * reference_khz;
+        if (vco_khz < 750000 || vco_khz > 1600000)
+            continue;
+        for (uint32_t postdiv1 = 7; postdiv1 >= 1; postdiv1--)
+        {
+            for (uint32_t postdiv2 = postdiv1; postdiv2 >= 1; postdiv2--)
+            {
+                if (vco_khz / (postdiv1 * postdiv2) == freq_khz && vco_khz % (postdiv1 * postdiv2) == 0)
+                {
+                    sim_poll();
+                    clock_hz[clk_sys] = clock_hz[clk_peri] = freq_khz * 1000;
+                    return true;
+                }
+            }
+        }
+    }
+    if (required)
+    {
+        fprintf(stderr, "sim: clk_sys de %u kHz inalcançável pelo PLL\n", freq_khz);
+        abort();
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/pll.h, hardware/xosc.h e pico/runtime_init.h
+//
+// Em dormant nada roda na placa, nem o timer; na simulação o mundo externo continua e o
+// tempo salta de evento em evento até uma borda habilitada em gpio_set_dormant_irq_enabled.
+// Alarmes que vencerem nesse intervalo disparam na hora (na placa, só depois do despertar).
+
+struct sim_pll
+{
+    bool locked;
+};
+
+static struct sim_pll plls[2] = {{true}, {true}};
+PLL const sim_pll_sys = &plls[0], sim_pll_usb = &plls[1];
+
+void pll_deinit(PLL pll)
+{
+    pll->locked = false;
+}
+
+static bool dormant_woken(void)
+{
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        const sim_pin_t *pin = &pins[gpio];
+        if ((pin->dormant_pending & pin->dormant_mask) ||
+            ((pin->dormant_mask & GPIO_IRQ_LEVEL_LOW) && !pin->level) ||
+            ((pin->dormant_mask & GPIO_IRQ_LEVEL_HIGH) && pin->level))
+            return true;
+    }
+    return false;
+}
+
+void xosc_dormant(void)
+{
+    sim_poll();
+    while (!dormant_woken())
+    {
+        if (heap_size == 0)
+        {
+            fprintf(stderr, "sim: dormant sem eventos pendentes\n");
+            sim_exit(0);
+        }
+        sim_wait_until(heap[0].time_us);
+    }
+}
+
+void runtime_init_clocks(void)
+{
+    plls[0].locked = plls[1].locked = true;
+    memcpy(clock_hz, clock_boot_hz, sizeof(clock_hz));
+}
+
+// ---------------------------------------------------------------------------------------
+// Modelo do SSD1306 (128x64, endereço 0x3C)
+
+#define panel_address 0x3C
+#define panel_pages 8
+#define panel_width 128
+
+static uint8_t gddram[panel_pages * panel_width];
+static bool panel_on;
+static bool panel_inverse;
+static uint8_t memory_mode = 0x02; // Padrão do controlador: endereçamento por página
+static uint8_t col_start, col_end = panel_width - 1, page_start, page_end = panel_pages - 1;
+static uint8_t col, page;
+static uint8_t pending_command, pending_args, args_received, args[8];
+static uint64_t last_frame_hash;
+static char frame_text[panel_pages * 18 + 1];
+
+// Falhas do display (sim_display_fault): os pinos do barramento são os da placa
+#define panel_sda 14
+#define panel_scl 15
+#define panel_stuck_clocks 4 // Pulsos de SCL até o escravo travado soltar o SDA
+static sim_display_fault_t panel_fault;
+static bool panel_lost; // Ficou sem alimentação: volta com o estado de reset
+static uint8_t stuck_clocks;
+
+// Argumentos esperados por cada comando de múltiplos bytes
+static uint8_t command_arg_count(uint8_t command)
+{
+    switch (command)
+    {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void panel_execute(uint8_t command)
+{
+    switch (command)
+    {
+    case 0x20:
+        memory_mode = args[0] & 0x03;
+        break;
+    case 0x21:
+        col_start = col = args[0] & 0x7F;
+        col_end = args[1] & 0x7F;
+        break;
+    case 0x22:
+        page_start = page = args[0] & 0x07;
+        page_end = args[1] & 0x07;
+        break;
+    case 0xAE:
+    case 0xAF:
+        if (panel_on != (command == 0xAF))
+        {
+            panel_on = command == 0xAF;
+            emit((sim_event_t){.kind = sim_event_panel, .value = panel_on});
+        }
+        break;
+    case 0xA6:
+    case 0xA7:
+        if (panel_inverse != (command == 0xA7))
+        {
+            panel_inverse = command == 0xA7;
+            emit((sim_event_t){.kind = sim_event_invert, .value = panel_inverse});
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void panel_command(uint8_t byte)
+{
+    if (pending_args)
+    {
+        args[args_received++] = byte;
+        if (args_received == pending_args)
+        {
+            pending_args = 0;
+            panel_execute(pending_command);
+        }
+        return;
+    }
+
+    pending_command = byte;
+    pending_args = command_arg_count(byte);
+    args_received = 0;
+    if (!pending_args)
+        panel_execute(byte);
+}
+
+static void panel_data(uint8_t byte)
+{
+    gddram[page * panel_width + col] = byte;
+
+    if (memory_mode == 0x01)
+    {
+        // Vertical: desce as páginas e depois avança a coluna
+        if (page++ >= page_end)
+        {
+            page = page_start;
+            col = col >= col_end ? col_start : col + 1;
+        }
+    }
+    else if (col++ >= (memory_mode == 0x00 ? col_end : panel_width - 1))
+    {
+        col = memory_mode == 0x00 ? col_start : 0;
+        if (memory_mode == 0x00)
+            page = page >= page_end ? page_start : page + 1;
+    }
+}
+
+uint64_t sim_display_hash(void)
+{
+    // FNV-1a de 64 bits sobre a GDDRAM
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < sizeof(gddram); i++)
+    {
+        hash ^= gddram[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Procura na fonte da firmware um glifo idêntico às 8 colunas indicadas
+static int glyph_at(const uint8_t *columns)
+{
+    static const char charset[] = " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+    for (size_t g = 0; g < sizeof(charset) - 1 && (g + 1) * 8 <= sizeof(font); g++)
+    {
+        if (!memcmp(columns, &font[g * 8], 8))
+            return charset[g];
+    }
+    return -1;
+}
+
+// Reconhece o texto de cada página; linhas separadas por '|'
+const char *sim_display_text(void)
+{
+    size_t n = 0;
+
+    for (uint p = 0; p < panel_pages; p++)
+    {
+        const uint8_t *row = &gddram[p * panel_width];
+        char line[panel_width / 8 + 2];
+        size_t len = 0;
+        bool aligned = false;
+
+        for (uint x = 0; x + 8 <= panel_width && len < sizeof(line) - 1;)
+        {
+            int c = glyph_at(row + x);
+            if (c > 0 && c != ' ')
+            {
+                line[len++] = (char)c;
+                aligned = true;
+                x += 8;
+            }
+            else if (c == ' ' && aligned)
+            {
+                line[len++] = ' ';
+                x += 8;
+            }
+            else
+            {
+                aligned = false;
+                x++;
+            }
+        }
+        while (len > 0 && line[len - 1] == ' ')
+            len--;
+        line[len] = '\0';
+
+        if (len == 0)
+            continue;
+        n += snprintf(frame_text + n, sizeof(frame_text) - n, "%s%s", n ? "|" : "", line);
+    }
+    frame_text[n] = '\0';
+    return frame_text;
+}
+
+const uint8_t *sim_display_ram(void)
+{
+    return gddram;
+}
+
+bool sim_display_on(void)
+{
+    return panel_on;
+}
+
+static void panel_write(const uint8_t *src, size_t len)
+{
+    bool data_written = false;
+    size_t i = 0;
+
+    // Byte de controle: Co=1 -> um único byte segue; Co=0 -> o resto é do mesmo tipo
+    while (i < len)
+    {
+        uint8_t control = src[i++];
+        bool data = control & 0x40;
+
+        if (control & 0x80)
+        {
+            if (i < len)
+            {
+                if (data)
+                    panel_data(src[i]);
+                else
+                    panel_command(src[i]);
+                data_written |= data;
+                i++;
+            }
+            continue;
+        }
+
+        for (; i < len; i++)
+        {
+            if (data)
+                panel_data(src[i]);
+            else
+                panel_command(src[i]);
+        }
+        data_written |= data;
+    }
+
+    if (data_written)
+    {
+        uint64_t hash = sim_display_hash();
+        if (hash != last_frame_hash)
+        {
+            last_frame_hash = hash;
+            emit((sim_event_t){.kind = sim_event_display, .hash = hash, .text = sim_display_text()});
+        }
+    }
+}
+
+// Estado de reset do controlador (display religado): desligado, GDDRAM zerada
+static void panel_reset(void)
+{
+    memset(gddram, 0, sizeof(gddram));
+    if (panel_on)
+    {
+        panel_on = false;
+        emit((sim_event_t){.kind = sim_event_panel, .value = 0});
+    }
+    panel_inverse = false;
+    memory_mode = 0x02;
+    col_start = col = 0, col_end = panel_width - 1;
+    page_start = page = 0, page_end = panel_pages - 1;
+    pending_args = args_received = 0;
+
+    uint64_t hash = sim_display_hash();
+    if (hash != last_frame_hash)
+    {
+        last_frame_hash = hash;
+        emit((sim_event_t){.kind = sim_event_display, .hash = hash, .text = sim_display_text()});
+    }
+}
+
+// Escravo travado segurando o SDA em 0 até panel_stuck_clocks pulsos no SCL (pin_update)
+static void panel_sda_hold(bool hold)
+{
+    pins[panel_sda].driven = hold ? 0 : -1;
+    pin_update(panel_sda);
+}
+
+static void panel_scl_rise(uint gpio)
+{
+    if (gpio == panel_scl && panel_fault == sim_display_stuck && ++stuck_clocks >= panel_stuck_clocks)
+    {
+        panel_fault = sim_display_ok;
+        panel_sda_hold(false);
+    }
+}
+
+void sim_display_fault(sim_display_fault_t fault)
+{
+    if (panel_fault == sim_display_stuck && fault != sim_display_stuck)
+        panel_sda_hold(false);
+    if (fault == sim_display_absent)
+        panel_lost = true;
+    else if (panel_lost)
+    {
+        panel_lost = false;
+        panel_reset();
+    }
+
+    panel_fault = fault;
+    if (fault == sim_display_stuck)
+    {
+        stuck_clocks = 0;
+        panel_sda_hold(true);
+    }
+    sim_poll();
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/i2c.h
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->baudrate = baudrate;
+    i2c->peri_hz = clock_hz[clk_peri];
+    return baudrate;
+}
+
+// Tempo de transmissão: 9 bits por byte, mais o endereço. Como no hardware, o divisor é
+// fixo: se clk_peri mudou depois de i2c_set_baudrate, a taxa muda junto
+static uint64_t i2c_transfer_us(const i2c_inst_t *i2c, size_t len)
+{
+    uint64_t baudrate = i2c->baudrate ? i2c->baudrate : 100000;
+    if (i2c->peri_hz && clock_hz[clk_peri])
+        baudrate = baudrate * clock_hz[clk_peri] / i2c->peri_hz;
+    return ((uint64_t)(len + 1) * 9 * 1000000 + baudrate - 1) / baudrate;
+}
+
+// Ocupa o barramento pelo tempo de transmissão
+static void i2c_transfer_time(const i2c_inst_t *i2c, size_t len)
+{
+    sleep_us(i2c_transfer_us(i2c, len));
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)nostop;
+    if (i2c->index == 1 && panel_fault == sim_display_stuck)
+    {
+        // Na placa, a escrita sem prazo esperaria o SDA para sempre
+        fprintf(stderr, "sim: i2c_write_blocking com o barramento travado (SDA em 0)\n");
+        sim_exit(1);
+    }
+
+    bool nack = i2c->index != 1 || addr != panel_address || panel_fault == sim_display_absent;
+    i2c_transfer_time(i2c, nack ? 0 : len); // Sem ACK do endereço, a escrita termina nele
+
+    if (nack)
+        return PICO_ERROR_GENERIC;
+
+    panel_write(src, len);
+    return (int)len;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                         uint timeout_us)
+{
+    bool stuck = i2c->index == 1 && panel_fault == sim_display_stuck;
+    if (stuck || i2c_transfer_us(i2c, len) > timeout_us)
+    {
+        sleep_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    return i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+    (void)nostop;
+    if (i2c->index == 1 && panel_fault == sim_display_stuck)
+    {
+        fprintf(stderr, "sim: i2c_read_blocking com o barramento travado (SDA em 0)\n");
+        sim_exit(1);
+    }
+
+    bool nack = i2c->index != 1 || addr != panel_address || panel_fault == sim_display_absent;
+    i2c_transfer_time(i2c, nack ? 0 : len);
+
+    if (nack)
+        return PICO_ERROR_GENERIC;
+
+    // Byte de status do SSD1306: bit 6 com o display desligado
+    memset(dst, panel_on ? 0x00 : 0x40, len);
+    return (int)len;
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                        uint timeout_us)
+{
+    bool stuck = i2c->index == 1 && panel_fault == sim_display_stuck;
+    if (stuck || i2c_transfer_us(i2c, len) > timeout_us)
+    {
+        sleep_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    return i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+// ---------------------------------------------------------------------------------------
+// pico/stdio.h
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+// Lado do host da USB: decodifica os quadros de telemetria (inc/telemetry.h) à medida que
+// chegam, para que roteiros e logs vejam estados e tempos exatos da firmware
+static uint8_t usb_frame[telemetry_max_frame];
+static size_t usb_frame_length;
+static bool usb_frame_overflow, usb_synced;
+static uint64_t usb_time_us;
+
+static bool usb_varint(const uint8_t *raw, size_t end, size_t *pos, uint64_t *value)
+{
+    *value = 0;
+    for (unsigned shift = 0; shift < 64 && *pos < end; shift += 7)
+    {
+        uint8_t byte = raw[(*pos)++];
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+static void usb_frame_decode(void)
+{
+    uint8_t raw[telemetry_max_frame];
+    size_t n = 0, i = 0;
+
+    // COBS
+    while (i < usb_frame_length)
+    {
+        uint8_t code = usb_frame[i++];
+        if (i + code - 1 > usb_frame_length)
+            return;
+        for (uint8_t k = 1; k < code; k++)
+            raw[n++] = usb_frame[i++];
+        if (code != 0xFF && i < usb_frame_length)
+            raw[n++] = 0;
+    }
+    if (n < 5 || telemetry_crc8(raw, n - 1) != raw[n - 1])
+    {
+        usb_synced = false;
+        return;
+    }
+
+    size_t pos = 1;
+    uint64_t time, a, b;
+    if (!usb_varint(raw, n - 1, &pos, &time) || !usb_varint(raw, n - 1, &pos, &a) ||
+        !usb_varint(raw, n - 1, &pos, &b) || pos != n - 1)
+    {
+        usb_synced = false;
+        return;
+    }
+
+    if (raw[0] & telemetry_absolute_time)
+    {
+        usb_time_us = time;
+        usb_synced = true;
+    }
+    else if (usb_synced)
+    {
+        usb_time_us += time;
+    }
+    else
+    {
+        return;
+    }
+
+    emit((sim_event_t){.kind = sim_event_telemetry,
+                       .value = raw[0] & ~telemetry_absolute_time,
+                       .record_time_us = usb_time_us,
+                       .a = a,
+                       .b = b});
+}
+
+// FIFO de envio do CDC (CFG_TUD_CDC_TX_BUFSIZE da SDK): o host a esvazia a ~1 byte/µs
+// (USB full-speed), ou não esvazia se parar de ler (sim_set_usb_stalled)
+#define usb_tx_fifo_bytes 256
+static uint32_t usb_tx_level;
+static uint64_t usb_tx_drained_us;
+static bool usb_stalled;
+
+static void usb_tx_drain(void)
+{
+    uint64_t elapsed_us = virtual_us - usb_tx_drained_us;
+
+    usb_tx_drained_us = virtual_us;
+    if (!usb_stalled)
+        usb_tx_level = elapsed_us >= usb_tx_level ? 0 : usb_tx_level - (uint32_t)elapsed_us;
+}
+
+void sim_set_usb_stalled(bool stalled)
+{
+    usb_tx_drain();
+    usb_stalled = stalled;
+}
+
+// Lida em laço (o diagnóstico de latência com carga USB), custa como uma leitura do relógio
+uint32_t tud_cdc_write_available(void)
+{
+    sim_busy_poll();
+    usb_tx_drain();
+    return usb_tx_fifo_bytes - usb_tx_level;
+}
+
+int putchar_raw(int c)
+{
+    if (stdio_file)
+        fputc(c, stdio_file);
+    usb_tx_drain();
+    if (usb_tx_level < usb_tx_fifo_bytes)
+        usb_tx_level++;
+    if (++usb_packet_bytes == 64)
+    {
+        usb_packet_bytes = 0;
+        irq_busy(now_ns(), irq_model.usb);
+        core_event = true;
+    }
+
+    if (c != 0)
+    {
+        if (usb_frame_length < sizeof(usb_frame))
+            usb_frame[usb_frame_length++] = (uint8_t)c;
+        else
+            usb_frame_overflow = true;
+    }
+    else
+    {
+        if (usb_frame_length && !usb_frame_overflow)
+            usb_frame_decode();
+        usb_frame_length = 0;
+        usb_frame_overflow = false;
+    }
+    return c;
+}
+
+// Bytes enviados pelo "host" da USB (sim_usb_send), lidos pela firmware com getchar
+static uint8_t usb_rx[256];
+static size_t usb_rx_head, usb_rx_tail;
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    uint64_t deadline = sim_now_us() + timeout_us;
+
+    while (usb_rx_head == usb_rx_tail)
+    {
+        if (sim_now_us() >= deadline)
+            return PICO_ERROR_TIMEOUT;
+        // Acorda no próximo evento (que pode ser a chegada de bytes) ou no fim do prazo
+        uint64_t next = deadline;
+        if (heap_size > 0 && heap[0].time_us > sim_now_us() && heap[0].time_us < next)
+            next = heap[0].time_us;
+        sim_wait_until(next);
+    }
+    sim_poll();
+    return usb_rx[usb_rx_tail++ % sizeof(usb_rx)];
+}
+
+void stdio_flush(void)
+{
+    if (stdio_file)
+        fflush(stdio_file);
+}
+
+// A USB simulada fica conectada (a telemetria é decodificada mesmo sem --stdio), a não ser
+// que sim_set_usb_connected simule uma unidade só na bateria
+static bool usb_connected = true;
+
+void sim_set_usb_connected(bool connected)
+{
+    usb_connected = connected;
+    core_event = true;
+}
+
+bool stdio_usb_connected(void)
+{
+    return usb_connected;
+}
+
+// ---------------------------------------------------------------------------------------
+// hardware/structs/rosc.h
+
+// Núcleo que a firmware enxerga em get_core_num; o código simulado roda sempre no 0
+uint sim_core_num;
+
+void sim_set_core(uint core)
+{
+    assert(core < NUM_CORES);
+    sim_core_num = core;
+}
+
+// Bits "aleatórios" do ROSC: splitmix64 sobre a semente, reproduzível entre execuções
+static uint64_t rosc_state = 1;
+static rosc_hw_t rosc_regs;
+
+rosc_hw_t *sim_rosc_hw(void)
+{
+    uint64_t z = (rosc_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    rosc_regs.randombit = (uint32_t)(z ^ (z >> 31)) & 1;
+    return &rosc_regs;
+}
+
+// ---------------------------------------------------------------------------------------
+// Ganchos (sim.h)
+
+void sim_gpio_drive(uint pin, bool level)
+{
+    pins[pin].driven = level;
+    pin_update(pin);
+    emit((sim_event_t){.kind = sim_event_input, .pin = pin, .value = level});
+    sim_poll();
+}
+
+void sim_gpio_release(uint pin)
+{
+    pins[pin].driven = -1;
+    pin_update(pin);
+    emit((sim_event_t){.kind = sim_event_input, .pin = pin, .value = pins[pin].level});
+    sim_poll();
+}
+
+void sim_schedule_input(uint64_t time_us, uint pin, bool level)
+{
+    heap_push((sim_timer_t){.time_us = time_us, .kind = event_input, .pin = pin, .level = level});
+}
+
+bool sim_gpio_output(uint pin)
+{
+    return pins[pin].out_value;
+}
+
+uint16_t sim_pwm_level(uint pin)
+{
+    return slices[pwm_gpio_to_slice_num(pin)].cc[pwm_gpio_to_channel(pin)];
+}
+
+uint16_t sim_pwm_wrap(uint pin)
+{
+    return slices[pwm_gpio_to_slice_num(pin)].top;
+}
+
+bool sim_pwm_enabled(uint pin)
+{
+    return slices[pwm_gpio_to_slice_num(pin)].enabled;
+}
+
+uint32_t sim_pwm_frequency_hz(uint pin)
+{
+    const sim_slice_t *slice = &slices[pwm_gpio_to_slice_num(pin)];
+    uint64_t div = slice->div ? slice->div : 16;
+    return (uint32_t)((uint64_t)clock_hz[clk_sys] * 16 / div / ((uint64_t)slice->top + 1));
+}
+
+void sim_set_observer(sim_observer_t fn, void *user_data)
+{
+    observer = fn;
+    observer_data = user_data;
+}
+
+void sim_schedule_call(uint64_t time_us, sim_call_t call, void *user_data)
+{
+    heap_push((sim_timer_t){.time_us = time_us, .kind = event_call, .call = call, .user_data = user_data});
+}
+
+void sim_usb_send(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length && usb_rx_head - usb_rx_tail < sizeof(usb_rx); i++)
+        usb_rx[usb_rx_head++ % sizeof(usb_rx)] = (uint8_t)data[i];
+    core_event = true; // IRQ da USB na chegada dos bytes
+}
+
+void sim_set_entropy_seed(uint64_t seed)
+{
+    rosc_state = seed;
+}
+
+void sim_set_stdio_file(FILE *file)
+{
+    stdio_file = file;
+}
+
+void sim_set_exit_hook(sim_exit_hook_t hook)
+{
+    exit_hook = hook;
+}
+
+void sim_exit(int status)
+{
+    if (exit_hook)
+        status = exit_hook(status);
+    if (stdio_file)
+        fflush(stdio_file);
+    fflush(stdout);
+    exit(status);
+}
+
+__attribute__((constructor)) static void sim_pins_init(void)
+{
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        pins[gpio].driven = -1;
+        pins[gpio].function = GPIO_FUNC_NULL;
+    }
+}
@@ -0,0 +1,103 @@
+// Ganchos da simulação no host: injeção de entradas e observação das saídas da firmware
+#ifndef sim_h
+#define sim_h
+
+#include <stdio.h>
+#include "pico.h"
+
+// Tipos de evento entregues ao observador
+typedef enum
+{
+    sim_event_input,     // Borda injetada num pino de entrada (pin, value)
+    sim_event_output,    // gpio_put num pino de saída (pin, value)
+    sim_event_pwm,       // Nível de PWM alterado (pin, value = nível, wrap)
+    sim_event_display,   // Quadro novo na GDDRAM do SSD1306 (hash, text)
+    sim_event_panel,     // Display ligado/desligado (value)
+    sim_event_invert,    // Display invertido/normal (value)
+    sim_event_telemetry, // Registro da telemetria USB (value = tipo, record_time_us, a, b)
+} sim_event_kind_t;
+
+typedef struct
+{
+    sim_event_kind_t kind;
+    uint64_t time_us;
+    uint pin;
+    uint32_t value;
+    uint32_t wrap;
+    uint64_t hash;
+    const char *text;
+    uint64_t record_time_us;
+    uint64_t a, b;
+} sim_event_t;
+
+typedef void (*sim_observer_t)(const sim_event_t *event, void *user_data);
+typedef void (*sim_call_t)(void *user_data);
+typedef int (*sim_exit_hook_t)(int status);
+
+// Tempo virtual: avança nas esperas da firmware e em poll_quantum_us a cada leitura do
+// relógio ou dos pinos fora de IRQ (padrão: 10 us)
+uint64_t sim_now_us(void);
+void sim_set_poll_quantum(uint32_t quantum_us);
+
+// Entradas: nível forçado externamente (botões são ativos em 0) ou agendado
+void sim_gpio_drive(uint pin, bool level);
+void sim_gpio_release(uint pin);
+void sim_schedule_input(uint64_t time_us, uint pin, bool level);
+
+// Saídas
+bool sim_gpio_output(uint pin);
+uint16_t sim_pwm_level(uint pin);
+uint16_t sim_pwm_wrap(uint pin);
+uint32_t sim_pwm_frequency_hz(uint pin);
+bool sim_pwm_enabled(uint pin);
+
+// Display: GDDRAM (páginas x 128 colunas), texto reconhecido com a fonte da firmware
+const uint8_t *sim_display_ram(void);
+bool sim_display_on(void);
+uint64_t sim_display_hash(void);
+const char *sim_display_text(void);
+
+// Falhas do display: sem resposta (NACK; ao voltar, o controlador está no estado de reset) ou
+// com o SDA preso em 0 até alguns pulsos no SCL (a recuperação do barramento)
+typedef enum
+{
+    sim_display_ok,
+    sim_display_absent,
+    sim_display_stuck,
+} sim_display_fault_t;
+
+void sim_display_fault(sim_display_fault_t fault);
+
+// Integração com scripts/testes: chamadas agendadas rodam no contexto do "mundo externo",
+// entre as chamadas da firmware à SDK
+void sim_set_observer(sim_observer_t observer, void *user_data);
+void sim_schedule_call(uint64_t time_us, sim_call_t call, void *user_data);
+void sim_set_stdio_file(FILE *file);
+void sim_usb_send(const char *data, size_t length); // Bytes para getchar_timeout_us
+void sim_set_usb_connected(bool connected);         // false: unidade sem host USB
+void sim_set_usb_stalled(bool stalled);             // true: host conectado que parou de ler
+void sim_set_entropy_seed(uint64_t seed);            // Bits do ROSC (hardware/structs/rosc.h)
+void sim_set_core(uint core);                        // Núcleo de get_core_num (testes)
+void sim_exit(int status);
+
+// Modelo de latência de IRQ (sim.c), em ciclos de clk_sys: da borda até o callback de GPIO
+// e quanto cada handler ocupa o núcleo
+typedef struct
+{
+    uint32_t entry;  // Borda até o callback, com o núcleo livre (exceção e despacho da SDK)
+    uint32_t gpio;   // Callback de GPIO
+    uint32_t alarm;  // IRQ do timer e o callback do alarme
+    uint32_t pwm;    // IRQ de wrap do PWM
+    uint32_t dma;    // IRQ do DMA
+    uint32_t usb;    // IRQ da USB, por pacote de 64 bytes de stdio
+    uint32_t masked; // Cada seção com interrupções mascaradas
+    uint32_t core1;  // Disputa máxima pelo barramento com o núcleo 1 rodando
+} sim_irq_model_t;
+
+bool sim_set_irq_model(const char *spec); // "entry=100,alarm=700,..." (false: campo inválido)
+void sim_irq_report(FILE *out);           // Latência modelada de cada GPIO com IRQ
+
+// Chamado por sim_exit; pode trocar o código de saída (ex.: verificações no fim da sessão)
+void sim_set_exit_hook(sim_exit_hook_t hook);
+
+#endif
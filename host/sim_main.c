@@ -0,0 +1,273 @@
+// Ponto de entrada da simulação no host: configura os ganchos e executa a firmware
+//
+// Uso: Ligeirinho [--script roteiro] [--log arquivo] [--stdio arquivo] [--flash arquivo]
+//                 [--duration ms] [--seed n] [--rounds n] [--quantum us]
+//                 [--replay trace.csv] [--golden log] [--irq-model custos] [--irq-report arquivo]
+//
+// Com --golden o log de eventos é comparado linha a linha com um log de referência
+// (gerado antes com --log); qualquer diferença faz o código de saída ser 1.
+//
+// --irq-model troca custos do modelo de latência de IRQ, em ciclos de clk_sys (ex.:
+// "entry=120,usb=2000"; campos em sim.h), e --irq-report grava no fim a latência modelada
+// de cada GPIO com IRQ ("-": na saída de erro).
+//
+// O tempo é virtual (sim.c): a mesma semente e as mesmas entradas reproduzem a sessão
+// inteira, bit a bit, em bem menos tempo que o real.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "sim_script.h"
+#include "sim_player.h"
+#include "sim_replay.h"
+#include "result_log_file.h"
+#include "inc/telemetry.h"
+
+// main() de Ligeirinho.c, renomeada na compilação para o host
+int ligeirinho_main(void);
+
+static FILE *log_file, *golden_file;
+static const char *golden_path;
+static unsigned long log_lines, golden_mismatches;
+
+static const char *record_name(uint32_t type)
+{
+    switch (type)
+    {
+    case telemetry_type_round:
+        return "round";
+    case telemetry_type_input:
+        return "input";
+    case telemetry_type_display:
+        return "display";
+    case telemetry_type_state:
+        return "state";
+    case telemetry_type_boot:
+        return "boot";
+    case telemetry_type_stimulus:
+        return "stimulus";
+    case telemetry_type_latency:
+        return "latency";
+    case telemetry_type_display_bus:
+        return "display_bus";
+    default:
+        return "unknown";
+    }
+}
+
+// Compara uma linha do log com a próxima do log de referência
+static void golden_check(const char *line)
+{
+    char expected[512];
+
+    if (!fgets(expected, sizeof(expected), golden_file))
+        expected[0] = '\0';
+    if (!strcmp(line, expected))
+        return;
+
+    if (golden_mismatches++ == 0)
+        fprintf(stderr, "%s:%lu: esperado: %s%s%s:%lu: obtido:   %s", golden_path, log_lines,
+                expected[0] ? expected : "(fim do arquivo)", expected[0] ? "" : "\n", golden_path, log_lines, line);
+}
+
+static int golden_finish(int status)
+{
+    char extra[512];
+    if (fgets(extra, sizeof(extra), golden_file) && golden_mismatches++ == 0)
+        fprintf(stderr, "%s:%lu: esperado: %s%s: a simulacao terminou antes\n", golden_path, log_lines + 1, extra,
+                golden_path);
+
+    if (golden_mismatches)
+    {
+        fprintf(stderr, "%s: %lu linha(s) diferente(s)\n", golden_path, golden_mismatches);
+        return 1;
+    }
+    return status;
+}
+
+// Registro textual das saídas observadas, uma linha por evento
+static void log_event(const sim_event_t *event, void *user_data)
+{
+    (void)user_data;
+    char line[512];
+
+    switch (event->kind)
+    {
+    case sim_event_input:
+        snprintf(line, sizeof(line), "%" PRIu64 " input %u %u\n", event->time_us, event->pin, event->value);
+        break;
+    case sim_event_output:
+        snprintf(line, sizeof(line), "%" PRIu64 " output %u %u\n", event->time_us, event->pin, event->value);
+        break;
+    case sim_event_pwm:
+        snprintf(line, sizeof(line), "%" PRIu64 " pwm %u %u/%u\n", event->time_us, event->pin, event->value,
+                 event->wrap);
+        break;
+    case sim_event_display:
+        snprintf(line, sizeof(line), "%" PRIu64 " display %016" PRIx64 " \"%s\"\n", event->time_us, event->hash,
+                 event->text);
+        break;
+    case sim_event_panel:
+        snprintf(line, sizeof(line), "%" PRIu64 " panel %s\n", event->time_us, event->value ? "on" : "off");
+        break;
+    case sim_event_invert:
+        snprintf(line, sizeof(line), "%" PRIu64 " panel %s\n", event->time_us, event->value ? "inverse" : "normal");
+        break;
+    case sim_event_telemetry:
+        snprintf(line, sizeof(line), "%" PRIu64 " telemetry %s %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+                 event->time_us, record_name(event->value), event->record_time_us, event->a, event->b);
+        break;
+    }
+
+    log_lines++;
+    if (log_file)
+        fputs(line, log_file);
+    if (golden_file)
+        golden_check(line);
+
+    sim_script_observe(event);
+    sim_player_observe(event);
+    sim_replay_observe(event);
+}
+
+static const char *irq_report_path;
+
+static void irq_report(void)
+{
+    FILE *out = strcmp(irq_report_path, "-") ? fopen(irq_report_path, "w") : stderr;
+    if (!out)
+    {
+        fprintf(stderr, "sim: nao foi possivel criar %s\n", irq_report_path);
+        return;
+    }
+    sim_irq_report(out);
+    if (out != stderr)
+        fclose(out);
+}
+
+static void stop(void *user_data)
+{
+    (void)user_data;
+    sim_exit(sim_script_failures() ? 1 : 0);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "uso: Ligeirinho [--script roteiro] [--log arquivo] [--stdio arquivo] "
+                    "[--flash arquivo] [--duration ms] [--seed n] [--rounds n] [--quantum us] "
+                    "[--replay trace.csv] [--golden log] [--usb on|off|stalled] [--irq-model custos] [--irq-report arquivo]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *script = NULL, *log_path = NULL, *stdio_path = NULL, *flash_path = NULL, *replay = NULL;
+    double duration_ms = 0;
+    uint64_t seed = 1;
+    uint32_t rounds = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+            usage();
+        if (!strcmp(argv[i], "--script"))
+            script = argv[++i];
+        else if (!strcmp(argv[i], "--log"))
+            log_path = argv[++i];
+        else if (!strcmp(argv[i], "--stdio"))
+            stdio_path = argv[++i];
+        else if (!strcmp(argv[i], "--flash"))
+            flash_path = argv[++i];
+        else if (!strcmp(argv[i], "--duration"))
+            duration_ms = strtod(argv[++i], NULL);
+        else if (!strcmp(argv[i], "--seed"))
+            seed = strtoull(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "--rounds"))
+            rounds = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(argv[i], "--quantum"))
+            sim_set_poll_quantum((uint32_t)strtoul(argv[++i], NULL, 10));
+        else if (!strcmp(argv[i], "--replay"))
+            replay = argv[++i];
+        else if (!strcmp(argv[i], "--golden"))
+            golden_path = argv[++i];
+        else if (!strcmp(argv[i], "--usb"))
+        {
+            i++;
+            sim_set_usb_connected(strcmp(argv[i], "off") != 0);
+            sim_set_usb_stalled(!strcmp(argv[i], "stalled"));
+        }
+        else if (!strcmp(argv[i], "--irq-model"))
+        {
+            if (!sim_set_irq_model(argv[++i]))
+                usage();
+        }
+        else if (!strcmp(argv[i], "--irq-report"))
+        {
+            irq_report_path = argv[++i];
+            atexit(irq_report);
+        }
+        else
+            usage();
+    }
+
+    // Com --golden o log só vai para um arquivo se pedido explicitamente
+    log_file = log_path ? fopen(log_path, "w") : golden_path ? NULL : stdout;
+    if (log_path && !log_file)
+    {
+        fprintf(stderr, "sim: nao foi possivel criar %s\n", log_path);
+        return 2;
+    }
+    if (golden_path)
+    {
+        golden_file = fopen(golden_path, "r");
+        if (!golden_file)
+        {
+            fprintf(stderr, "sim: nao foi possivel abrir %s\n", golden_path);
+            return 2;
+        }
+        sim_set_exit_hook(golden_finish);
+    }
+    sim_set_observer(log_event, NULL);
+
+    if (stdio_path)
+    {
+        FILE *stdio_file = fopen(stdio_path, "wb");
+        if (!stdio_file)
+        {
+            fprintf(stderr, "sim: nao foi possivel criar %s\n", stdio_path);
+            return 2;
+        }
+        sim_set_stdio_file(stdio_file);
+    }
+
+    if (flash_path)
+        result_log_file_open(flash_path);
+
+    if (script)
+    {
+        if (!sim_script_load(script))
+            return 2;
+        sim_script_start();
+    }
+
+    // A semente alimenta tanto o ROSC simulado (e, por ele, os sorteios da firmware) quanto
+    // o jogador automático
+    sim_set_entropy_seed(seed);
+    if (rounds)
+        sim_player_start(rounds, seed);
+
+    if (replay)
+    {
+        if (!sim_replay_load(replay))
+            return 2;
+        sim_replay_start();
+    }
+
+    if (duration_ms > 0)
+        sim_schedule_call((uint64_t)(duration_ms * 1000.0), stop, NULL);
+
+    return ligeirinho_main();
+}
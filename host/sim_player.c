@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_player.h"
+
+#define pin_start 5
+#define pin_stop 6
+#define pin_led_red 13
+
+#define hold_us 100000            // Tempo com o botão pressionado
+#define false_start_one_in 25     // Uma queima de largada a cada ~25 rodadas
+#define false_start_after_us 500000 // STOP depois do START, antes do menor atraso (1 s)
+
+typedef enum
+{
+    player_waiting_idle, // Esperando a tela inicial
+    player_armed,        // START pressionado, esperando o LED vermelho
+    player_reacting,     // STOP agendado após o estímulo
+    player_false_start,  // STOP agendado durante a preparação
+} player_state_t;
+
+static player_state_t state;
+static uint32_t rounds_target, rounds_done, false_starts;
+static uint64_t rng_state;
+
+// splitmix64 próprio, para não consumir os sorteios da firmware
+static uint64_t next_random(void)
+{
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t random_us(uint64_t min_us, uint64_t span_us)
+{
+    return min_us + next_random() % span_us;
+}
+
+static void press(uint64_t time_us, uint pin)
+{
+    sim_schedule_input(time_us, pin, false);
+    sim_schedule_input(time_us + hold_us, pin, true);
+}
+
+static void next_round(uint64_t now)
+{
+    uint64_t start = now + random_us(200000, 500000);
+    press(start, pin_start);
+
+    if (next_random() % false_start_one_in == 0)
+    {
+        press(start + false_start_after_us, pin_stop);
+        state = player_false_start;
+        false_starts++;
+    }
+    else
+    {
+        state = player_armed;
+    }
+}
+
+void sim_player_start(uint32_t rounds, uint64_t seed)
+{
+    rounds_target = rounds;
+    // Mesma semente do ROSC simulado, mas deslocada para que as sequências não coincidam
+    rng_state = seed ^ 0xA5A5A5A5A5A5A5A5ull;
+    state = player_waiting_idle;
+}
+
+void sim_player_observe(const sim_event_t *event)
+{
+    if (!rounds_target)
+        return;
+
+    if (event->kind == sim_event_pwm && event->pin == pin_led_red && event->value > 0 && state == player_armed)
+    {
+        // Reação entre 180 e 420 ms, concentrada no meio (soma de dois sorteios)
+        uint64_t reaction = 180000 + random_us(0, 120000) + random_us(0, 120000);
+        press(event->time_us + reaction, pin_stop);
+        state = player_reacting;
+        return;
+    }
+
+    if (event->kind != sim_event_display || !strstr(event->text, "PRESSIONE A"))
+        return;
+
+    if (state != player_waiting_idle)
+        rounds_done++;
+
+    if (rounds_done >= rounds_target)
+    {
+        fprintf(stderr, "sim: %u rodadas (%u queimas de largada) em %.1f s simulados\n", rounds_done,
+                false_starts, event->time_us / 1e6);
+        sim_exit(0);
+    }
+    next_round(event->time_us);
+}
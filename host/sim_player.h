@@ -0,0 +1,17 @@
+// Jogador automático para sessões longas na simulação no host
+#ifndef sim_player_h
+#define sim_player_h
+
+#include "sim.h"
+
+/*
+ * Joga `rounds` rodadas seguidas: pressiona START na tela inicial e, quando o LED
+ * vermelho acende, pressiona STOP após um tempo de reação sorteado. Uma fração das
+ * rodadas é de queimas de largada (STOP durante a preparação). Todos os sorteios vêm de
+ * um gerador próprio inicializado com `seed`, de modo que a mesma semente reproduz a
+ * mesma sessão.
+ */
+void sim_player_start(uint32_t rounds, uint64_t seed);
+void sim_player_observe(const sim_event_t *event);
+
+#endif
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/telemetry.h"
+#include "sim_replay.h"
+
+#define pin_led_green 11
+#define pin_buzzer 21
+
+#define replay_tail_us 10000000     // Depois da última borda: cobre a tela de resultado
+#define replay_deadline_us 60000000 // Folga além do fim do trace antes de desistir
+
+typedef struct
+{
+    uint64_t time_us;
+    uint8_t state;
+    size_t first_edge, edge_count;
+} replay_anchor_t;
+
+typedef struct
+{
+    uint64_t time_us;
+    uint8_t gpio;
+    bool level;
+} replay_edge_t;
+
+static replay_anchor_t *anchors;
+static replay_edge_t *edges;
+static size_t anchor_count, edge_count, leading_edges;
+static size_t next_anchor[telemetry_state_reaction + 1];
+static size_t anchors_with_edges, anchors_reached;
+static uint64_t last_edge_us;
+static bool idle_screen_shown = true; // A tela do boot conta como já mostrada
+static bool foreperiod_open; // O buzzer só marca a reação depois de uma preparação
+static const char *replay_path;
+
+bool sim_replay_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "sim: nao foi possivel abrir o trace %s\n", path);
+        return false;
+    }
+
+    char line[256], record[32];
+    unsigned long long time, a, b;
+    replay_path = path;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        // Cabeçalho e linhas de outros tipos são ignorados
+        if (sscanf(line, "%llu,%31[^,],%llu,%llu", &time, record, &a, &b) != 4)
+            continue;
+
+        if (!strcmp(record, "state") && a <= telemetry_state_reaction)
+        {
+            anchors = realloc(anchors, (anchor_count + 1) * sizeof(*anchors));
+            anchors[anchor_count++] = (replay_anchor_t){.time_us = time, .state = (uint8_t)a, .first_edge = edge_count};
+        }
+        else if (!strcmp(record, "input") && a < 30)
+        {
+            edges = realloc(edges, (edge_count + 1) * sizeof(*edges));
+            edges[edge_count++] = (replay_edge_t){.time_us = time, .gpio = (uint8_t)a, .level = b != 0};
+            if (anchor_count)
+                anchors[anchor_count - 1].edge_count++;
+            else
+                leading_edges++;
+        }
+    }
+    fclose(file);
+
+    if (!edge_count)
+    {
+        fprintf(stderr, "sim: %s nao tem bordas (registros input)\n", path);
+        return false;
+    }
+    last_edge_us = edges[edge_count - 1].time_us;
+    return true;
+}
+
+static void schedule_edges(size_t first, size_t count, uint64_t sim_base_us, uint64_t trace_base_us)
+{
+    for (size_t i = first; i < first + count; i++)
+    {
+        uint64_t time = sim_base_us + (edges[i].time_us - trace_base_us);
+        if (time < sim_now_us())
+            time = sim_now_us();
+        sim_schedule_input(time, edges[i].gpio, edges[i].level);
+    }
+}
+
+static void replay_finish(void *user_data)
+{
+    (void)user_data;
+    sim_exit(0);
+}
+
+static void replay_timeout(void *user_data)
+{
+    (void)user_data;
+    fprintf(stderr, "%s: a simulacao divergiu; %zu de %zu ancoras com bordas alcancadas\n", replay_path,
+            anchors_reached, anchors_with_edges);
+    sim_exit(1);
+}
+
+// Todas as bordas agendadas: encerra depois da última, mais a cauda
+static void check_done(uint64_t last_scheduled_us)
+{
+    if (anchors_reached == anchors_with_edges)
+        sim_schedule_call(last_scheduled_us + replay_tail_us, replay_finish, NULL);
+}
+
+void sim_replay_start(void)
+{
+    for (size_t i = 0; i < anchor_count; i++)
+        anchors_with_edges += anchors[i].edge_count > 0;
+
+    schedule_edges(0, leading_edges, 0, 0);
+    sim_schedule_call(last_edge_us + replay_deadline_us, replay_timeout, NULL);
+    if (leading_edges)
+        check_done(edges[leading_edges - 1].time_us);
+}
+
+// Próxima âncora do estado indicado; casa a ocorrência na simulação com a do trace
+static void anchor_reached(uint8_t state, uint64_t time_us)
+{
+    size_t i = next_anchor[state];
+    while (i < anchor_count && anchors[i].state != state)
+        i++;
+    if (i >= anchor_count)
+        return;
+    next_anchor[state] = i + 1;
+
+    const replay_anchor_t *anchor = &anchors[i];
+    if (!anchor->edge_count)
+        return;
+
+    schedule_edges(anchor->first_edge, anchor->edge_count, time_us, anchor->time_us);
+    anchors_reached++;
+    check_done(time_us + (edges[anchor->first_edge + anchor->edge_count - 1].time_us - anchor->time_us));
+}
+
+void sim_replay_observe(const sim_event_t *event)
+{
+    if (!edges)
+        return;
+
+    if (event->kind == sim_event_pwm && event->value > 0 && event->pin == pin_led_green)
+    {
+        anchor_reached(telemetry_state_foreperiod, event->time_us);
+        foreperiod_open = true;
+    }
+    else if (event->kind == sim_event_pwm && event->value > 0 && event->pin == pin_buzzer && foreperiod_open)
+    {
+        // A melodia da queima de largada começa com o LED verde ainda aceso; o estímulo, depois
+        // de apagá-lo. O primeiro som após a preparação decide qual dos dois foi
+        foreperiod_open = false;
+        if (sim_pwm_level(pin_led_green) == 0)
+            anchor_reached(telemetry_state_reaction, event->time_us);
+    }
+    else if (event->kind == sim_event_display)
+    {
+        // Só a volta à tela inicial é uma transição: a do boot (enviada página por página) e
+        // as trocas de jogadores não têm correspondente no trace
+        bool idle_screen = strstr(event->text, "PRESSIONE A") != NULL;
+        if (idle_screen && !idle_screen_shown)
+            anchor_reached(telemetry_state_idle, event->time_us);
+        idle_screen_shown = idle_screen;
+    }
+}
@@ -0,0 +1,25 @@
+// Replay de sessões capturadas na placa (bordas dos botões) na simulação no host
+#ifndef sim_replay_h
+#define sim_replay_h
+
+#include "sim.h"
+
+/*
+ * A entrada é o CSV de tools/telemetry_decode (time_us,record,a,b) capturado da placa; só
+ * os registros input (bordas, com bounce) e state (âncoras) são usados.
+ *
+ * Cada borda é reinjetada relativa à última transição de estado que a precede no trace,
+ * casada com o momento equivalente da simulação: preparação <-> LED verde aceso,
+ * reação <-> buzzer ligado com o LED verde já apagado (a melodia da queima de largada
+ * começa antes de apagá-lo), ocioso <-> tela inicial redesenhada. Assim o tempo de reação e
+ * o bounce são preservados mesmo que a simulação perceba o botão A alguns ms antes ou
+ * depois da placa. Bordas anteriores à primeira âncora usam o tempo absoluto do trace.
+ *
+ * A sessão termina 10 s depois da última borda (código 0), ou com código 1 se a simulação
+ * divergir e uma âncora com bordas não for alcançada.
+ */
+bool sim_replay_load(const char *path);
+void sim_replay_start(void);
+void sim_replay_observe(const sim_event_t *event);
+
+#endif
@@ -0,0 +1,299 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_script.h"
+
+typedef enum
+{
+    op_at,
+    op_wait_output,
+    op_wait_display,
+    op_press,
+    op_release,
+    op_expect_output,
+    op_expect_display,
+    op_send,
+    op_display,
+    op_quit,
+} script_op_t;
+
+typedef struct
+{
+    script_op_t op;
+    int line;
+    bool relative;
+    uint64_t time_us;
+    uint pin;
+    bool on;
+    sim_display_fault_t fault;
+    char text[64];
+} script_command_t;
+
+static script_command_t *commands;
+static size_t command_count, pc;
+static uint64_t anchor_us;
+static bool waiting;
+static int failures;
+static const char *script_path;
+
+static const struct
+{
+    const char *name;
+    uint pin;
+} pin_names[] = {
+    {"START", 5}, {"STOP", 6}, {"LED_GREEN", 11}, {"LED_RED", 13}, {"BUZZER", 21},
+    {"J1", 6}, {"J2", 22}, {"J3", 16}, {"J4", 17},
+};
+
+static bool parse_pin(const char *token, uint *pin)
+{
+    for (size_t i = 0; i < count_of(pin_names); i++)
+    {
+        if (!strcmp(token, pin_names[i].name))
+        {
+            *pin = pin_names[i].pin;
+            return true;
+        }
+    }
+
+    char *end;
+    unsigned long value = strtoul(token, &end, 10);
+    if (*token == '\0' || *end != '\0' || value >= 30)
+        return false;
+    *pin = (uint)value;
+    return true;
+}
+
+// Extrai o texto entre aspas depois do comando
+static bool parse_quoted(const char *rest, char *out, size_t size)
+{
+    const char *open = strchr(rest, '"');
+    const char *close = open ? strchr(open + 1, '"') : NULL;
+    if (!close || (size_t)(close - open - 1) >= size)
+        return false;
+
+    memcpy(out, open + 1, close - open - 1);
+    out[close - open - 1] = '\0';
+    return true;
+}
+
+static bool parse_line(char *line, script_command_t *command)
+{
+    char word[16], arg[32], state[8];
+    int consumed = 0;
+
+    if (sscanf(line, "%15s%n", word, &consumed) != 1)
+        return false;
+    char *rest = line + consumed;
+
+    if (!strcmp(word, "at"))
+    {
+        if (sscanf(rest, "%31s", arg) != 1)
+            return false;
+        command->op = op_at;
+        command->relative = arg[0] == '+';
+        command->time_us = (uint64_t)(strtod(arg + command->relative, NULL) * 1000.0 + 0.5);
+        return true;
+    }
+    if (!strcmp(word, "press") || !strcmp(word, "release"))
+    {
+        command->op = word[0] == 'p' ? op_press : op_release;
+        return sscanf(rest, "%31s", arg) == 1 && parse_pin(arg, &command->pin);
+    }
+    if (!strcmp(word, "wait") || !strcmp(word, "expect"))
+    {
+        bool wait = word[0] == 'w';
+        if (sscanf(rest, "%31s", arg) != 1)
+            return false;
+
+        if (!strcmp(arg, "display"))
+        {
+            command->op = wait ? op_wait_display : op_expect_display;
+            return parse_quoted(rest, command->text, sizeof(command->text));
+        }
+
+        command->op = wait ? op_wait_output : op_expect_output;
+        if (sscanf(rest, "%31s %7s", arg, state) != 2 || !parse_pin(arg, &command->pin))
+            return false;
+        command->on = !strcmp(state, "on");
+        return command->on || !strcmp(state, "off");
+    }
+    if (!strcmp(word, "send"))
+    {
+        command->op = op_send;
+        return parse_quoted(rest, command->text, sizeof(command->text));
+    }
+    if (!strcmp(word, "display"))
+    {
+        static const char *const faults[] = {"ok", "absent", "stuck"};
+
+        command->op = op_display;
+        if (sscanf(rest, "%31s", arg) != 1)
+            return false;
+        for (size_t i = 0; i < count_of(faults); i++)
+        {
+            if (!strcmp(arg, faults[i]))
+            {
+                command->fault = (sim_display_fault_t)i;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (!strcmp(word, "quit"))
+    {
+        command->op = op_quit;
+        return true;
+    }
+    return false;
+}
+
+bool sim_script_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "sim: nao foi possivel abrir o roteiro %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int number = 0;
+    bool ok = true;
+    script_path = path;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        number++;
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+
+        char *p = line;
+        while (isspace((unsigned char)*p))
+            p++;
+        if (*p == '\0')
+            continue;
+
+        script_command_t command = {.line = number};
+        if (!parse_line(p, &command))
+        {
+            fprintf(stderr, "%s:%d: comando invalido\n", path, number);
+            ok = false;
+            continue;
+        }
+
+        commands = realloc(commands, (command_count + 1) * sizeof(*commands));
+        commands[command_count++] = command;
+    }
+
+    fclose(file);
+    return ok;
+}
+
+static bool output_on(uint pin)
+{
+    return sim_pwm_level(pin) > 0 || sim_gpio_output(pin);
+}
+
+static bool condition_met(const script_command_t *command)
+{
+    if (command->op == op_wait_display || command->op == op_expect_display)
+        return strstr(sim_display_text(), command->text) != NULL;
+    return output_on(command->pin) == command->on;
+}
+
+static void fail(const script_command_t *command)
+{
+    failures++;
+    if (command->op == op_expect_display)
+        fprintf(stderr, "%s:%d: display \"%s\" nao contem \"%s\"\n", script_path, command->line,
+                sim_display_text(), command->text);
+    else
+        fprintf(stderr, "%s:%d: saida %u deveria estar %s\n", script_path, command->line,
+                command->pin, command->on ? "on" : "off");
+}
+
+// Executa comandos até precisar esperar por tempo ou por uma condição
+static void script_step(void *user_data)
+{
+    (void)user_data;
+
+    while (pc < command_count)
+    {
+        const script_command_t *command = &commands[pc];
+        uint64_t now = sim_now_us();
+
+        switch (command->op)
+        {
+        case op_at:
+        {
+            uint64_t target = command->relative ? anchor_us + command->time_us : command->time_us;
+            if (target > now)
+            {
+                sim_schedule_call(target, script_step, NULL);
+                return;
+            }
+            anchor_us = target;
+            break;
+        }
+        case op_wait_output:
+        case op_wait_display:
+            if (!condition_met(command))
+            {
+                waiting = true;
+                return;
+            }
+            anchor_us = now;
+            break;
+        case op_press:
+            sim_gpio_drive(command->pin, false);
+            break;
+        case op_release:
+            sim_gpio_release(command->pin);
+            break;
+        case op_expect_output:
+        case op_expect_display:
+            if (!condition_met(command))
+                fail(command);
+            break;
+        case op_send:
+            sim_usb_send(command->text, strlen(command->text));
+            break;
+        case op_display:
+            sim_display_fault(command->fault);
+            break;
+        case op_quit:
+            sim_exit(failures ? 1 : 0);
+            return;
+        }
+        pc++;
+    }
+
+    sim_exit(failures ? 1 : 0);
+}
+
+void sim_script_start(void)
+{
+    sim_schedule_call(0, script_step, NULL);
+}
+
+// Retoma o roteiro quando a condição de um wait é satisfeita
+void sim_script_observe(const sim_event_t *event)
+{
+    if (!waiting || pc >= command_count || !condition_met(&commands[pc]))
+        return;
+
+    // O ponto de sincronismo é o próprio evento, mesmo que a condição mude logo depois
+    waiting = false;
+    anchor_us = event->time_us;
+    pc++;
+    sim_schedule_call(event->time_us, script_step, NULL);
+}
+
+int sim_script_failures(void)
+{
+    return failures;
+}
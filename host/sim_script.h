@@ -0,0 +1,33 @@
+// Roteiros de entrada/verificação para a simulação no host
+#ifndef sim_script_h
+#define sim_script_h
+
+#include "sim.h"
+
+/*
+ * Um comando por linha ('#' inicia comentário); tempos em ms (aceitam fração):
+ *
+ *   at 500                 espera até 500 ms desde o boot
+ *   at +250                espera 250 ms a partir do último ponto de sincronismo
+ *   wait LED_RED on        espera a saída ligar (PWM > 0 ou nível alto); vira o novo ponto
+ *   wait display "TEMPO"   espera um quadro cujo texto contenha o trecho
+ *   press STOP             botão pressionado (nível 0); release solta (volta ao pull-up)
+ *   expect display "TEMPO" falha se o texto atual não contiver o trecho
+ *   expect LED_RED off     falha se a saída não estiver no estado indicado
+ *   send "T"               envia os bytes à firmware pela USB (getchar)
+ *   display stuck          falha no display: absent (sem resposta; volta no estado de
+ *                          reset), stuck (SDA preso em 0 até pulsos no SCL) ou ok
+ *   quit                   encerra (código 1 se alguma verificação falhou)
+ *
+ * Pinos aceitam número de GPIO ou os nomes da BitDogLab: START, STOP, LED_GREEN,
+ * LED_RED, BUZZER, e os botões do multijogador J1 (= STOP), J2, J3 e J4. Tempos
+ * fracionários dão resolução de µs (ex.: "at +0.003"), o que permite testar pressões
+ * quase simultâneas.
+ */
+
+bool sim_script_load(const char *path);
+void sim_script_start(void);
+void sim_script_observe(const sim_event_t *event);
+int sim_script_failures(void);
+
+#endif
@@ -0,0 +1,174 @@
+#include <string.h>
+#include "anim.h"
+#include "ssd1306.h"
+#include "hal.h"
+#include "telemetry.h"
+
+/**
+ * @brief Aplica um quadro codificado ao quadro atual.
+ *
+ * @param length Bytes disponíveis a partir de delta.
+ * @param spans  Recebe as colunas alteradas de cada página.
+ * @return Bytes consumidos, ou 0 se o quadro estiver truncado ou sair da tela.
+ */
+size_t anim_apply(uint8_t *frame, const uint8_t *delta, size_t length, anim_span_t spans[ssd1306_n_pages])
+{
+    for (uint32_t page = 0; page < ssd1306_n_pages; page++)
+    {
+        spans[page] = (anim_span_t){.first = 0xFF, .last = 0};
+    }
+    if (length == 0)
+        return 0;
+
+    size_t pos = 0;
+    uint8_t pages = delta[pos++];
+    for (uint32_t page = 0; page < ssd1306_n_pages; page++)
+    {
+        if (!(pages & (1u << page)))
+            continue;
+
+        uint8_t *row = frame + page * ssd1306_width;
+        unsigned column = 0;
+        while (true)
+        {
+            if (pos >= length)
+                return 0;
+            uint8_t op = delta[pos++];
+            if (op == anim_op_end)
+                break;
+
+            bool copy = op & anim_op_copy;
+            if (!copy && !(op & anim_op_repeat))
+            {
+                column += op;
+                continue;
+            }
+
+            unsigned count = copy ? (op & 0x7Fu) + 1 : (op & 0x3Fu) + 1;
+            if (column + count > ssd1306_width || pos + (copy ? count : 1) > length)
+                return 0;
+            if (copy)
+            {
+                memcpy(row + column, delta + pos, count);
+                pos += count;
+            }
+            else
+            {
+                memset(row + column, delta[pos++], count);
+            }
+
+            if (column < spans[page].first)
+                spans[page].first = column;
+            spans[page].last = column + count - 1;
+            column += count;
+        }
+    }
+    return pos;
+}
+
+// Comandos de endereçamento de cada área enviada (colunas e páginas), em bytes no barramento
+#define anim_area_overhead 12
+
+// Envia as faixas alteradas (uma área por página) ou o quadro inteiro; retorna os bytes de dados
+static uint32_t anim_flush(anim_player_t *player, const anim_span_t *spans, bool full)
+{
+    // Quando as faixas cobrem quase a tela toda, um quadro inteiro sai mais barato
+    uint32_t cost = 0;
+    for (uint32_t page = 0; page < ssd1306_n_pages; page++)
+    {
+        if (spans[page].first <= spans[page].last)
+            cost += spans[page].last - spans[page].first + 1 + anim_area_overhead;
+    }
+    full = full || cost >= ssd1306_buffer_length + anim_area_overhead;
+
+    struct render_area area = {.start_column = 0, .end_column = ssd1306_width - 1, .start_page = 0,
+                               .end_page = ssd1306_n_pages - 1};
+    if (full)
+    {
+        calculate_render_area_buffer_length(&area);
+        render_on_display(player->frame_buffer, &area);
+        return area.buffer_length;
+    }
+
+    uint32_t bytes = 0;
+    for (uint32_t page = 0; page < ssd1306_n_pages; page++)
+    {
+        if (spans[page].first > spans[page].last)
+            continue;
+
+        area.start_column = spans[page].first;
+        area.end_column = spans[page].last;
+        area.start_page = area.end_page = page;
+        calculate_render_area_buffer_length(&area);
+        render_on_display(player->frame_buffer + page * ssd1306_width + spans[page].first, &area);
+        bytes += area.buffer_length;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Começa um clipe: o primeiro quadro sai inteiro no próximo anim_service, apagando o
+ * que havia na tela; os seguintes, só as faixas alteradas.
+ *
+ * O clipe precisa continuar válido até o fim (fica na flash).
+ */
+void anim_start(anim_player_t *player, const anim_clip_t *clip, uint32_t now_ms)
+{
+    memset(player->frame_buffer, 0, sizeof(player->frame_buffer));
+    player->offset = 0;
+    player->frame = 0;
+    player->next_ms = now_ms;
+    player->clip = clip->frames ? clip : NULL;
+}
+
+/**
+ * @brief Mostra o próximo quadro quando chega a hora (laço principal).
+ *
+ * Cada quadro vai para a telemetria como um envio ao display (duração e bytes). Se um envio
+ * atrasar o seguinte, o ritmo recomeça a partir dele, sem pular quadros.
+ *
+ * @return false quando o clipe terminou (o último quadro ficou frame_ms na tela), foi
+ *         parado ou está malformado; a tela fica com o último quadro enviado.
+ */
+bool anim_service(anim_player_t *player, uint32_t now_ms)
+{
+    const anim_clip_t *clip = player->clip;
+    if (!clip)
+        return false;
+    if ((int32_t)(now_ms - player->next_ms) < 0)
+        return true;
+    if (player->frame == clip->frames)
+    {
+        player->clip = NULL;
+        return false;
+    }
+
+    anim_span_t spans[ssd1306_n_pages];
+    size_t used = anim_apply(player->frame_buffer, clip->data + player->offset, clip->length - player->offset, spans);
+    if (used == 0)
+    {
+        player->clip = NULL;
+        return false;
+    }
+
+    uint64_t flush_start = hal_time_us();
+    uint32_t bytes = anim_flush(player, spans, player->frame == 0);
+    telemetry_push_at(flush_start, telemetry_type_display, (uint32_t)(hal_time_us() - flush_start), bytes);
+
+    player->offset += used;
+    player->frame++;
+    player->next_ms += clip->frame_ms;
+    if ((int32_t)(now_ms - player->next_ms) >= 0)
+        player->next_ms = now_ms + clip->frame_ms;
+    return true;
+}
+
+void anim_stop(anim_player_t *player)
+{
+    player->clip = NULL;
+}
+
+bool anim_playing(const anim_player_t *player)
+{
+    return player->clip != NULL;
+}
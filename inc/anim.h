@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ssd1306_i2c.h"
+
+#ifndef anim_h
+#define anim_h
+
+/*
+ * Animações no display a partir da flash. Cada quadro é guardado como a diferença para o
+ * anterior (o primeiro, para a tela apagada), página a página, com repetições codificadas.
+ * O player aplica a diferença ao próprio quadro e envia só a faixa de colunas alterada de
+ * cada página: um quadro com pouca mudança custa poucos bytes no barramento de 400 kHz, em
+ * vez dos 1024 de um quadro inteiro (~23 ms). Roda no laço principal (anim_service), nunca
+ * em IRQ, e a firmware só a chama fora da preparação e da reação: a captura não muda.
+ *
+ * Um quadro é um byte com as páginas alteradas (bit n: página n) e, para cada uma delas, em
+ * ordem, operações sobre as colunas a partir da 0, até 0x00:
+ *
+ *   00LLLLLL (L > 0)    pula L colunas (sem mudança)
+ *   01LLLLLL v          repete o byte v em L + 1 colunas
+ *   1LLLLLLL v0 .. vL   copia L + 1 bytes
+ *
+ * Os clipes são gerados por tools/anim_encode a partir de uma sequência de PNGs de 128 colunas.
+ * anim_apply não depende da SDK.
+ */
+
+#define anim_op_end 0x00
+#define anim_op_skip 0x00   // | L (1 a 63)
+#define anim_op_repeat 0x40 // | (L - 1), L de 1 a 64
+#define anim_op_copy 0x80   // | (L - 1), L de 1 a 128
+
+typedef struct
+{
+  uint16_t frames;
+  uint16_t frame_ms;   // Tempo de cada quadro na tela (o último também)
+  uint32_t length;     // Bytes em data
+  const uint8_t *data; // Quadros codificados, em sequência
+} anim_clip_t;
+
+/**
+ * @brief Colunas alteradas de uma página por anim_apply (first > last: nenhuma).
+ */
+typedef struct
+{
+  uint8_t first, last;
+} anim_span_t;
+
+typedef struct
+{
+  const anim_clip_t *clip; // NULL: parado
+  uint32_t offset;         // Próximo quadro em clip->data
+  uint16_t frame;          // Quadros já mostrados
+  uint32_t next_ms;        // Instante do próximo quadro (ou do fim, depois do último)
+  uint8_t frame_buffer[ssd1306_buffer_length];
+} anim_player_t;
+
+size_t anim_apply(uint8_t *frame, const uint8_t *delta, size_t length, anim_span_t spans[ssd1306_n_pages]);
+void anim_start(anim_player_t *player, const anim_clip_t *clip, uint32_t now_ms);
+bool anim_service(anim_player_t *player, uint32_t now_ms);
+void anim_stop(anim_player_t *player);
+bool anim_playing(const anim_player_t *player);
+
+#endif
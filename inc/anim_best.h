@@ -0,0 +1,133 @@
+// Gerado por tools/anim_encode a partir de 14 quadros (recorde_00.png ...)
+#include "inc/anim.h"
+
+static const uint8_t anim_best_data[1927] = {
+    60, 63, 4, 130, 64, 224, 64, 0, 47, 130, 32, 112, 32, 11, 66, 128,
+    128, 224, 66, 128, 0, 62, 132, 13, 7, 3, 7, 13, 11, 130, 4, 14,
+    4, 0, 58, 130, 2, 7, 2, 0, 60, 52, 130, 8, 28, 8, 12, 66,
+    0, 0, 47, 66, 0, 9, 129, 32, 96, 66, 224, 130, 240, 248, 240, 66,
+    128, 12, 130, 2, 7, 2, 0, 43, 130, 64, 224, 64, 13, 129, 16, 28,
+    67, 15, 133, 31, 63, 3, 3, 1, 1, 7, 66, 0, 0, 58, 66, 0,
+    12, 130, 16, 56, 16, 0, 126, 63, 8, 130, 64, 224, 64, 0, 52, 66,
+    0, 0, 35, 130, 4, 14, 4, 20, 129, 12, 60, 66, 248, 133, 240, 240,
+    248, 252, 254, 255, 13, 66, 0, 0, 43, 66, 0, 10, 135, 16, 24, 30,
+    31, 31, 15, 31, 63, 66, 255, 129, 15, 15, 66, 7, 129, 6, 4, 16,
+    130, 32, 112, 32, 0, 63, 2, 128, 3, 7, 66, 0, 0, 54, 130, 2,
+    7, 2, 0, 126, 46, 130, 16, 56, 16, 22, 66, 0, 0, 58, 130, 224,
+    192, 128, 11, 128, 128, 21, 130, 32, 112, 32, 0, 35, 66, 0, 19, 129,
+    128, 192, 66, 255, 138, 254, 254, 252, 248, 252, 252, 254, 254, 127, 15, 1,
+    0, 52, 130, 4, 4, 14, 67, 15, 129, 31, 31, 68, 255, 128, 127, 67,
+    63, 132, 62, 60, 56, 48, 32, 14, 66, 0, 0, 31, 130, 4, 14, 4,
+    28, 131, 15, 15, 7, 1, 0, 54, 66, 0, 22, 130, 8, 28, 8, 0,
+    255, 63, 12, 130, 128, 192, 128, 0, 46, 66, 0, 27, 128, 1, 0, 24,
+    128, 128, 33, 133, 128, 128, 254, 252, 240, 224, 68, 192, 131, 128, 128, 0,
+    0, 21, 66, 0, 0, 23, 130, 1, 3, 1, 23, 66, 128, 134, 192, 192,
+    240, 252, 238, 247, 243, 3, 67, 255, 130, 254, 252, 252, 66, 255, 133, 254,
+    254, 255, 7, 3, 1, 0, 50, 135, 1, 1, 3, 3, 31, 127, 231, 207,
+    66, 255, 5, 69, 255, 131, 252, 254, 223, 0, 26, 130, 128, 192, 128, 0,
+    31, 66, 0, 23, 135, 1, 3, 127, 63, 15, 7, 7, 5, 67, 6, 131,
+    3, 3, 1, 1, 66, 3, 128, 4, 26, 128, 1, 0, 51, 128, 128, 27,
+    66, 0, 0, 50, 130, 1, 3, 1, 0, 255, 40, 130, 32, 112, 32, 32,
+    66, 0, 0, 63, 1, 128, 192, 11, 128, 0, 0, 24, 128, 0, 26, 139,
+    128, 192, 224, 112, 56, 24, 12, 12, 6, 134, 230, 254, 66, 255, 139, 254,
+    230, 134, 6, 12, 12, 24, 56, 112, 224, 192, 128, 27, 130, 4, 14, 4,
+    0, 23, 66, 0, 21, 133, 8, 24, 252, 254, 127, 253, 69, 252, 128, 254,
+    6, 66, 255, 70, 252, 133, 253, 127, 254, 252, 12, 4, 0, 49, 136, 63,
+    254, 192, 0, 1, 3, 131, 255, 255, 14, 135, 255, 131, 1, 1, 0, 192,
+    254, 63, 22, 66, 0, 0, 20, 130, 32, 112, 32, 28, 154, 3, 7, 14,
+    124, 127, 63, 127, 127, 207, 207, 199, 195, 195, 129, 195, 195, 199, 199, 207,
+    127, 127, 63, 63, 124, 142, 7, 3, 25, 128, 0, 0, 51, 128, 0, 0,
+    50, 66, 0, 32, 130, 4, 14, 4, 0, 255, 40, 66, 0, 36, 130, 1,
+    3, 1, 0, 52, 133, 128, 128, 192, 192, 96, 96, 69, 48, 130, 16, 48,
+    48, 66, 240, 134, 48, 96, 96, 192, 192, 128, 128, 0, 11, 130, 32, 112,
+    32, 32, 137, 224, 240, 248, 252, 206, 199, 195, 193, 192, 192, 68, 128, 132,
+    192, 224, 240, 252, 254, 68, 255, 128, 192, 66, 0, 135, 1, 3, 7, 14,
+    28, 56, 240, 192, 22, 66, 0, 0, 44, 136, 252, 255, 3, 0, 1, 3,
+    7, 31, 63, 70, 255, 9, 66, 255, 128, 252, 66, 248, 66, 240, 66, 224,
+    130, 195, 255, 252, 0, 44, 130, 127, 254, 128, 67, 0, 132, 128, 224, 248,
+    255, 255, 17, 139, 31, 31, 15, 15, 7, 7, 3, 3, 1, 129, 254, 127,
+    0, 20, 66, 0, 22, 137, 1, 7, 30, 56, 120, 254, 223, 159, 31, 31,
+    66, 15, 66, 7, 133, 3, 3, 15, 31, 63, 127, 69, 255, 66, 0, 135,
+    128, 192, 224, 112, 56, 30, 7, 1, 30, 130, 4, 14, 4, 0, 51, 134,
+    1, 3, 3, 6, 6, 12, 12, 69, 24, 128, 16, 66, 24, 137, 25, 27,
+    31, 15, 31, 6, 6, 3, 3, 1, 0, 47, 128, 128, 37, 66, 0, 0,
+    255, 35, 128, 1, 21, 78, 128, 7, 66, 0, 0, 45, 137, 128, 192, 224,
+    112, 56, 24, 12, 14, 6, 6, 66, 3, 69, 1, 128, 0, 69, 1, 140,
+    3, 131, 195, 230, 6, 14, 12, 24, 56, 112, 224, 192, 128, 32, 130, 64,
+    224, 64, 0, 11, 66, 0, 26, 134, 128, 240, 120, 30, 7, 3, 1, 66,
+    0, 137, 14, 60, 252, 252, 248, 248, 240, 240, 224, 224, 68, 192, 133, 224,
+    240, 248, 252, 252, 254, 66, 255, 128, 1, 70, 0, 134, 1, 3, 7, 30,
+    120, 240, 128, 0, 39, 130, 254, 255, 3, 73, 0, 130, 1, 7, 191, 17,
+    134, 255, 247, 224, 192, 192, 128, 128, 71, 0, 130, 3, 255, 254, 0, 39,
+    130, 255, 254, 128, 68, 0, 134, 128, 192, 224, 240, 252, 254, 255, 18, 68,
+    127, 66, 63, 137, 62, 30, 28, 24, 24, 16, 0, 128, 254, 255, 0, 40,
+    133, 3, 31, 60, 240, 192, 130, 72, 3, 68, 1, 130, 3, 15, 63, 69,
+    255, 131, 127, 7, 0, 0, 3, 70, 0, 133, 128, 192, 240, 60, 31, 3,
+    25, 66, 0, 0, 9, 130, 2, 7, 2, 32, 138, 1, 3, 7, 14, 28,
+    56, 48, 96, 224, 192, 192, 66, 128, 69, 0, 134, 1, 7, 31, 63, 3,
+    0, 0, 66, 128, 138, 192, 192, 224, 96, 48, 56, 28, 14, 7, 3, 1,
+    0, 47, 128, 0, 7, 129, 1, 1, 70, 3, 128, 2, 70, 3, 129, 1,
+    1, 0, 255, 35, 128, 0, 10, 135, 128, 128, 192, 224, 96, 112, 48, 48,
+    66, 24, 70, 12, 128, 4, 70, 12, 66, 24, 135, 48, 48, 112, 96, 224,
+    192, 128, 128, 0, 39, 136, 192, 224, 112, 56, 12, 6, 7, 3, 1, 69,
+    0, 129, 192, 128, 88, 0, 136, 1, 3, 7, 6, 12, 56, 112, 224, 192,
+    26, 66, 0, 0, 129, 28, 8, 33, 132, 192, 248, 62, 15, 3, 70, 0,
+    3, 67, 0, 128, 15, 66, 255, 141, 254, 252, 248, 248, 240, 224, 192, 128,
+    192, 192, 224, 224, 240, 240, 66, 248, 131, 252, 252, 30, 6, 3, 70, 0,
+    132, 3, 15, 62, 248, 192, 0, 34, 130, 254, 255, 1, 68, 0, 9, 131,
+    128, 192, 192, 224, 18, 130, 255, 191, 7, 66, 0, 8, 68, 0, 130, 1,
+    255, 254, 0, 34, 129, 255, 254, 3, 67, 0, 135, 16, 16, 24, 60, 60,
+    62, 63, 63, 68, 127, 16, 67, 255, 134, 254, 252, 248, 240, 224, 192, 128,
+    70, 0, 3, 129, 254, 255, 0, 35, 132, 7, 63, 248, 224, 128, 81, 0,
+    129, 3, 63, 66, 255, 3, 130, 63, 15, 7, 74, 1, 66, 3, 128, 2,
+    68, 0, 132, 128, 224, 248, 63, 7, 33, 128, 16, 0, 9, 66, 0, 26,
+    136, 1, 7, 14, 28, 56, 96, 192, 192, 128, 76, 0, 132, 1, 31, 31,
+    15, 3, 80, 0, 136, 128, 192, 192, 96, 56, 28, 14, 7, 1, 0, 45,
+    136, 1, 3, 3, 6, 14, 12, 28, 24, 24, 66, 48, 70, 96, 128, 64,
+    70, 96, 66, 48, 136, 24, 24, 28, 12, 14, 6, 3, 3, 1, 0, 255,
+    46, 100, 0, 0, 39, 72, 0, 6, 67, 0, 131, 224, 240, 224, 128, 19,
+    72, 0, 0, 129, 0, 0, 33, 68, 0, 14, 66, 0, 128, 224, 68, 255,
+    131, 254, 248, 240, 224, 68, 128, 68, 192, 67, 224, 128, 96, 7, 68, 0,
+    0, 34, 66, 0, 6, 129, 128, 128, 66, 192, 66, 224, 129, 240, 240, 66,
+    248, 128, 252, 17, 133, 255, 127, 63, 15, 7, 3, 12, 66, 0, 0, 34,
+    129, 0, 0, 7, 140, 0, 0, 1, 1, 3, 3, 7, 7, 15, 15, 31,
+    31, 63, 19, 130, 248, 224, 128, 68, 0, 10, 129, 0, 0, 0, 35, 68,
+    0, 16, 69, 255, 134, 127, 63, 31, 15, 7, 3, 3, 66, 7, 66, 15,
+    66, 31, 130, 30, 60, 48, 66, 0, 5, 68, 0, 33, 128, 0, 0, 128,
+    32, 37, 72, 0, 10, 131, 15, 7, 3, 1, 67, 0, 17, 72, 0, 0,
+    45, 102, 0, 0, 126, 58, 67, 0, 131, 128, 240, 248, 224, 0, 57, 132,
+    0, 0, 192, 240, 254, 68, 255, 130, 252, 240, 128, 75, 0, 0, 43, 134,
+    0, 4, 12, 12, 28, 60, 126, 72, 254, 12, 70, 254, 134, 126, 126, 62,
+    30, 14, 6, 2, 0, 45, 69, 0, 132, 1, 1, 3, 199, 255, 18, 131,
+    199, 3, 1, 0, 0, 52, 129, 128, 248, 66, 255, 147, 127, 63, 63, 31,
+    15, 15, 7, 3, 7, 15, 15, 31, 31, 63, 63, 127, 255, 255, 252, 192,
+    67, 0, 0, 128, 0, 51, 130, 3, 1, 1, 69, 0, 14, 130, 1, 1,
+    2, 0, 126, 62, 67, 0, 131, 128, 192, 224, 248, 0, 46, 130, 32, 96,
+    224, 69, 192, 69, 128, 132, 192, 224, 240, 252, 254, 68, 255, 128, 128, 0,
+    44, 67, 0, 132, 1, 3, 15, 31, 63, 69, 255, 12, 129, 255, 252, 66,
+    248, 66, 240, 66, 224, 66, 192, 128, 64, 0, 51, 131, 128, 224, 248, 253,
+    18, 137, 31, 31, 15, 15, 7, 7, 3, 3, 1, 1, 0, 48, 131, 96,
+    56, 62, 63, 66, 31, 66, 15, 66, 7, 134, 3, 3, 7, 15, 31, 63,
+    127, 68, 255, 67, 0, 0, 52, 66, 0, 14, 131, 1, 3, 7, 15, 68,
+    0, 0, 126, 63, 3, 69, 0, 130, 128, 192, 224, 0, 46, 67, 0, 130,
+    14, 124, 252, 66, 248, 131, 240, 240, 224, 224, 68, 192, 133, 224, 240, 248,
+    252, 254, 254, 66, 255, 0, 48, 67, 0, 130, 1, 15, 191, 17, 134, 255,
+    247, 224, 224, 192, 128, 128, 70, 0, 0, 47, 135, 128, 192, 224, 240, 252,
+    254, 255, 255, 17, 67, 127, 67, 63, 132, 62, 30, 28, 24, 24, 0, 45,
+    128, 2, 73, 3, 67, 1, 131, 3, 15, 63, 127, 68, 255, 131, 127, 7,
+    0, 0, 0, 63, 1, 132, 1, 7, 15, 63, 7, 67, 0, 0, 126, 54,
+    129, 192, 128, 16, 66, 0, 0, 50, 67, 0, 128, 31, 66, 255, 143, 254,
+    252, 248, 240, 240, 224, 192, 128, 192, 192, 224, 224, 240, 240, 248, 248, 66,
+    252, 129, 30, 2, 0, 51, 131, 128, 192, 192, 224, 18, 130, 255, 191, 7,
+    66, 0, 0, 44, 134, 16, 24, 56, 60, 62, 62, 63, 68, 127, 16, 67,
+    255, 136, 254, 252, 248, 240, 224, 192, 128, 0, 0, 0, 45, 76, 0, 129,
+    3, 31, 69, 255, 130, 63, 31, 7, 78, 1, 128, 2, 0, 60, 132, 1,
+    15, 63, 15, 3, 67, 0, 0,
+};
+
+static const anim_clip_t anim_best = {
+    .frames = 14,
+    .frame_ms = 80,
+    .length = 1927,
+    .data = anim_best_data,
+};
@@ -0,0 +1,58 @@
+#include "pico/stdlib.h"
+#include "boot.h"
+#include "telemetry.h"
+#include "trace.h"
+
+static uint64_t phase_us[boot_phase_count];
+static uint32_t marked; // Bit i: fase i já marcada
+static bool reported;   // Um host já recebeu as fases anteriores (boot_report)
+
+static uint32_t boot_since_reset_us(boot_phase_t phase)
+{
+    return phase_us[phase] > UINT32_MAX ? UINT32_MAX : (uint32_t)phase_us[phase];
+}
+
+/**
+ * @brief Marca o fim de uma fase do boot; só a primeira marca de cada fase vale.
+ *
+ * Depois do primeiro boot_report, a fase também vai direto para a telemetria.
+ */
+void boot_mark(boot_phase_t phase)
+{
+    if (marked & (1u << phase))
+        return;
+
+    phase_us[phase] = time_us_64();
+    marked |= 1u << phase;
+    trace_event(trace_boot, phase);
+    if (reported)
+        telemetry_push_at(phase_us[phase], telemetry_type_boot, phase, boot_since_reset_us(phase));
+}
+
+bool boot_marked(boot_phase_t phase)
+{
+    return marked & (1u << phase);
+}
+
+/**
+ * @brief Instante da fase, em µs do temporizador (0 se ainda não marcada).
+ */
+uint64_t boot_time_us(boot_phase_t phase)
+{
+    return phase_us[phase];
+}
+
+/**
+ * @brief Enfileira na telemetria uma linha telemetry_type_boot por fase já marcada.
+ *
+ * Chamada a cada conexão de um host USB.
+ */
+void boot_report(void)
+{
+    for (int phase = 0; phase < boot_phase_count; phase++)
+    {
+        if (marked & (1u << phase))
+            telemetry_push_at(phase_us[phase], telemetry_type_boot, phase, boot_since_reset_us(phase));
+    }
+    reported = true;
+}
@@ -0,0 +1,33 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef boot_h
+#define boot_h
+
+/*
+ * Tempos do boot: cada fase é marcada uma vez com o instante do temporizador, que começa a
+ * contar na inicialização do runtime, logo antes de main (o boot ROM, o boot2 e a partida
+ * do cristal ficam de fora, poucos ms). A marca vai na hora para o trace (trace_boot) e
+ * fica guardada: a telemetria descarta o que é produzido sem host USB, então boot_report
+ * envia as fases (telemetry_type_boot) a cada conexão, e as seguintes vão direto.
+ *
+ * Ordem do boot rápido: botões, LEDs e buzzer primeiro (jogável), depois a USB (enumera
+ * em segundo plano), o log da flash e o display, que é inicializado aos poucos pelo laço
+ * principal.
+ */
+
+typedef enum
+{
+  boot_phase_main,    // Entrada em main
+  boot_phase_inputs,  // Botões, LEDs e buzzer prontos: dá para jogar
+  boot_phase_display, // Primeira tela completa no painel
+  boot_phase_usb,     // Host USB conectado (enumeração concluída)
+  boot_phase_count
+} boot_phase_t;
+
+void boot_mark(boot_phase_t phase);
+bool boot_marked(boot_phase_t phase);
+uint64_t boot_time_us(boot_phase_t phase);
+void boot_report(void);
+
+#endif
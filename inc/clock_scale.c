@@ -0,0 +1,103 @@
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "clock_scale.h"
+#include "led_fx.h"
+#include "tone.h"
+#include "pcm.h"
+#include "trace.h"
+
+static const uint32_t phase_khz[clock_phase_count] = {
+    [clock_phase_idle] = clock_scale_low_khz,
+    [clock_phase_foreperiod] = clock_scale_low_khz,
+    [clock_phase_reaction] = clock_scale_high_khz,
+};
+
+static i2c_inst_t *display_i2c;
+static uint32_t display_baudrate;
+static clock_phase_t current = clock_phase_idle;
+static bool render_held;
+static uint32_t render_until_ms;
+
+/**
+ * @brief Registra o I2C cujo divisor acompanha as trocas de clk_peri.
+ */
+void clock_scale_init(i2c_inst_t *i2c, uint32_t baudrate)
+{
+    display_i2c = i2c;
+    display_baudrate = baudrate;
+}
+
+// Clock da fase atual, ou o alto enquanto um envio ao display o mantém
+static uint32_t target_khz(void)
+{
+    return render_held && phase_khz[current] < clock_scale_high_khz ? clock_scale_high_khz : phase_khz[current];
+}
+
+/**
+ * @brief Vai para o clock alvo e refaz os divisores dependentes.
+ *
+ * Compara com o clk_sys real, não com a fase anterior: depois de um dormant (que volta aos
+ * clocks do boot) a próxima chamada também refaz tudo.
+ */
+static void apply(void)
+{
+    uint32_t khz = target_khz();
+    if (clock_get_hz(clk_sys) == khz * 1000 || !set_sys_clock_khz(khz, false))
+        return;
+
+    if (display_i2c)
+        i2c_set_baudrate(display_i2c, display_baudrate);
+    led_fx_clock_changed();
+    tone_clock_changed();
+    pcm_clock_changed();
+    trace_event(trace_clock, khz / 1000);
+}
+
+/**
+ * @brief Passa para a fase. Uma subida vale na hora; a descida fica para clock_scale_service,
+ * no fim da volta do laço, então a tela que costuma vir logo depois (resultado, queima,
+ * resumo) não paga uma troca para baixo e outra para cima.
+ */
+void clock_scale_set(clock_phase_t phase)
+{
+    current = phase;
+    if (target_khz() * 1000 > clock_get_hz(clk_sys))
+        apply();
+}
+
+/**
+ * @brief Clock alto para um envio ao display, mantido até clock_scale_render_hold_ms depois
+ * deste.
+ */
+void clock_scale_render(uint32_t now_ms)
+{
+    render_held = true;
+    render_until_ms = now_ms + clock_scale_render_hold_ms;
+    apply();
+}
+
+// Fim da volta do laço: aplica uma descida pendente, se o último envio já passou do prazo
+void clock_scale_service(uint32_t now_ms)
+{
+    if (render_held && (int32_t)(now_ms - render_until_ms) < 0)
+        return;
+    render_held = false;
+    apply();
+}
+
+bool clock_scale_render_held(void)
+{
+    return render_held;
+}
+
+// Fim da manutenção do clock alto (só vale com clock_scale_render_held)
+uint32_t clock_scale_render_until_ms(void)
+{
+    return render_until_ms;
+}
+
+clock_phase_t clock_scale_phase(void)
+{
+    return current;
+}
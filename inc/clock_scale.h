@@ -0,0 +1,47 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef clock_scale_h
+#define clock_scale_h
+
+/*
+ * Política de clock por fase do jogo: clk_sys baixo na espera e na preparação, alto na
+ * janela de reação e nos envios ao display. Os envios não trocam o clock a cada tela:
+ * clock_scale_render sobe o clock e o mantém alto até clock_scale_render_hold_ms depois do
+ * último envio. Subidas valem na hora, e descidas só em clock_scale_service (fim da volta do
+ * laço principal), depois desse prazo. Uma rajada de telas custa então uma troca para cima e
+ * uma para baixo, não duas por tela. Cada troca reprograma o PLL do sistema
+ * (set_sys_clock_khz, que leva clk_peri junto) e em seguida refaz tudo que foi calculado a
+ * partir desses clocks: divisores dos LEDs (inc/led_fx.h), a nota em andamento
+ * (inc/tone.h), o DMA timer do PCM (inc/pcm.h) e o divisor do I2C do display.
+ *
+ * Os tempos de reação não são afetados: o timer conta a partir de clk_ref (cristal), que
+ * nenhuma troca altera. A troca só acontece fora da janela de reação.
+ */
+
+typedef enum
+{
+  clock_phase_idle,       // Espera por um novo jogo
+  clock_phase_foreperiod, // Preparação (só sleeps e leituras a cada 10 ms)
+  clock_phase_reaction,   // Do estímulo até a captura: latência de IRQ mínima
+  clock_phase_count,
+} clock_phase_t;
+
+// clk_sys de cada fase, em kHz (precisam ser alcançáveis pelo PLL a partir do XOSC)
+#define clock_scale_low_khz 48000
+#define clock_scale_high_khz 125000
+
+// Clock alto mantido depois do último envio ao display
+#define clock_scale_render_hold_ms 250
+
+struct i2c_inst;
+
+void clock_scale_init(struct i2c_inst *i2c, uint32_t baudrate);
+void clock_scale_set(clock_phase_t phase);
+clock_phase_t clock_scale_phase(void);
+void clock_scale_render(uint32_t now_ms);
+void clock_scale_service(uint32_t now_ms);
+bool clock_scale_render_held(void);
+uint32_t clock_scale_render_until_ms(void);
+
+#endif
@@ -0,0 +1,109 @@
+#include "game.h"
+#include "ram_capture.h"
+
+/**
+ * @brief Configura os jogadores e o tempo limite da reação; o jogo fica na tela inicial.
+ *
+ * Chamada de novo entre rodadas quando o número de jogadores muda; a sessão é mantida.
+ */
+void game_init(game_t *game, uint32_t pin_mask, uint32_t timeout_ms)
+{
+    *game = (game_t){.state = telemetry_state_idle,
+                     .pin_mask = pin_mask,
+                     .timeout_ms = timeout_ms,
+                     .session_rounds = game->session_rounds,
+                     .iti_ms = game->iti_ms};
+}
+
+/**
+ * @brief Configura a sessão: rounds rodadas seguidas a cada pressão do botão A.
+ *
+ * @param rounds Rodadas por sessão (0: rodadas avulsas, com as telas de game_result_ms e
+ *               game_false_start_ms).
+ * @param iti_ms Intervalo entre o resultado (ou a queima) e a próxima preparação.
+ */
+void game_session(game_t *game, uint8_t rounds, uint32_t iti_ms)
+{
+    game->session_rounds = rounds;
+    game->session_round = 0;
+    game->iti_ms = iti_ms;
+}
+
+static uint64_t capture_func(game_foreperiod_us)(const game_input_t *input)
+{
+    // Sem atraso o estímulo sai na volta seguinte, não junto com a preparação
+    return input->foreperiod_ms ? (uint64_t)input->foreperiod_ms * 1000 : 1;
+}
+
+// Tela de resultado ou de queima: na sessão dura o intervalo entre rodadas
+static uint64_t capture_func(game_screen_us)(const game_t *game, uint32_t single_ms)
+{
+    return (uint64_t)(game->session_rounds ? game->iti_ms : single_ms) * 1000;
+}
+
+static game_action_t capture_func(game_enter)(game_t *game, uint8_t state, uint64_t now_us,
+                                              uint64_t duration_us, game_action_t action)
+{
+    game->state = state;
+    game->phase_start_us = now_us;
+    game->phase_end_us = duration_us ? now_us + duration_us : 0;
+    return action;
+}
+
+static bool capture_func(game_due)(const game_t *game, uint64_t now_us)
+{
+    return game->phase_end_us && now_us >= game->phase_end_us;
+}
+
+/**
+ * @brief Avança a rodada com as entradas lidas em now_us.
+ *
+ * @return A ação da transição (game_action_none se o estado não mudou); ao retornar,
+ *         game->state já é o novo estado.
+ */
+game_action_t capture_func(game_step)(game_t *game, const game_input_t *input, uint64_t now_us)
+{
+    switch (game->state)
+    {
+    case telemetry_state_idle:
+        if (!input->start)
+            return game_action_none;
+        game->early = 0;
+        game->session_round = 1;
+        return game_enter(game, telemetry_state_foreperiod, now_us, game_foreperiod_us(input), game_action_prepare);
+
+    case telemetry_state_foreperiod:
+        // Pressões depois do estímulo são reação, capturadas pelo callback
+        if (input->onset_us)
+            return game_enter(game, telemetry_state_reaction, input->onset_us, (uint64_t)game->timeout_ms * 1000,
+                              game_action_stimulus);
+        if (input->pressed & game->pin_mask)
+        {
+            game->early = input->pressed & game->pin_mask;
+            return game_enter(game, telemetry_state_false_start, now_us,
+                              game_screen_us(game, game_false_start_ms), game_action_false_start);
+        }
+        return game_action_none;
+
+    case telemetry_state_reaction:
+        if (!input->captured && !game_due(game, now_us))
+            return game_action_none;
+        return game_enter(game, telemetry_state_result, now_us, game_screen_us(game, game_result_ms),
+                          game_action_result);
+
+    case telemetry_state_result:
+    case telemetry_state_false_start:
+        if (!game_due(game, now_us))
+            return game_action_none;
+        if (!game->session_rounds)
+            return game_enter(game, telemetry_state_idle, now_us, 0, game_action_idle);
+        if (game->session_round >= game->session_rounds)
+            return game_enter(game, telemetry_state_idle, now_us, 0, game_action_summary);
+        game->early = 0;
+        game->session_round++;
+        return game_enter(game, telemetry_state_foreperiod, now_us, game_foreperiod_us(input), game_action_prepare);
+
+    default:
+        return game_enter(game, telemetry_state_idle, now_us, 0, game_action_idle);
+    }
+}
@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "telemetry.h"
+
+#ifndef game_h
+#define game_h
+
+/*
+ * Máquina de estados de uma rodada, sem hardware: a firmware lê as entradas (inc/hal.h),
+ * chama game_step a cada volta do laço principal e executa a ação devolvida (telas, LEDs,
+ * som, registros). Nenhuma fase bloqueia: tela de resultado e tempo limite são prazos
+ * comparados com o instante informado, então a lógica roda igual no host, em testes com
+ * instantes arbitrários e em benchmarks.
+ *
+ * O fim da preparação é o único evento externo: phase_end_us é o início agendado do
+ * estímulo, que a firmware entrega a um alarme de hardware, e a reação começa no instante
+ * real informado em game_input_t.onset_us.
+ *
+ * Os estados são os da telemetria (telemetry_state_*).
+ *
+ * Numa sessão (game_session), o botão A inicia N rodadas seguidas: depois de cada resultado
+ * ou queima, a próxima preparação começa após o intervalo entre rodadas, sem outra pressão,
+ * e a última termina em game_action_summary em vez de game_action_idle.
+ */
+
+// Duração da tela de queima de largada e da de resultado, antes da tela inicial
+#define game_false_start_ms 2000
+#define game_result_ms 5000
+
+typedef enum
+{
+  game_action_none,
+  game_action_prepare,     // Início da rodada: preparação até o prazo sorteado
+  game_action_false_start, // Pressão na preparação (pinos em game_t.early)
+  game_action_stimulus,    // Estímulo apresentado (onset_us): captura
+  game_action_result,      // Captura completa ou tempo limite
+  game_action_idle,        // Fim da tela de resultado ou de queima: tela inicial
+  game_action_summary,     // Fim da última rodada da sessão: resumo e tela inicial
+} game_action_t;
+
+typedef struct
+{
+  bool start;             // Botão A pressionado (já sem bounce)
+  uint32_t pressed;       // Banco de entradas lido agora (bit n: GPIO n pressionado)
+  bool captured;          // Todos os tempos da rodada capturados
+  uint32_t foreperiod_ms; // Atraso do estímulo; lido só quando uma rodada começa
+  uint64_t onset_us;      // Início real do estímulo na rodada (0: ainda não apresentado)
+} game_input_t;
+
+typedef struct
+{
+  uint8_t state;          // telemetry_state_*
+  uint32_t pin_mask;      // Pinos dos jogadores: pressão na preparação queima a largada
+  uint32_t timeout_ms;    // Reação sem captura completa termina aqui (0: sem limite)
+  uint64_t phase_start_us;
+  uint64_t phase_end_us;  // Prazo da fase atual (0: sem prazo); na preparação, o estímulo
+  uint32_t early;         // Pinos que queimaram a largada
+  uint8_t session_rounds; // Rodadas por sessão (0: avulsas, cada uma iniciada pelo botão A)
+  uint8_t session_round;  // Rodadas já iniciadas na sessão atual (1 a session_rounds)
+  uint32_t iti_ms;        // Intervalo entre o resultado e a próxima preparação na sessão
+} game_t;
+
+void game_init(game_t *game, uint32_t pin_mask, uint32_t timeout_ms);
+void game_session(game_t *game, uint8_t rounds, uint32_t iti_ms);
+game_action_t game_step(game_t *game, const game_input_t *input, uint64_t now_us);
+
+static inline bool game_idle(const game_t *game)
+{
+  return game->state == telemetry_state_idle;
+}
+
+// Preparação ou reação: o laço não pode bloquear (o estímulo e os tempos dependem dele)
+static inline bool game_timing(const game_t *game)
+{
+  return game->state == telemetry_state_foreperiod || game->state == telemetry_state_reaction;
+}
+
+#endif
@@ -0,0 +1,190 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/i2c.h"
+#include "hardware/timer.h"
+
+#ifndef hal_h
+#define hal_h
+
+/*
+ * Camada de hardware do jogo: tempo, alarmes, entradas digitais, saídas PWM e o barramento
+ * do display. A lógica (inc/game.c, o desenho em inc/ssd1306_i2c.c) não chama a SDK; a
+ * firmware lê entradas e executa ações só por aqui.
+ *
+ * Backend do Pico: funções inline sobre a SDK, então a firmware compilada não ganha nenhuma
+ * chamada a mais. Backend do host: as mesmas funções sobre a SDK simulada de host/ (relógio
+ * virtual, pinos, alarmes e painel), que a simulação, o bench e o replay já usam. Módulos
+ * de lógica pura não precisam de backend: compilam sozinhos em testes e benchmarks.
+ */
+
+// Barramento do display: I2C1 nos pinos da BitDogLab (SDA/SCL em hal_display_bus_init)
+#define hal_display_i2c i2c1
+
+// Bordas entregues ao callback de entradas
+#define hal_edge_fall GPIO_IRQ_EDGE_FALL
+#define hal_edge_rise GPIO_IRQ_EDGE_RISE
+
+typedef void (*hal_input_callback_t)(unsigned pin, uint32_t edges);
+
+typedef alarm_id_t hal_alarm_t;
+
+// Retorno como o da SDK: 0 encerra, < 0 reagenda a -retorno µs do horário previsto
+typedef int64_t (*hal_alarm_callback_t)(hal_alarm_t alarm, void *data);
+
+// ---------------------------------------------------------------------------------------
+// Tempo
+
+// µs desde o boot (temporizador de 64 bits, seguro em IRQ)
+static inline uint64_t hal_time_us(void)
+{
+  return time_us_64();
+}
+
+static inline uint32_t hal_time_ms(void)
+{
+  return to_ms_since_boot(get_absolute_time());
+}
+
+static inline void hal_sleep_ms(uint32_t ms)
+{
+  sleep_ms(ms);
+}
+
+// Espera (WFE) até time_us ou até uma interrupção, o que vier antes; pode voltar mais cedo,
+// então quem chama confere de novo o que aguardava
+static inline void hal_wait_until(uint64_t time_us)
+{
+  best_effort_wfe_or_timeout(from_us_since_boot(time_us));
+}
+
+// Espera ativa até time_us, sem WFE: volta no instante, com os IRQs atendidos no caminho
+static inline void hal_busy_wait_until(uint64_t time_us)
+{
+  busy_wait_until(from_us_since_boot(time_us));
+}
+
+// ---------------------------------------------------------------------------------------
+// Alarmes (o callback roda em IRQ)
+
+static inline hal_alarm_t hal_alarm_in_ms(uint32_t ms, hal_alarm_callback_t callback, void *data)
+{
+  return add_alarm_in_ms(ms, callback, data, true);
+}
+
+// Num instante absoluto (hal_time_us); já passado, o callback roda em seguida
+static inline hal_alarm_t hal_alarm_at_us(uint64_t time_us, hal_alarm_callback_t callback, void *data)
+{
+  return add_alarm_at(from_us_since_boot(time_us), callback, data, true);
+}
+
+static inline void hal_alarm_cancel(hal_alarm_t alarm)
+{
+  if (alarm > 0)
+    cancel_alarm(alarm);
+}
+
+// ---------------------------------------------------------------------------------------
+// Entradas digitais: botões ativos em 0, com pull-up interno
+
+static inline void hal_input_init(unsigned pin)
+{
+  gpio_init(pin);
+  gpio_set_dir(pin, GPIO_IN);
+  gpio_pull_up(pin);
+}
+
+static inline bool hal_input_pressed(unsigned pin)
+{
+  return !gpio_get(pin);
+}
+
+// Bit n: GPIO n pressionado agora, numa única leitura do banco
+static inline uint32_t hal_input_bank(void)
+{
+  return ~gpio_get_all();
+}
+
+// As duas bordas do pino passam a chamar o callback (o mesmo para todos os pinos)
+static inline void hal_input_events(unsigned pin, hal_input_callback_t callback)
+{
+  gpio_set_irq_enabled_with_callback(pin, hal_edge_fall | hal_edge_rise, true, callback);
+}
+
+// ---------------------------------------------------------------------------------------
+// Saídas PWM (níveis pelos drivers inc/led_fx.h, inc/tone.h e inc/pcm.h)
+
+// Liga ou para a fatia do pino; parada, a saída fica no último nível
+static inline void hal_output_enable(unsigned pin, bool enabled)
+{
+  pwm_set_enabled(pwm_gpio_to_slice_num(pin), enabled);
+}
+
+// ---------------------------------------------------------------------------------------
+// Barramento do display
+
+static inline void hal_display_bus_init(unsigned sda, unsigned scl, uint32_t baudrate)
+{
+  i2c_init(hal_display_i2c, baudrate);
+  gpio_set_function(sda, GPIO_FUNC_I2C);
+  gpio_set_function(scl, GPIO_FUNC_I2C);
+  gpio_pull_up(sda);
+  gpio_pull_up(scl);
+}
+
+// Uma transação de escrita com prazo: retorna os bytes escritos, PICO_ERROR_TIMEOUT ou outro
+// erro (< 0) da SDK (sem ACK: PICO_ERROR_GENERIC). Nunca bloqueia além de timeout_us
+static inline int hal_display_write(uint8_t address, const uint8_t *data, size_t length, uint32_t timeout_us)
+{
+  return i2c_write_timeout_us(hal_display_i2c, address, data, length, false, timeout_us);
+}
+
+// Procura um escravo no endereço: leitura de um byte com prazo (o SSD1306 responde com o
+// status). Retorna 1 com ACK, PICO_ERROR_GENERIC sem ele ou PICO_ERROR_TIMEOUT
+static inline int hal_display_probe(uint8_t address, uint32_t timeout_us)
+{
+  uint8_t status;
+  return i2c_read_timeout_us(hal_display_i2c, address, &status, 1, false, timeout_us);
+}
+
+// Barramento preso: SDA ou SCL em 0 fora de uma transação (um escravo parado no meio de um byte)
+static inline bool hal_display_bus_stuck(unsigned sda, unsigned scl)
+{
+  return !gpio_get(sda) || !gpio_get(scl);
+}
+
+// Recuperação padrão do I2C: até 9 pulsos de SCL (100 kHz, dreno aberto pelo SIO) até o
+// escravo soltar o SDA, uma condição de STOP e o controlador reiniciado. Leva no máximo
+// ~100 µs; retorna se o SDA ficou livre
+static inline bool hal_display_bus_recover(unsigned sda, unsigned scl, uint32_t baudrate)
+{
+  gpio_init(sda);
+  gpio_init(scl);
+  gpio_pull_up(sda);
+  gpio_pull_up(scl);
+  busy_wait_us(5);
+
+  // Saída em 0 ou entrada (o pull-up leva a 1): nunca força 1 contra o escravo
+  for (int pulse = 0; pulse < 9 && !gpio_get(sda); pulse++)
+  {
+    gpio_set_dir(scl, GPIO_OUT);
+    busy_wait_us(5);
+    gpio_set_dir(scl, GPIO_IN);
+    busy_wait_us(5);
+  }
+
+  // STOP: SDA de 0 para 1 com SCL em 1
+  gpio_set_dir(sda, GPIO_OUT);
+  busy_wait_us(5);
+  gpio_set_dir(sda, GPIO_IN);
+  busy_wait_us(5);
+  bool released = gpio_get(sda) && gpio_get(scl);
+
+  hal_display_bus_init(sda, scl, baudrate);
+  return released;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "irq_latency.h"
+#include "telemetry.h"
+#include "ram_capture.h"
+
+const char *const irq_latency_load_names[irq_load_count] = {"NADA", "USB", "I2C", "ALRM", "NUC1"};
+
+static uint probe_pin, probe_slice;
+static uint32_t ns_per_cycle_x256; // ns por ciclo de clk_sys, em ponto fixo 24.8
+static irq_latency_stats_t *volatile target;
+static volatile uint32_t measured;
+
+void irq_latency_reset(irq_latency_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+// Soma uma latência à distribuição (seguro em IRQ; chamada por irq_latency_sample)
+void capture_func(irq_latency_add)(irq_latency_stats_t *stats, uint32_t ns)
+{
+    uint32_t bucket = ns / irq_latency_bucket_ns;
+
+    stats->histogram[bucket < irq_latency_buckets ? bucket : irq_latency_buckets - 1]++;
+    if (stats->count == 0 || ns < stats->min_ns)
+        stats->min_ns = ns;
+    if (ns > stats->max_ns)
+        stats->max_ns = ns;
+    stats->sum_ns += ns;
+    stats->count++;
+}
+
+uint32_t irq_latency_mean_ns(const irq_latency_stats_t *stats)
+{
+    return stats->count ? (uint32_t)(stats->sum_ns / stats->count) : 0;
+}
+
+/**
+ * @brief Uma linha da tela (15 caracteres): nome da carga, média e máximo em ns, nas
+ * colunas de irq_latency_header.
+ *
+ * Ex.: "NADA  880  1024"; valores acima de 99999 ns ficam em 99999. Sem amostras (diagnóstico
+ * interrompido pelo prazo), "NADA 0 AMOSTRAS".
+ */
+int irq_latency_format(const irq_latency_stats_t *stats, const char *name, char *buffer, size_t length)
+{
+    char line[48];
+    uint32_t mean = irq_latency_mean_ns(stats), max = stats->max_ns;
+
+    if (!stats->count)
+        snprintf(line, sizeof(line), "%-4.4s 0 AMOSTRAS", name);
+    else
+        snprintf(line, sizeof(line), "%-4.4s%5lu %5lu", name, (unsigned long)(mean > 99999 ? 99999 : mean),
+             (unsigned long)(max > 99999 ? 99999 : max));
+    return snprintf(buffer, length, "%-15.15s", line);
+}
+
+/**
+ * @brief Envia a distribuição de uma carga pela telemetria (laço principal).
+ *
+ * Um registro telemetry_type_latency por faixa não vazia (a = carga << 8 | faixa, b =
+ * amostras) e um com o máximo exato (faixa irq_latency_record_max). Espera por espaço na
+ * fila: sem host USB, telemetry_service descarta tudo e a espera termina na hora.
+ */
+void irq_latency_report(uint8_t load, const irq_latency_stats_t *stats)
+{
+    for (uint32_t bucket = 0; bucket <= irq_latency_buckets; bucket++)
+    {
+        bool max = bucket == irq_latency_buckets;
+        if (!max && !stats->histogram[bucket])
+            continue;
+
+        while (!telemetry_free())
+        {
+            telemetry_service();
+        }
+        telemetry_push(telemetry_type_latency, ((uint32_t)load << 8) | (max ? irq_latency_record_max : bucket),
+                       max ? stats->max_ns : stats->histogram[bucket]);
+    }
+}
+
+/**
+ * @brief Liga o gerador de bordas no pino (livre e sem nada ligado: vira saída de PWM).
+ *
+ * O callback de GPIO já registrado passa a receber as subidas do pino e deve chamar
+ * irq_latency_sample antes de qualquer outra coisa. O clk_sys atual vale até
+ * irq_latency_stop: uma troca de clock no meio distorce a conversão para ns.
+ */
+void irq_latency_start(unsigned pin)
+{
+    probe_pin = pin;
+    probe_slice = pwm_gpio_to_slice_num(pin);
+    ns_per_cycle_x256 = (uint32_t)(256000000000ull / clock_get_hz(clk_sys));
+    target = NULL;
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int(&config, 1);
+    pwm_config_set_wrap(&config, 0xFFFF);
+    pwm_init(probe_slice, &config, false);
+    pwm_set_gpio_level(pin, 0x8000);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_RISE, true);
+    pwm_set_enabled(probe_slice, true);
+}
+
+/**
+ * @brief Direciona as próximas amostras para uma distribuição (zerada aqui), ou as descarta
+ * com NULL.
+ */
+void irq_latency_measure(irq_latency_stats_t *stats)
+{
+    target = NULL;
+    if (stats)
+        irq_latency_reset(stats);
+    measured = 0;
+    target = stats;
+}
+
+// Amostras somadas desde irq_latency_measure
+uint32_t irq_latency_measured(void)
+{
+    return measured;
+}
+
+// Primeira coisa no callback de GPIO para o pino de prova: o contador é a latência em ciclos
+void capture_func(irq_latency_sample)(void)
+{
+    uint32_t cycles = pwm_get_counter(probe_slice);
+
+    irq_latency_stats_t *stats = target;
+    if (stats)
+    {
+        irq_latency_add(stats, (cycles * ns_per_cycle_x256) >> 8);
+        measured++;
+    }
+}
+
+// Desliga o gerador; o pino volta a ser uma entrada
+void irq_latency_stop(void)
+{
+    target = NULL;
+    gpio_set_irq_enabled(probe_pin, GPIO_IRQ_EDGE_RISE, false);
+    pwm_set_enabled(probe_slice, false);
+    gpio_init(probe_pin);
+}
+
+// Carga do núcleo 1: leituras de uma tabela na flash (XIP) e cópias na SRAM, sem fim, disputando
+// o barramento com o núcleo 0
+static const uint32_t core1_table[1024] = {1};
+static uint32_t core1_buffer[1024];
+
+static void core1_load(void)
+{
+    while (true)
+    {
+        for (size_t i = 0; i < count_of(core1_buffer); i++)
+            core1_buffer[i] += core1_table[(i * 37) % count_of(core1_table)];
+        memcpy(core1_buffer + count_of(core1_buffer) / 2, core1_buffer, sizeof(core1_buffer) / 2);
+    }
+}
+
+void irq_latency_core1_start(void)
+{
+    multicore_launch_core1(core1_load);
+}
+
+// Para o núcleo 1 (antes de qualquer gravação na flash, que suspende o XIP)
+void irq_latency_core1_stop(void)
+{
+    multicore_reset_core1();
+}
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef irq_latency_h
+#define irq_latency_h
+
+/*
+ * Latência de IRQ: tempo da borda num pino até a entrada no callback de GPIO, medido sem
+ * instrumento externo. Uma fatia de PWM (divisor 1, top 0xFFFF) gera as bordas num pino
+ * livre, sem nada ligado, com o IRQ de subida habilitado. A subida acontece no wrap do
+ * contador, então o contador lido no callback (irq_latency_sample) é a latência em ciclos de
+ * clk_sys. Há uma borda a cada 65536 ciclos (524 µs a 125 MHz); latências maiores que isso
+ * aparecem com o resto da divisão.
+ *
+ * Cada carga de fundo acumula um histograma próprio. A firmware roda as cargas em sequência
+ * ('L' pela USB) e envia os histogramas como registros telemetry_type_latency. A simulação
+ * no host modela a mesma medida (host/sim.c, --irq-model), para comparar mudanças antes de
+ * gravar a placa.
+ */
+
+// Faixas do histograma; a última acumula tudo a partir de (irq_latency_buckets - 1) faixas
+#define irq_latency_buckets 64
+#define irq_latency_bucket_ns 100
+
+// Faixas especiais no campo a de telemetry_type_latency (carga << 8 | faixa)
+#define irq_latency_record_max 0xFF    // b: maior latência (ns)
+#define irq_latency_record_filler 0xFE // b: sequência (registros da carga USB)
+
+// Cabeçalho das colunas de irq_latency_format (média e máximo em ns)
+#define irq_latency_header "NS    MED   MAX"
+
+// Cargas de fundo, na ordem do diagnóstico
+typedef enum
+{
+  irq_load_none,  // Só o laço de espera
+  irq_load_usb,   // Telemetria contínua pela USB
+  irq_load_i2c,   // Envios seguidos de telas ao display
+  irq_load_alarm, // Alarme periódico (IRQ do timer)
+  irq_load_core1, // Núcleo 1 lendo a flash e copiando na SRAM
+  irq_load_count,
+} irq_latency_load_t;
+
+// Nomes das cargas na tela (até 4 caracteres)
+extern const char *const irq_latency_load_names[irq_load_count];
+
+/**
+ * @brief Distribuição das latências de uma carga.
+ */
+typedef struct
+{
+  uint32_t count;
+  uint32_t min_ns, max_ns;
+  uint64_t sum_ns;
+  uint32_t histogram[irq_latency_buckets];
+} irq_latency_stats_t;
+
+void irq_latency_reset(irq_latency_stats_t *stats);
+void irq_latency_add(irq_latency_stats_t *stats, uint32_t ns);
+uint32_t irq_latency_mean_ns(const irq_latency_stats_t *stats);
+int irq_latency_format(const irq_latency_stats_t *stats, const char *name, char *buffer, size_t length);
+void irq_latency_report(uint8_t load, const irq_latency_stats_t *stats);
+
+void irq_latency_start(unsigned pin);
+void irq_latency_measure(irq_latency_stats_t *stats);
+uint32_t irq_latency_measured(void);
+void irq_latency_sample(void);
+void irq_latency_stop(void);
+
+void irq_latency_core1_start(void);
+void irq_latency_core1_stop(void);
+
+#endif
@@ -0,0 +1,296 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "led_fx.h"
+#include "ram_capture.h"
+
+// Nível de PWM para cada brilho perceptual: round(1000 * (b / 255) ^ 2,2)
+static const uint16_t capture_data(gamma_levels) gamma_levels[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 2, 2,
+    2, 3, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 10,
+    10, 11, 12, 13, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 27, 28, 29, 30, 32, 33, 34, 36, 37, 38, 40, 41, 43, 45, 46,
+    48, 49, 51, 53, 55, 56, 58, 60, 62, 64, 66, 68, 70, 72, 74, 76,
+    78, 80, 82, 85, 87, 89, 92, 94, 96, 99, 101, 104, 106, 109, 111, 114,
+    117, 119, 122, 125, 128, 130, 133, 136, 139, 142, 145, 148, 151, 154, 157, 160,
+    164, 167, 170, 173, 177, 180, 184, 187, 190, 194, 198, 201, 205, 208, 212, 216,
+    220, 223, 227, 231, 235, 239, 243, 247, 251, 255, 259, 263, 267, 272, 276, 280,
+    284, 289, 293, 298, 302, 307, 311, 316, 320, 325, 330, 334, 339, 344, 349, 354,
+    359, 364, 369, 374, 379, 384, 389, 394, 399, 405, 410, 415, 421, 426, 431, 437,
+    442, 448, 453, 459, 465, 470, 476, 482, 488, 494, 500, 505, 511, 517, 523, 530,
+    536, 542, 548, 554, 560, 567, 573, 580, 586, 592, 599, 605, 612, 619, 625, 632,
+    639, 646, 652, 659, 666, 673, 680, 687, 694, 701, 708, 715, 723, 730, 737, 745,
+    752, 759, 767, 774, 782, 789, 797, 805, 812, 820, 828, 836, 843, 851, 859, 867,
+    875, 883, 891, 899, 908, 916, 924, 932, 941, 949, 957, 966, 974, 983, 991, 1000,
+};
+
+typedef struct
+{
+    uint pin;
+    uint slice;
+    volatile bool active;
+    const led_fx_step_t *steps;
+    size_t count;
+    size_t step;
+    unsigned repeat;     // Repetições restantes; led_fx_forever = sem fim
+    uint32_t elapsed_us; // Dentro do passo atual
+    uint8_t brightness;
+    led_fx_step_t own[2]; // Passos dos atalhos
+} led_fx_led_t;
+
+static led_fx_led_t leds[led_fx_max_leds];
+static size_t led_count;
+static uint32_t tick_us; // Período do PWM, um avanço por wrap
+
+static led_fx_led_t *capture_func(led_find)(uint pin)
+{
+    for (size_t i = 0; i < led_count; i++)
+    {
+        if (leds[i].pin == pin)
+            return &leds[i];
+    }
+    return NULL;
+}
+
+static void capture_func(led_apply)(led_fx_led_t *led, uint8_t brightness)
+{
+    led->brightness = brightness;
+    pwm_set_gpio_level(led->pin, gamma_levels[brightness]);
+}
+
+// Desliga o IRQ da fatia se nenhum outro LED dela tem efeito em andamento
+static void capture_func(led_halt)(led_fx_led_t *led)
+{
+    led->active = false;
+    for (size_t i = 0; i < led_count; i++)
+    {
+        if (leds[i].active && leds[i].slice == led->slice)
+            return;
+    }
+    pwm_set_irq_enabled(led->slice, false);
+}
+
+// Avança o efeito; passos que terminam no meio do período passam o resto ao seguinte
+static void capture_func(led_advance)(led_fx_led_t *led, uint32_t delta_us)
+{
+    led->elapsed_us += delta_us;
+    const led_fx_step_t *step = &led->steps[led->step];
+    while (led->elapsed_us >= (uint32_t)step->duration_ms * 1000)
+    {
+        led->elapsed_us -= (uint32_t)step->duration_ms * 1000;
+        if (++led->step >= led->count)
+        {
+            led->step = 0;
+            if (led->repeat != led_fx_forever && --led->repeat == 0)
+            {
+                led_apply(led, step->to);
+                led_halt(led);
+                return;
+            }
+        }
+        step = &led->steps[led->step];
+    }
+
+    int64_t span = (int32_t)step->to - step->from;
+    led_apply(led, (uint8_t)(step->from + span * led->elapsed_us / ((int64_t)step->duration_ms * 1000)));
+}
+
+// IRQ de wrap: um período a mais para cada LED com efeito nas fatias que sinalizaram
+static void capture_func(led_fx_irq)(void)
+{
+    uint32_t status = pwm_get_irq_status_mask();
+    for (uint slice = 0; slice < NUM_PWM_SLICES; slice++)
+    {
+        if (status & (1u << slice))
+            pwm_clear_irq(slice);
+    }
+
+    for (size_t i = 0; i < led_count; i++)
+    {
+        if (leds[i].active && (status & (1u << leds[i].slice)))
+            led_advance(&leds[i], tick_us);
+    }
+}
+
+// Divisor 8.4 que deixa o PWM perto de led_fx_rate_hz no clk_sys atual; atualiza tick_us
+static uint32_t led_divider(void)
+{
+    uint32_t clock_hz = clock_get_hz(clk_sys);
+    uint32_t div = (uint32_t)(((uint64_t)clock_hz * 16 + led_fx_rate_hz * (led_fx_top + 1) / 2) /
+                              (led_fx_rate_hz * (led_fx_top + 1)));
+    div = div < 16 ? 16 : div > 4095 ? 4095 : div;
+    tick_us = (uint32_t)((uint64_t)div * (led_fx_top + 1) * 1000000 / ((uint64_t)clock_hz * 16));
+    return div;
+}
+
+/**
+ * @brief Configura o pino como LED controlado por efeitos, apagado.
+ *
+ * O divisor é escolhido para que o PWM (e o avanço dos efeitos) fique perto de
+ * led_fx_rate_hz no clk_sys atual (led_fx_clock_changed o refaz após uma troca).
+ */
+void led_fx_init(uint pin)
+{
+    if (led_count >= led_fx_max_leds || led_find(pin))
+        return;
+
+    uint32_t div = led_divider();
+    led_fx_led_t *led = &leds[led_count++];
+    *led = (led_fx_led_t){.pin = pin, .slice = pwm_gpio_to_slice_num(pin)};
+
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, div >> 4, div & 0xF);
+    pwm_config_set_wrap(&config, led_fx_top);
+    pwm_init(led->slice, &config, true);
+    pwm_set_gpio_level(pin, 0);
+
+    if (led_count == 1)
+    {
+        irq_set_exclusive_handler(PWM_IRQ_WRAP, led_fx_irq);
+        irq_set_enabled(PWM_IRQ_WRAP, true);
+    }
+}
+
+/**
+ * @brief Recalcula o divisor das fatias dos LEDs depois de uma troca de clk_sys.
+ *
+ * O nível não muda (o wrap é o mesmo); efeitos em andamento seguem no mesmo ritmo, porque
+ * o avanço por período também é recalculado.
+ */
+void led_fx_clock_changed(void)
+{
+    uint32_t div = led_divider();
+    for (size_t i = 0; i < led_count; i++)
+        pwm_set_clkdiv_int_frac(leds[i].slice, div >> 4, div & 0xF);
+}
+
+/**
+ * @brief Nível de PWM (0 a led_fx_top + 1) de um brilho perceptual.
+ */
+uint16_t led_fx_level(uint8_t brightness)
+{
+    return gamma_levels[brightness];
+}
+
+/**
+ * @brief Interrompe o efeito do LED e fixa o brilho.
+ */
+void capture_func(led_fx_set)(uint pin, uint8_t brightness)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led)
+        return;
+
+    led_halt(led);
+    led_apply(led, brightness);
+}
+
+/**
+ * @brief Começa um efeito no LED, interrompendo o anterior; retorna em seguida.
+ *
+ * @param repeat Vezes que a lista é tocada (led_fx_forever: até led_fx_stop ou outro
+ *               efeito). Ao fim, o LED fica no brilho final do último passo.
+ */
+void led_fx_play(uint pin, const led_fx_step_t *steps, size_t count, unsigned repeat)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led || count == 0)
+        return;
+
+    led_halt(led);
+
+    // Sem duração nenhuma o efeito se resume ao brilho final (e nunca avançaria)
+    uint32_t total_ms = 0;
+    for (size_t i = 0; i < count; i++)
+        total_ms += steps[i].duration_ms;
+    if (total_ms == 0)
+    {
+        led_apply(led, steps[count - 1].to);
+        return;
+    }
+
+    led->steps = steps;
+    led->count = count;
+    led->step = 0;
+    led->repeat = repeat;
+    led->elapsed_us = 0;
+    led->active = true;
+    led_advance(led, 0);
+    if (led->active)
+        pwm_set_irq_enabled(led->slice, true);
+}
+
+/**
+ * @brief Pisca o LED: aceso por on_ms, apagado por off_ms, 'times' vezes (0: sem fim).
+ */
+void led_fx_blink(uint pin, uint8_t brightness, uint16_t on_ms, uint16_t off_ms, unsigned times)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led)
+        return;
+
+    led_halt(led);
+    led->own[0] = (led_fx_step_t){brightness, brightness, on_ms};
+    led->own[1] = (led_fx_step_t){0, 0, off_ms};
+    led_fx_play(pin, led->own, 2, times);
+}
+
+/**
+ * @brief Respira: sobe do apagado ao brilho e volta, em period_ms, 'times' vezes (0: sem fim).
+ */
+void led_fx_breathe(uint pin, uint8_t brightness, uint16_t period_ms, unsigned times)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led)
+        return;
+
+    led_halt(led);
+    led->own[0] = (led_fx_step_t){0, brightness, period_ms / 2};
+    led->own[1] = (led_fx_step_t){brightness, 0, period_ms - period_ms / 2};
+    led_fx_play(pin, led->own, 2, times);
+}
+
+/**
+ * @brief Esmaece do brilho atual até o indicado em duration_ms.
+ */
+void led_fx_fade(uint pin, uint8_t brightness, uint16_t duration_ms)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led)
+        return;
+
+    led_halt(led);
+    led->own[0] = (led_fx_step_t){led->brightness, brightness, duration_ms};
+    led_fx_play(pin, led->own, 1, 1);
+}
+
+/**
+ * @brief Pulso único: sobe ao brilho em rise_ms e apaga em decay_ms.
+ */
+void led_fx_pulse(uint pin, uint8_t brightness, uint16_t rise_ms, uint16_t decay_ms)
+{
+    led_fx_led_t *led = led_find(pin);
+    if (!led)
+        return;
+
+    led_halt(led);
+    led->own[0] = (led_fx_step_t){0, brightness, rise_ms};
+    led->own[1] = (led_fx_step_t){brightness, 0, decay_ms};
+    led_fx_play(pin, led->own, 2, 1);
+}
+
+/**
+ * @brief Interrompe o efeito e apaga o LED.
+ */
+void led_fx_stop(uint pin)
+{
+    led_fx_set(pin, 0);
+}
+
+bool led_fx_active(uint pin)
+{
+    led_fx_led_t *led = led_find(pin);
+    return led && led->active;
+}
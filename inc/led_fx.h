@@ -0,0 +1,52 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef led_fx_h
+#define led_fx_h
+
+/*
+ * Efeitos nos LEDs por PWM, sem bloquear: o jogo inicia um efeito e segue em frente. Cada
+ * LED roda a ~1 kHz (wrap led_fx_top) e, enquanto há um efeito, o IRQ de wrap da sua fatia
+ * avança o efeito um período e escreve o próximo nível no CC, que o hardware só aplica no
+ * wrap seguinte (sem glitches). Sem efeito em andamento o IRQ fica desligado; durante um
+ * efeito custa um handler curto por milissegundo.
+ *
+ * O brilho é perceptual (0 a 255) e passa por uma tabela de gama 2,2 em flash antes de
+ * virar nível de PWM, para que rampas lineares pareçam lineares ao olho.
+ *
+ * Um efeito é uma lista de passos (rampa de um brilho a outro numa duração), repetida
+ * algumas vezes ou até led_fx_stop. A lista precisa continuar válida até o fim; os atalhos
+ * (pisca, respira, esmaece, pulso) guardam os passos no próprio LED.
+ */
+
+// Wrap das fatias dos LEDs e frequência alvo do PWM (e do avanço dos efeitos)
+#define led_fx_top 999
+#define led_fx_rate_hz 1000
+
+// LEDs controlados (pinos registrados por led_fx_init)
+#define led_fx_max_leds 4
+
+// Repetição infinita em led_fx_play
+#define led_fx_forever 0
+
+typedef struct
+{
+  uint8_t from;         // Brilho perceptual no início do passo
+  uint8_t to;           // Brilho ao fim do passo
+  uint16_t duration_ms; // 0: salta direto para 'to'
+} led_fx_step_t;
+
+void led_fx_init(unsigned pin);
+void led_fx_clock_changed(void);
+uint16_t led_fx_level(uint8_t brightness);
+void led_fx_set(unsigned pin, uint8_t brightness);
+void led_fx_play(unsigned pin, const led_fx_step_t *steps, size_t count, unsigned repeat);
+void led_fx_blink(unsigned pin, uint8_t brightness, uint16_t on_ms, uint16_t off_ms, unsigned times);
+void led_fx_breathe(unsigned pin, uint8_t brightness, uint16_t period_ms, unsigned times);
+void led_fx_fade(unsigned pin, uint8_t brightness, uint16_t duration_ms);
+void led_fx_pulse(unsigned pin, uint8_t brightness, uint16_t rise_ms, uint16_t decay_ms);
+void led_fx_stop(unsigned pin);
+bool led_fx_active(unsigned pin);
+
+#endif
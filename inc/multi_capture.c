@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <string.h>
+#include "multi_capture.h"
+#include "ram_capture.h"
+
+/**
+ * @brief Configura os jogadores (até multi_capture_max_players GPIOs, ativos em 0).
+ */
+void multi_capture_init(multi_capture_t *capture, const uint8_t *pins, uint8_t count)
+{
+    memset(capture, 0, sizeof(*capture));
+    capture->count = count > multi_capture_max_players ? multi_capture_max_players : count;
+
+    for (uint8_t i = 0; i < capture->count; i++)
+    {
+        capture->pins[i] = pins[i];
+        capture->pin_mask |= 1u << pins[i];
+    }
+}
+
+/**
+ * @brief Começa uma rodada: descarta os tempos anteriores e passa a aceitar amostras.
+ *
+ * @param start_us Instante do estímulo, base dos tempos de reação.
+ */
+void capture_func(multi_capture_arm)(multi_capture_t *capture, uint64_t start_us)
+{
+    capture->start_us = start_us;
+    capture->captured = 0;
+    capture->armed = true;
+}
+
+void multi_capture_disarm(multi_capture_t *capture)
+{
+    capture->armed = false;
+}
+
+/**
+ * @brief Registra uma leitura do banco de GPIOs (seguro em IRQ, sem laços longos).
+ *
+ * Todo jogador pressionado nesta leitura e ainda sem tempo recebe time_us; o bounce
+ * posterior é ignorado porque só a primeira amostra de cada jogador conta.
+ *
+ * @param pressed_pins Máscara dos GPIOs pressionados (já invertida: bit 1 = nível 0).
+ * @return Máscara dos jogadores capturados nesta amostra (bit i = jogador i).
+ */
+uint32_t capture_func(multi_capture_sample)(multi_capture_t *capture, uint32_t pressed_pins, uint64_t time_us)
+{
+    if (!capture->armed || !(pressed_pins & capture->pin_mask))
+        return 0;
+
+    uint32_t captured = capture->captured, fresh = 0;
+    for (uint8_t i = 0; i < capture->count; i++)
+    {
+        if (!(captured & (1u << i)) && (pressed_pins & (1u << capture->pins[i])))
+        {
+            capture->time_us[i] = time_us;
+            fresh |= 1u << i;
+        }
+    }
+    capture->captured = captured | fresh;
+    return fresh;
+}
+
+/**
+ * @brief Indica se todos os jogadores já têm tempo.
+ */
+bool multi_capture_complete(const multi_capture_t *capture)
+{
+    return capture->count > 0 && capture->captured == (1u << capture->count) - 1;
+}
+
+/**
+ * @brief Tempo de reação de um jogador capturado (µs desde o estímulo).
+ */
+uint32_t multi_capture_reaction_us(const multi_capture_t *capture, uint8_t player)
+{
+    uint64_t elapsed = capture->time_us[player] - capture->start_us;
+    return elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+}
+
+/**
+ * @brief Ordena os jogadores capturados pelo tempo (empates pelo número do jogador).
+ *
+ * @param order Recebe os índices dos jogadores, capturados primeiro e depois os demais.
+ * @return Quantidade de jogadores capturados (as primeiras posições de order).
+ */
+size_t multi_capture_rank(const multi_capture_t *capture, uint8_t *order)
+{
+    size_t ranked = 0;
+
+    for (uint8_t i = 0; i < capture->count; i++)
+    {
+        if (!(capture->captured & (1u << i)))
+            continue;
+
+        // Inserção estável: no máximo multi_capture_max_players elementos
+        size_t j = ranked++;
+        while (j > 0 && capture->time_us[order[j - 1]] > capture->time_us[i])
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    size_t n = ranked;
+    for (uint8_t i = 0; i < capture->count; i++)
+    {
+        if (!(capture->captured & (1u << i)))
+            order[n++] = i;
+    }
+    return ranked;
+}
+
+/**
+ * @brief Formata a classificação em linhas de 15 caracteres para o display.
+ *
+ * A primeira linha é o cabeçalho; o primeiro colocado mostra o tempo de reação e os
+ * demais a diferença para o colocado anterior ("D"), ambos em µs. Quem não pressionou
+ * aparece como "SEM". Ex.: "RANKING EM US", "1 J2 183402", "2 J1 D 3", "3 J3 SEM".
+ */
+int multi_capture_format(const multi_capture_t *capture, char *buffer, size_t length)
+{
+    uint8_t order[multi_capture_max_players];
+    size_t ranked = multi_capture_rank(capture, order);
+    char line[32];
+    int n = snprintf(buffer, length, "%-15.15s", "RANKING EM US");
+
+    for (size_t place = 0; place < capture->count && n >= 0 && (size_t)n < length; place++)
+    {
+        uint8_t player = order[place];
+
+        if (place >= ranked)
+            snprintf(line, sizeof(line), "%u J%u SEM", (unsigned)(place + 1), (unsigned)(player + 1));
+        else if (place == 0)
+            snprintf(line, sizeof(line), "%u J%u %lu", (unsigned)(place + 1), (unsigned)(player + 1),
+                     (unsigned long)multi_capture_reaction_us(capture, player));
+        else
+            snprintf(line, sizeof(line), "%u J%u D %lu", (unsigned)(place + 1), (unsigned)(player + 1),
+                     (unsigned long)(capture->time_us[player] - capture->time_us[order[place - 1]]));
+
+        n += snprintf(buffer + n, length - n, "%-15.15s", line);
+    }
+    return n;
+}
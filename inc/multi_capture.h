@@ -0,0 +1,41 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef multi_capture_h
+#define multi_capture_h
+
+/*
+ * Captura simultânea de vários jogadores: cada amostra é uma leitura única do banco de
+ * GPIOs (gpio_get_all) com um instante do temporizador, então botões pressionados antes da
+ * mesma leitura recebem o mesmo tempo, qualquer que seja a ordem em que os IRQs de cada
+ * pino forem despachados. Pressões separadas por mais que a latência da amostragem ficam
+ * na ordem certa, com a diferença em µs.
+ *
+ * Não depende da SDK: a firmware chama multi_capture_sample do callback de GPIO, e o host
+ * pode chamá-la com bancos e instantes arbitrários.
+ */
+
+#define multi_capture_max_players 4
+
+typedef struct
+{
+  uint8_t count;
+  uint8_t pins[multi_capture_max_players];
+  uint32_t pin_mask;              // GPIOs dos jogadores ativos
+  volatile bool armed;            // Só captura entre o estímulo e o fim da rodada
+  volatile uint32_t captured;     // Bit i: jogador i já tem tempo
+  uint64_t start_us;              // Instante do estímulo
+  uint64_t time_us[multi_capture_max_players];
+} multi_capture_t;
+
+void multi_capture_init(multi_capture_t *capture, const uint8_t *pins, uint8_t count);
+void multi_capture_arm(multi_capture_t *capture, uint64_t start_us);
+void multi_capture_disarm(multi_capture_t *capture);
+uint32_t multi_capture_sample(multi_capture_t *capture, uint32_t pressed_pins, uint64_t time_us);
+bool multi_capture_complete(const multi_capture_t *capture);
+uint32_t multi_capture_reaction_us(const multi_capture_t *capture, uint8_t player);
+size_t multi_capture_rank(const multi_capture_t *capture, uint8_t *order);
+int multi_capture_format(const multi_capture_t *capture, char *buffer, size_t length);
+
+#endif
@@ -0,0 +1,272 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "pcm.h"
+#include "tone.h"
+#include "ram_capture.h"
+
+static const int16_t capture_data(ima_step_table) ima_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60,
+    66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371,
+    408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707,
+    1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+    7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385,
+    24623, 27086, 29794, 32767};
+
+static const int8_t capture_data(ima_index_table) ima_index_table[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// Dois buffers de níveis, um por canal: enquanto um toca, o outro é decodificado
+static uint16_t buffers[2][pcm_chunk_samples];
+static int channels[2] = {-1, -1};
+static int timer = -1;
+static uint pcm_pin;
+static bool initialized;
+static pcm_decoder_t decoder;
+static volatile int ending = -1; // Canal com o último bloco; -1 enquanto há dados
+static volatile bool playing;
+static uint32_t sample_rate; // Do clipe em andamento
+
+/**
+ * @brief Prepara a decodificação de um clipe desde o início.
+ *
+ * @param volume 0 a 255; escala a amplitude em torno do nível de silêncio.
+ */
+void pcm_decoder_init(pcm_decoder_t *decoder, const pcm_clip_t *clip, uint8_t volume)
+{
+    decoder->clip = clip;
+    decoder->position = 0;
+    decoder->predictor = clip->predictor;
+    decoder->step_index = clip->step_index > 88 ? 88 : clip->step_index;
+    decoder->volume = volume;
+}
+
+static __force_inline uint16_t pcm_level(int32_t sample, uint8_t volume)
+{
+    return (uint16_t)(pcm_level_silence + ((sample * volume) >> 16));
+}
+
+// Um passo do IMA-ADPCM: atualiza o preditor e o índice a partir de um nibble
+static __force_inline int32_t ima_decode(pcm_decoder_t *decoder, uint8_t nibble)
+{
+    int32_t step = ima_step_table[decoder->step_index];
+    int32_t diff = step >> 3;
+    if (nibble & 4)
+        diff += step;
+    if (nibble & 2)
+        diff += step >> 1;
+    if (nibble & 1)
+        diff += step >> 2;
+
+    int32_t predictor = decoder->predictor + ((nibble & 8) ? -diff : diff);
+    decoder->predictor = predictor > 32767 ? 32767 : predictor < -32768 ? -32768 : predictor;
+
+    int32_t index = decoder->step_index + ima_index_table[nibble & 7];
+    decoder->step_index = index < 0 ? 0 : index > 88 ? 88 : index;
+    return decoder->predictor;
+}
+
+/**
+ * @brief Decodifica as próximas amostras em níveis de PWM (wrap 255).
+ *
+ * @return Amostras escritas (0 no fim do clipe).
+ */
+size_t capture_func(pcm_decode)(pcm_decoder_t *decoder, uint16_t *levels, size_t max_samples)
+{
+    const pcm_clip_t *clip = decoder->clip;
+    size_t count = clip->samples - decoder->position;
+    if (count > max_samples)
+        count = max_samples;
+
+    uint32_t position = decoder->position;
+    if (clip->format == pcm_format_u8)
+    {
+        for (size_t i = 0; i < count; i++)
+            levels[i] = pcm_level(((int32_t)clip->data[position + i] - 128) << 8, decoder->volume);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++, position++)
+        {
+            uint8_t byte = clip->data[position >> 1];
+            levels[i] = pcm_level(ima_decode(decoder, (position & 1) ? byte >> 4 : byte & 0x0F), decoder->volume);
+        }
+    }
+
+    decoder->position += count;
+    return count;
+}
+
+// Aponta o canal do buffer indicado para o bloco recém-decodificado; o último bloco não
+// encadeia no outro canal
+static void capture_func(channel_setup)(int index, size_t count, bool last)
+{
+    uint channel = channels[index];
+    dma_channel_config config = dma_channel_get_default_config(channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, dma_get_timer_dreq(timer));
+    channel_config_set_chain_to(&config, last ? channel : (uint)channels[index ^ 1]);
+
+    // Escritas de 16 bits no CC se repetem nas duas metades (canais A e B da fatia)
+    dma_channel_configure(channel, &config, &pwm_hw->slice[pwm_gpio_to_slice_num(pcm_pin)].cc, buffers[index],
+                          count, false);
+    if (last)
+        ending = index;
+}
+
+// Fim de um bloco: o outro canal já começou (encadeamento); decodifica o próximo bloco
+// neste buffer ou, se era o último, silencia
+static void capture_func(pcm_dma_irq)(void)
+{
+    for (int index = 0; index < 2; index++)
+    {
+        if (channels[index] < 0 || !dma_channel_get_irq0_status(channels[index]))
+            continue;
+        dma_channel_acknowledge_irq0(channels[index]);
+
+        if (ending == index)
+        {
+            pwm_set_gpio_level(pcm_pin, 0);
+            ending = -1;
+            playing = false;
+        }
+        else if (ending < 0 && playing)
+        {
+            size_t count = pcm_decode(&decoder, buffers[index], pcm_chunk_samples);
+            channel_setup(index, count, decoder.position >= decoder.clip->samples);
+        }
+    }
+}
+
+// Denominador do DMA timer (numerador 1) para a taxa de amostragem no clk_sys atual
+static uint32_t pcm_timer_denominator(uint32_t rate)
+{
+    return rate ? (clock_get_hz(clk_sys) + rate / 2) / rate : 0;
+}
+
+/**
+ * @brief Prepara o pino do buzzer. Os canais de DMA, o DMA timer e o DMA_IRQ_0 só são
+ * reservados no primeiro pcm_play: uma firmware que não toca clipes não os ocupa.
+ */
+void pcm_init(uint pin)
+{
+    pcm_pin = pin;
+    initialized = true;
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+}
+
+// Reserva os recursos do DMA na primeira reprodução; sem algum deles, devolve os outros
+static bool pcm_claim(void)
+{
+    if (timer >= 0)
+        return true;
+
+    channels[0] = dma_claim_unused_channel(false);
+    channels[1] = dma_claim_unused_channel(false);
+    timer = dma_claim_unused_timer(false);
+    if (channels[0] < 0 || channels[1] < 0 || timer < 0)
+    {
+        for (int index = 0; index < 2; index++)
+        {
+            if (channels[index] >= 0)
+                dma_channel_unclaim(channels[index]);
+            channels[index] = -1;
+        }
+        if (timer >= 0)
+            dma_timer_unclaim(timer);
+        timer = -1;
+        return false;
+    }
+
+    dma_channel_set_irq0_enabled(channels[0], true);
+    dma_channel_set_irq0_enabled(channels[1], true);
+    irq_set_exclusive_handler(DMA_IRQ_0, pcm_dma_irq);
+    irq_set_enabled(DMA_IRQ_0, true);
+    return true;
+}
+
+/**
+ * @brief Começa a tocar um clipe, interrompendo tons e o clipe anterior; retorna em seguida.
+ *
+ * @return false se o PCM não foi inicializado, a taxa de amostragem está fora do alcance ou
+ *         não há canais de DMA ou DMA timer livres.
+ */
+bool pcm_play(const pcm_clip_t *clip, uint8_t volume)
+{
+    uint32_t denominator = pcm_timer_denominator(clip->sample_rate);
+    if (!initialized || clip->samples == 0 || denominator == 0 || denominator > 0xFFFF || !pcm_claim())
+        return false;
+
+    tone_cancel();
+    pcm_stop();
+
+    // Portadora de clk_sys / 256, acima da faixa audível; a amostra é o duty cycle
+    uint slice_num = pwm_gpio_to_slice_num(pcm_pin);
+    pwm_set_clkdiv_int_frac(slice_num, 1, 0);
+    pwm_set_wrap(slice_num, 255);
+    pwm_set_gpio_level(pcm_pin, pcm_level_silence);
+    dma_timer_set_fraction(timer, 1, (uint16_t)denominator);
+
+    pcm_decoder_init(&decoder, clip, volume);
+    sample_rate = clip->sample_rate;
+    ending = -1;
+    playing = true;
+    size_t count = pcm_decode(&decoder, buffers[0], pcm_chunk_samples);
+    channel_setup(0, count, decoder.position >= clip->samples);
+    if (ending < 0)
+    {
+        count = pcm_decode(&decoder, buffers[1], pcm_chunk_samples);
+        channel_setup(1, count, decoder.position >= clip->samples);
+    }
+    dma_channel_start(channels[0]);
+    return true;
+}
+
+/**
+ * @brief Interrompe a reprodução e desliga o buzzer.
+ */
+void capture_func(pcm_stop)(void)
+{
+    if (timer < 0 || !playing)
+        return;
+
+    // Sem IRQs durante o abort: um canal abortado ainda pode sinalizar o fim (RP2040-E13)
+    dma_channel_set_irq0_enabled(channels[0], false);
+    dma_channel_set_irq0_enabled(channels[1], false);
+    dma_channel_abort(channels[0]);
+    dma_channel_abort(channels[1]);
+    dma_channel_acknowledge_irq0(channels[0]);
+    dma_channel_acknowledge_irq0(channels[1]);
+    dma_channel_set_irq0_enabled(channels[0], true);
+    dma_channel_set_irq0_enabled(channels[1], true);
+
+    ending = -1;
+    playing = false;
+    pwm_set_gpio_level(pcm_pin, 0);
+}
+
+/**
+ * @brief Mantém a taxa de amostragem do clipe em andamento depois de uma troca de clk_sys.
+ *
+ * A portadora (clk_sys / 256) muda junto, mas continua acima da faixa audível; fora do
+ * alcance do DMA timer, o clipe é interrompido.
+ */
+void pcm_clock_changed(void)
+{
+    if (timer < 0 || !playing)
+        return;
+
+    uint32_t denominator = pcm_timer_denominator(sample_rate);
+    if (denominator == 0 || denominator > 0xFFFF)
+        pcm_stop();
+    else
+        dma_timer_set_fraction(timer, 1, (uint16_t)denominator);
+}
+
+bool pcm_playing(void)
+{
+    return playing;
+}
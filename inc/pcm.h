@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef pcm_h
+#define pcm_h
+
+/*
+ * Reprodução de áudio amostrado no buzzer: o PWM roda com wrap 255 (portadora de
+ * clk_sys / 256, ~488 kHz) e dois canais de DMA, encadeados um no outro e no ritmo de um
+ * DMA timer, copiam os níveis para o registrador CC da fatia, uma amostra por pedido do
+ * timer. A CPU só entra no fim de cada bloco (IRQ do DMA), para decodificar o próximo
+ * bloco no buffer que acabou de tocar; com blocos de pcm_chunk_samples a 8 kHz, uma vez a
+ * cada 32 ms.
+ *
+ * Os clipes ficam na flash como PCM de 8 bits sem sinal ou IMA-ADPCM de 4 bits (mono,
+ * nibble baixo primeiro), gerados por tools/pcm_encode a partir de um WAV.
+ */
+
+// Amostras por bloco (cada buffer tem este tamanho, em níveis de 16 bits)
+#define pcm_chunk_samples 256
+
+// Nível do PWM (wrap 255) para silêncio
+#define pcm_level_silence 128
+
+typedef enum
+{
+  pcm_format_u8,        // Um byte por amostra, 128 = silêncio
+  pcm_format_ima_adpcm, // Quatro bits por amostra
+} pcm_format_t;
+
+typedef struct
+{
+  pcm_format_t format;
+  uint32_t sample_rate;  // Hz, de clk_sys / 65535 (~1,9 kHz) para cima
+  uint32_t samples;
+  const uint8_t *data;
+  int16_t predictor;     // Estado inicial do IMA-ADPCM
+  uint8_t step_index;
+} pcm_clip_t;
+
+typedef struct
+{
+  const pcm_clip_t *clip;
+  uint32_t position;
+  int32_t predictor;
+  int32_t step_index;
+  uint8_t volume;
+} pcm_decoder_t;
+
+void pcm_decoder_init(pcm_decoder_t *decoder, const pcm_clip_t *clip, uint8_t volume);
+size_t pcm_decode(pcm_decoder_t *decoder, uint16_t *levels, size_t max_samples);
+
+void pcm_init(unsigned pin);
+bool pcm_play(const pcm_clip_t *clip, uint8_t volume);
+void pcm_stop(void);
+void pcm_clock_changed(void);
+bool pcm_playing(void);
+
+#endif
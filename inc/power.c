@@ -0,0 +1,37 @@
+#include "pico/stdlib.h"
+#include "pico/runtime_init.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/xosc.h"
+#include "hardware/gpio.h"
+#include "power.h"
+
+/**
+ * @brief Entra em dormant até uma borda de descida no pino e restaura os clocks.
+ *
+ * Periféricos com clock próprio (PWM, I2C, DMA) devem estar parados antes: enquanto
+ * clk_sys roda do cristal, as frequências que eles veem mudam.
+ *
+ * @return Instante (time_us_64) em que o timer voltou a contar, para medir o despertar.
+ */
+uint64_t power_dormant_until_low(uint pin)
+{
+    // Tudo do cristal; sem PLL, USB e ADC não têm de onde tirar clock
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_XOSC_CLKSRC, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, XOSC_HZ, XOSC_HZ);
+    clock_stop(clk_usb);
+    clock_stop(clk_adc);
+    pll_deinit(pll_sys);
+    pll_deinit(pll_usb);
+
+    gpio_set_dormant_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, true);
+    xosc_dormant();
+
+    // O timer anda de novo a partir daqui (clk_ref é o próprio XOSC)
+    uint64_t wake_us = time_us_64();
+    gpio_acknowledge_irq(pin, GPIO_IRQ_EDGE_FALL);
+    gpio_set_dormant_irq_enabled(pin, GPIO_IRQ_EDGE_FALL, false);
+    runtime_init_clocks();
+    return wake_us;
+}
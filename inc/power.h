@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef power_h
+#define power_h
+
+/*
+ * Dormant do RP2040 para a espera entre jogos. Antes de parar o cristal, clk_ref e clk_sys
+ * passam a rodar direto do XOSC (12 MHz), clk_peri o acompanha, os clocks de USB e ADC
+ * param e os dois PLLs são desligados. Em dormant nada roda, nem o timer: só uma borda no
+ * pino de despertar religa o XOSC. Na volta, runtime_init_clocks refaz os PLLs e todos os
+ * clocks como no boot, então divisores de PWM e do I2C calculados antes continuam valendo.
+ *
+ * A USB não sobrevive ao dormant; com um host conectado, o jogo usa apenas __wfi.
+ */
+
+// Despertar, na borda de descida: o XOSC estabiliza (~1 ms, startup_delay da SDK) antes
+// de o timer voltar a contar, então não aparece em medidas feitas com time_us_64
+#define power_xosc_startup_us 1000
+
+uint64_t power_dormant_until_low(unsigned pin);
+
+#endif
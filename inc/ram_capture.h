@@ -0,0 +1,26 @@
+#ifndef ram_capture_h
+#define ram_capture_h
+
+/*
+ * Caminho de captura em SRAM (opção LIGEIRINHO_RAM_CAPTURE do CMake): o callback de GPIO,
+ * os alarmes e IRQs que podem atrasá-lo e o passo do estímulo rodam sem passar pelo cache
+ * do XIP, então uma falta de cache (p.ex. depois de escrever o log na flash) não entra na
+ * latência da captura. O trace e a fila de telemetria já ficam em RAM (.bss).
+ *
+ * capture_func nunca é expandida inline: cada função marcada existe como símbolo próprio, e
+ * tools/check_ram_capture.cmake confere no ELF que todas (e as tabelas com capture_data)
+ * estão na SRAM. Quem marca uma função nova acrescenta o nome a LIGEIRINHO_RAM_CAPTURE_SYMBOLS.
+ *
+ * Sem a opção (e no host) as macros não mudam nada.
+ */
+
+#ifdef LIGEIRINHO_RAM_CAPTURE
+#include "pico.h"
+#define capture_func(name) __no_inline_not_in_flash_func(name)
+#define capture_data(name) __not_in_flash(#name)
+#else
+#define capture_func(name) name
+#define capture_data(name)
+#endif
+
+#endif
@@ -0,0 +1,167 @@
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/structs/rosc.h"
+#include "random.h"
+
+// Estado do xoshiro128** de cada núcleo
+static uint32_t states[NUM_CORES][4];
+
+// log2(1 + i/64) em Q16, para i = 0..64
+static const uint32_t log2_table[65] = {
+    0, 1466, 2909, 4331, 5732, 7112, 8473, 9814, 11136, 12440, 13727, 14996, 16248,
+    17484, 18704, 19909, 21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029, 30109,
+    31178, 32234, 33279, 34312, 35334, 36346, 37346, 38336, 39316, 40286, 41246, 42196,
+    43137, 44068, 44990, 45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063, 52911,
+    53751, 54584, 55410, 56229, 57040, 57845, 58643, 59434, 60219, 60997, 61769, 62534,
+    63294, 64047, 64794, 65536};
+
+#define ln2_q16 45426
+
+// Tentativas antes de saturar uma exponencial truncada em max_ms
+#define exponential_retries 8
+
+static inline uint32_t rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Semeia o gerador de um núcleo (o estado nunca fica todo em zero).
+ */
+void random_seed(uint32_t core, uint64_t seed)
+{
+    uint64_t a = splitmix64(&seed), b = splitmix64(&seed);
+    states[core][0] = (uint32_t)a;
+    states[core][1] = (uint32_t)(a >> 32);
+    states[core][2] = (uint32_t)b;
+    states[core][3] = (uint32_t)(b >> 32) | 1;
+}
+
+/**
+ * @brief Semeia todos os núcleos com bits do ROSC.
+ *
+ * O bit do ROSC é enviesado e correlacionado entre leituras próximas; 64 leituras por
+ * núcleo, misturadas com o temporizador e passadas pelo splitmix64, bastam para
+ * imprevisibilidade (não é uma fonte criptográfica).
+ */
+void random_init(void)
+{
+    for (uint32_t core = 0; core < NUM_CORES; core++)
+    {
+        uint64_t entropy = time_us_64();
+        for (int bit = 0; bit < 64; bit++)
+        {
+            entropy = (entropy << 1 | entropy >> 63) ^ (rosc_hw->randombit & 1);
+            busy_wait_us_32(1);
+        }
+        random_seed(core, entropy);
+    }
+}
+
+/**
+ * @brief Próximos 32 bits do gerador do núcleo atual.
+ */
+uint32_t random_u32(void)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t *s = states[get_core_num()];
+
+    uint32_t result = rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 11);
+
+    restore_interrupts(irq_state);
+    return result;
+}
+
+/**
+ * @brief Inteiro uniforme em [0, bound), sem o viés do módulo (método de Lemire).
+ */
+uint32_t random_below(uint32_t bound)
+{
+    if (bound == 0)
+        return 0;
+
+    uint64_t m = (uint64_t)random_u32() * bound;
+    if ((uint32_t)m < bound)
+    {
+        uint32_t threshold = -bound % bound;
+        while ((uint32_t)m < threshold)
+            m = (uint64_t)random_u32() * bound;
+    }
+    return (uint32_t)(m >> 32);
+}
+
+/**
+ * @brief Amostra de uma exponencial de média 1 em Q16 (-ln U, só com inteiros).
+ *
+ * -ln U = ln 2 * (32 - log2 u), com u de 32 bits; o log2 sai da posição do bit mais alto
+ * e de uma tabela de 64 faixas com interpolação linear (erro < 0,01%).
+ */
+uint32_t random_exponential_q16(void)
+{
+    uint32_t u = random_u32() | 1;
+    uint32_t msb = 31 - __builtin_clz(u);
+    uint32_t mantissa = u << (31 - msb); // 1.31
+    uint32_t index = (mantissa >> 25) & 0x3F;
+    uint32_t fraction = (mantissa >> 9) & 0xFFFF;
+
+    uint32_t log2_fraction = log2_table[index] +
+                             (((log2_table[index + 1] - log2_table[index]) * fraction) >> 16);
+    uint32_t neg_log2_q16 = ((32 - msb) << 16) - log2_fraction;
+
+    return (uint32_t)(((uint64_t)neg_log2_q16 * ln2_q16) >> 16);
+}
+
+/**
+ * @brief Sorteia um atraso (ms) conforme a distribuição configurada.
+ */
+uint32_t foreperiod_sample_ms(const foreperiod_dist_t *dist)
+{
+    switch (dist->kind)
+    {
+    case foreperiod_exponential:
+    {
+        // Truncar por rejeição mantém a forma exponencial dentro da faixa
+        uint32_t span = dist->max_ms - dist->min_ms;
+        for (int attempt = 0; attempt < exponential_retries; attempt++)
+        {
+            uint32_t excess = (uint32_t)(((uint64_t)dist->mean_ms * random_exponential_q16()) >> 16);
+            if (excess < span)
+                return dist->min_ms + excess;
+        }
+        return dist->max_ms;
+    }
+    case foreperiod_table:
+    {
+        uint32_t r = random_below(dist->cumulative[dist->count - 1]);
+        size_t low = 0, high = dist->count - 1;
+        while (low < high)
+        {
+            size_t mid = (low + high) / 2;
+            if (dist->cumulative[mid] > r)
+                high = mid;
+            else
+                low = mid + 1;
+        }
+        return dist->values_ms[low];
+    }
+    case foreperiod_uniform:
+    default:
+        return dist->min_ms + random_below(dist->max_ms - dist->min_ms);
+    }
+}
@@ -0,0 +1,41 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef random_h
+#define random_h
+
+/*
+ * Gerador xoshiro128** com um estado por núcleo, semeado com bits do ROSC (oscilador em
+ * anel) no boot: cada placa, a cada boot, sorteia uma sequência diferente. Só usa
+ * aritmética de 32 bits e não passa pela estrutura de reentrância da newlib; cada
+ * sorteio mascara as IRQs do próprio núcleo por poucos ciclos, então pode ser chamado do
+ * laço principal, de callbacks e dos dois núcleos.
+ */
+
+// Distribuições do atraso antes do estímulo (foreperiod)
+typedef enum
+{
+  foreperiod_uniform,     // Uniforme em [min_ms, max_ms)
+  foreperiod_exponential, // min_ms + exponencial de média mean_ms, truncada em max_ms (não envelhece)
+  foreperiod_table,       // Valores de values_ms com pesos acumulados em cumulative
+} foreperiod_kind_t;
+
+typedef struct
+{
+  foreperiod_kind_t kind;
+  uint32_t min_ms, max_ms;
+  uint32_t mean_ms;
+  const uint32_t *values_ms;
+  const uint32_t *cumulative; // Crescente; o último valor é o peso total
+  size_t count;
+} foreperiod_dist_t;
+
+void random_init(void);
+void random_seed(uint32_t core, uint64_t seed);
+uint32_t random_u32(void);
+uint32_t random_below(uint32_t bound);
+uint32_t random_exponential_q16(void);
+uint32_t foreperiod_sample_ms(const foreperiod_dist_t *dist);
+
+#endif
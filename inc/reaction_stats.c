@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <string.h>
+#include "reaction_stats.h"
+
+// Frações (Q16) das posições desejadas dos cinco marcadores do P²
+static void p2_fractions(uint32_t p_q16, uint32_t f[5])
+{
+    f[0] = 0;
+    f[1] = p_q16 / 2;
+    f[2] = p_q16;
+    f[3] = (65536u + p_q16) / 2;
+    f[4] = 65536u;
+}
+
+static void p2_init(p2_quantile_t *q, uint32_t p_q16)
+{
+    memset(q, 0, sizeof(*q));
+    q->p_q16 = p_q16;
+}
+
+// Predição parabólica (P²) da nova altura do marcador i, deslocado de ds
+static int64_t p2_parabolic(const p2_quantile_t *q, int i, int ds)
+{
+    int64_t n0 = q->pos[i - 1], n1 = q->pos[i], n2 = q->pos[i + 1];
+    int64_t a = (n1 - n0 + ds) * (q->height[i + 1] - q->height[i]) / (n2 - n1);
+    int64_t b = (n2 - n1 - ds) * (q->height[i] - q->height[i - 1]) / (n1 - n0);
+
+    return q->height[i] + ds * (a + b) / (n2 - n0);
+}
+
+// Atualiza o estimador com uma nova amostra (count já inclui a amostra)
+static void p2_add(p2_quantile_t *q, int64_t x, uint32_t count)
+{
+    // As cinco primeiras amostras são mantidas ordenadas nos próprios marcadores
+    if (count <= 5)
+    {
+        int i = count - 1;
+        while (i > 0 && q->height[i - 1] > x)
+        {
+            q->height[i] = q->height[i - 1];
+            i--;
+        }
+        q->height[i] = x;
+        q->pos[count - 1] = count;
+        return;
+    }
+
+    int k;
+    if (x < q->height[0])
+    {
+        q->height[0] = x;
+        k = 0;
+    }
+    else if (x >= q->height[4])
+    {
+        q->height[4] = x;
+        k = 3;
+    }
+    else
+    {
+        for (k = 0; k < 3; k++)
+        {
+            if (x < q->height[k + 1])
+                break;
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++)
+    {
+        q->pos[i]++;
+    }
+
+    uint32_t f[5];
+    p2_fractions(q->p_q16, f);
+
+    for (int i = 1; i <= 3; i++)
+    {
+        int64_t desired_q16 = 65536 + (int64_t)(count - 1) * f[i];
+        int64_t d_q16 = desired_q16 - ((int64_t)q->pos[i] << 16);
+        int64_t above = (int64_t)q->pos[i + 1] - q->pos[i];
+        int64_t below = (int64_t)q->pos[i - 1] - q->pos[i];
+
+        if ((d_q16 >= 65536 && above > 1) || (d_q16 <= -65536 && below < -1))
+        {
+            int ds = d_q16 > 0 ? 1 : -1;
+            int64_t h = p2_parabolic(q, i, ds);
+
+            if (q->height[i - 1] < h && h < q->height[i + 1])
+            {
+                q->height[i] = h;
+            }
+            else
+            {
+                // Fallback linear quando a parábola sai do intervalo dos vizinhos
+                q->height[i] += ds * (q->height[i + ds] - q->height[i]) /
+                                ((int64_t)q->pos[i + ds] - q->pos[i]);
+            }
+            q->pos[i] += ds;
+        }
+    }
+}
+
+// Raiz quadrada inteira (método bit a bit, sem divisão)
+static uint32_t isqrt64(uint64_t v)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+
+    while (bit > v)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (v >= result + bit)
+        {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+// Zera as estatísticas de um jogador
+void reaction_stats_init(reaction_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min_us = UINT32_MAX;
+    p2_init(&stats->p50, reaction_stats_p50);
+    p2_init(&stats->p90, reaction_stats_p90);
+    p2_init(&stats->p99, reaction_stats_p99);
+}
+
+// Faixa do histograma logarítmico correspondente a um tempo (µs)
+uint32_t reaction_stats_bucket(uint32_t reaction_us)
+{
+    const uint32_t sub = 1u << reaction_stats_sub_bits;
+
+    if (reaction_us > reaction_stats_max_us)
+        reaction_us = reaction_stats_max_us;
+    if (reaction_us < sub)
+        return reaction_us;
+
+    uint32_t msb = 31 - __builtin_clz(reaction_us);
+    return (msb - reaction_stats_sub_bits + 1) * sub +
+           ((reaction_us >> (msb - reaction_stats_sub_bits)) & (sub - 1));
+}
+
+// Menor tempo (µs) contido numa faixa do histograma
+uint32_t reaction_stats_bucket_floor_us(uint32_t bucket)
+{
+    const uint32_t sub = 1u << reaction_stats_sub_bits;
+
+    if (bucket < sub)
+        return bucket;
+
+    uint32_t msb = bucket / sub + reaction_stats_sub_bits - 1;
+    return (sub + bucket % sub) << (msb - reaction_stats_sub_bits);
+}
+
+// Acrescenta uma amostra: O(1) em tempo e memória
+void reaction_stats_add(reaction_stats_t *stats, uint32_t reaction_us)
+{
+    if (reaction_us > reaction_stats_max_us)
+        reaction_us = reaction_stats_max_us;
+
+    stats->count++;
+    stats->sum_us += reaction_us;
+    if (reaction_us < stats->min_us)
+        stats->min_us = reaction_us;
+    if (reaction_us > stats->max_us)
+        stats->max_us = reaction_us;
+
+    // Welford: a média vem da soma exata, evitando o erro de truncamento acumulado
+    int64_t x = (int64_t)reaction_us << reaction_stats_frac_bits;
+    int64_t old_mean = stats->mean_q4;
+    stats->mean_q4 = (int64_t)((stats->sum_us << reaction_stats_frac_bits) / stats->count);
+    stats->m2 += ((x - old_mean) * (x - stats->mean_q4)) >> (2 * reaction_stats_frac_bits);
+
+    stats->histogram[reaction_stats_bucket(reaction_us)]++;
+
+    p2_add(&stats->p50, x, stats->count);
+    p2_add(&stats->p90, x, stats->count);
+    p2_add(&stats->p99, x, stats->count);
+}
+
+uint32_t reaction_stats_mean_us(const reaction_stats_t *stats)
+{
+    if (stats->count == 0)
+        return 0;
+    return (uint32_t)((stats->mean_q4 + (1 << (reaction_stats_frac_bits - 1))) >> reaction_stats_frac_bits);
+}
+
+// Desvio padrão amostral (n - 1)
+uint32_t reaction_stats_stddev_us(const reaction_stats_t *stats)
+{
+    if (stats->count < 2 || stats->m2 <= 0)
+        return 0;
+    return isqrt64((uint64_t)stats->m2 / (stats->count - 1));
+}
+
+// Estimativa do quantil (µs); exata (posto mais próximo) até cinco amostras
+uint32_t reaction_stats_quantile_us(const p2_quantile_t *q, uint32_t count)
+{
+    int64_t h;
+
+    if (count == 0)
+        return 0;
+    if (count <= 5)
+        h = q->height[((uint64_t)(count - 1) * q->p_q16 + 32768) >> 16];
+    else
+        h = q->height[2];
+
+    return (uint32_t)((h + (1 << (reaction_stats_frac_bits - 1))) >> reaction_stats_frac_bits);
+}
+
+// Formata a tela de estatísticas (ms) em linhas de 15 colunas para display_text
+int reaction_stats_format(const reaction_stats_t *stats, char *buffer, size_t length)
+{
+    char line[6][32];
+
+    if (stats->count == 0)
+    {
+        return snprintf(buffer, length, "%-15.15s", "SEM DADOS");
+    }
+
+    snprintf(line[0], sizeof(line[0]), "N %lu MED %lu", (unsigned long)stats->count,
+             (unsigned long)(reaction_stats_mean_us(stats) / 1000));
+    snprintf(line[1], sizeof(line[1]), "MIN %lu MAX %lu", (unsigned long)(stats->min_us / 1000),
+             (unsigned long)(stats->max_us / 1000));
+    snprintf(line[2], sizeof(line[2]), "DP %lu", (unsigned long)(reaction_stats_stddev_us(stats) / 1000));
+    snprintf(line[3], sizeof(line[3]), "P50 %lu", (unsigned long)(reaction_stats_quantile_us(&stats->p50, stats->count) / 1000));
+    snprintf(line[4], sizeof(line[4]), "P90 %lu", (unsigned long)(reaction_stats_quantile_us(&stats->p90, stats->count) / 1000));
+    snprintf(line[5], sizeof(line[5]), "P99 %lu", (unsigned long)(reaction_stats_quantile_us(&stats->p99, stats->count) / 1000));
+
+    return snprintf(buffer, length, "%-15.15s%-15.15s%-15.15s%-15.15s%-15.15s%-15.15s",
+                    line[0], line[1], line[2], line[3], line[4], line[5]);
+}
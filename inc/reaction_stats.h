@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef reaction_stats_h
+#define reaction_stats_h
+
+// Maior tempo aceito (µs); valores acima são saturados (~16,7 s)
+#define reaction_stats_max_us ((1u << 24) - 1)
+
+// Histograma logarítmico: 4 sub-faixas por oitava (~19% de largura por faixa)
+#define reaction_stats_sub_bits 2
+#define reaction_stats_buckets 92
+
+// Frações de bits dos valores em ponto fixo (µs * 16)
+#define reaction_stats_frac_bits 4
+
+// Quantis acompanhados (Q16)
+#define reaction_stats_p50 32768u
+#define reaction_stats_p90 58982u
+#define reaction_stats_p99 64881u
+
+/**
+ * @brief Estimador P² (Jain & Chlamtac) de um quantil, em aritmética inteira.
+ *
+ * Mantém cinco marcadores (alturas em µs Q4 e posições inteiras); as posições
+ * desejadas são recalculadas a partir da contagem, sem acumular erro.
+ */
+typedef struct
+{
+  int64_t height[5];
+  uint32_t pos[5];
+  uint32_t p_q16;
+} p2_quantile_t;
+
+/**
+ * @brief Estatísticas de tempo de reação de um jogador, em memória constante.
+ */
+typedef struct
+{
+  uint32_t count;
+  uint32_t min_us, max_us;
+  uint64_t sum_us;   // Soma exata, usada para a média sem erro acumulado
+  int64_t mean_q4;   // Média corrente (µs Q4)
+  int64_t m2;        // Soma dos quadrados dos desvios (Welford, µs²)
+  uint32_t histogram[reaction_stats_buckets];
+  p2_quantile_t p50, p90, p99;
+} reaction_stats_t;
+
+void reaction_stats_init(reaction_stats_t *stats);
+void reaction_stats_add(reaction_stats_t *stats, uint32_t reaction_us);
+uint32_t reaction_stats_mean_us(const reaction_stats_t *stats);
+uint32_t reaction_stats_stddev_us(const reaction_stats_t *stats);
+uint32_t reaction_stats_quantile_us(const p2_quantile_t *q, uint32_t count);
+uint32_t reaction_stats_bucket(uint32_t reaction_us);
+uint32_t reaction_stats_bucket_floor_us(uint32_t bucket);
+int reaction_stats_format(const reaction_stats_t *stats, char *buffer, size_t length);
+
+#endif
@@ -0,0 +1,214 @@
+#include <string.h>
+#include <stddef.h>
+#include "result_log.h"
+
+_Static_assert(sizeof(result_record_t) == 16, "result_record_t deve ter 16 bytes");
+
+static uint32_t write_page;     // Próxima página a programar (índice na região)
+static uint32_t next_seq;       // Sequência do próximo registro
+static uint32_t batch_count;    // Registros pendentes no lote em RAM
+static uint32_t last_append_ms; // Instante do último registro enfileirado
+static uint32_t dropped;        // Registros descartados com o lote cheio (desde o boot)
+static result_record_t batch[result_log_records_per_page];
+
+// CRC-16/CCITT-FALSE sobre os campos do registro (exceto o próprio CRC)
+static uint16_t record_crc(const result_record_t *record)
+{
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint16_t crc = 0xFFFF;
+
+    for (size_t i = 0; i < offsetof(result_record_t, crc); i++)
+    {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static bool record_valid(const result_record_t *record)
+{
+    return record->seq != 0xFFFFFFFFu && record->crc == record_crc(record);
+}
+
+static const uint8_t *page_data(uint32_t page)
+{
+    return result_log_port_region() + page * result_log_page_size;
+}
+
+static bool page_erased(uint32_t page)
+{
+    const uint8_t *data = page_data(page);
+
+    for (uint32_t i = 0; i < result_log_page_size; i++)
+    {
+        if (data[i] != 0xFF)
+            return false;
+    }
+    return true;
+}
+
+static bool sector_erased(uint32_t first_page)
+{
+    for (uint32_t page = first_page; page < first_page + result_log_pages_per_sector; page++)
+    {
+        if (!page_erased(page))
+            return false;
+    }
+    return true;
+}
+
+// Varre a região e retoma a escrita após o registro válido mais recente
+void result_log_init(void)
+{
+    uint32_t newest_page = result_log_pages - 1;
+    bool found = false;
+
+    next_seq = 0;
+    batch_count = 0;
+
+    for (uint32_t page = 0; page < result_log_pages; page++)
+    {
+        const result_record_t *records = (const result_record_t *)page_data(page);
+
+        for (uint32_t i = 0; i < result_log_records_per_page; i++)
+        {
+            if (record_valid(&records[i]) && (!found || records[i].seq >= next_seq))
+            {
+                next_seq = records[i].seq + 1;
+                newest_page = page;
+                found = true;
+            }
+        }
+    }
+
+    // Páginas parcialmente gravadas (lote incompleto ou escrita interrompida) nunca são
+    // reprogramadas: a escrita segue na página seguinte
+    write_page = (newest_page + 1) % result_log_pages;
+}
+
+/**
+ * @brief Enfileira uma rodada no lote em RAM; nenhuma operação de flash acontece aqui.
+ *
+ * @return false se o lote está cheio aguardando result_log_service: o registro não entra
+ *         (contado em result_log_dropped), e quem chama deve gravar o lote e tentar de novo.
+ */
+bool result_log_append(uint32_t timestamp_ms, uint32_t reaction_us, uint8_t flags, uint8_t mode)
+{
+    if (batch_count == result_log_records_per_page)
+    {
+        dropped++;
+        return false;
+    }
+
+    result_record_t *record = &batch[batch_count++];
+    record->seq = next_seq++;
+    record->timestamp_ms = timestamp_ms;
+    record->reaction_us = reaction_us;
+    record->flags = flags;
+    record->mode = mode;
+    record->crc = record_crc(record);
+    last_append_ms = timestamp_ms;
+    return true;
+}
+
+// Encontra uma página apagada a partir de write_page, apagando o próximo setor do anel se preciso
+static bool prepare_write_page(void)
+{
+    for (uint32_t tries = 0; tries < result_log_pages; tries++)
+    {
+        if (write_page % result_log_pages_per_sector == 0)
+        {
+            // Entrada num novo setor: apaga-o (descarta os registros mais antigos do anel);
+            // o setor inteiro é verificado para cobrir apagamentos interrompidos
+            if (!sector_erased(write_page) &&
+                !result_log_port_erase_sector(write_page * result_log_page_size))
+                return false;
+            return true;
+        }
+        if (page_erased(write_page))
+            return true;
+
+        // Página suja no meio do setor (escrita interrompida): pula
+        write_page = (write_page + 1) % result_log_pages;
+    }
+    return false;
+}
+
+/**
+ * @brief Grava o lote pendente, se cheio (ou ocioso há tempo suficiente, ou se forçado).
+ *
+ * Deve ser chamada apenas fora da janela de reação: a programação da flash suspende o XIP.
+ *
+ * @return true se uma página foi programada.
+ */
+bool result_log_service(uint32_t now_ms, bool force)
+{
+    if (batch_count == 0)
+        return false;
+
+    if (!force && batch_count < result_log_records_per_page &&
+        now_ms - last_append_ms < result_log_idle_flush_ms)
+        return false;
+
+    uint8_t page[result_log_page_size];
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, batch, batch_count * sizeof(result_record_t));
+
+    if (!prepare_write_page())
+        return false;
+
+    bool ok = result_log_port_program_page(write_page * result_log_page_size, page);
+
+    // Mesmo que a programação falhe, a página é abandonada para não reprogramá-la
+    write_page = (write_page + 1) % result_log_pages;
+    if (ok)
+        batch_count = 0;
+    return ok;
+}
+
+uint32_t result_log_pending(void)
+{
+    return batch_count;
+}
+
+// Instante em que um lote incompleto passa a ser gravado (só vale com registros pendentes)
+uint32_t result_log_idle_flush_at_ms(void)
+{
+    return last_append_ms + result_log_idle_flush_ms;
+}
+
+uint32_t result_log_dropped(void)
+{
+    return dropped;
+}
+
+uint32_t result_log_next_seq(void)
+{
+    return next_seq;
+}
+
+// Percorre os registros válidos gravados, do mais antigo ao mais recente
+void result_log_for_each(result_log_visitor_t visitor, void *user_data)
+{
+    // O setor de escrita atual é o mais recente e o anel começa no seguinte; se a escrita
+    // está no início de um setor, esse setor (ainda não apagado) é o mais antigo
+    uint32_t sector = write_page / result_log_pages_per_sector;
+    if (write_page % result_log_pages_per_sector)
+        sector++;
+    uint32_t first = sector * result_log_pages_per_sector;
+
+    for (uint32_t n = 0; n < result_log_pages; n++)
+    {
+        uint32_t page = (first + n) % result_log_pages;
+        const result_record_t *records = (const result_record_t *)page_data(page);
+
+        for (uint32_t i = 0; i < result_log_records_per_page; i++)
+        {
+            if (record_valid(&records[i]))
+                visitor(&records[i], user_data);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef result_log_h
+#define result_log_h
+
+// Geometria da flash (NOR do RP2040): programação por página, apagamento por setor
+#define result_log_page_size 256u
+#define result_log_sector_size 4096u
+
+// Região reservada no fim da flash para o registro de resultados (16 setores)
+#define result_log_size (64u * 1024u)
+#define result_log_pages (result_log_size / result_log_page_size)
+#define result_log_pages_per_sector (result_log_sector_size / result_log_page_size)
+
+// Registros gravados de uma vez (uma página por programação)
+#define result_log_records_per_page (result_log_page_size / sizeof(result_record_t))
+
+// Tempo ocioso após o qual um lote incompleto é gravado mesmo assim
+#define result_log_idle_flush_ms 30000u
+
+// Bits de result_record_t.flags
+#define result_flag_false_start 0x01
+#define result_flag_error 0x02 // Botão errado, ou pressão num estímulo "não vai" (inc/stimulus.h)
+#define result_flag_miss 0x04  // Estímulo "vai" sem resposta no prazo
+
+/**
+ * @brief Registro de uma rodada (16 bytes, protegido por CRC-16).
+ */
+typedef struct
+{
+  uint32_t seq;          // Número de sequência global (monotônico entre boots)
+  uint32_t timestamp_ms; // Instante do fim da rodada (ms desde o boot)
+  uint32_t reaction_us;  // Tempo de reação (µs); 0 em queima de largada
+  uint8_t flags;
+  uint8_t mode;
+  uint16_t crc;
+} result_record_t;
+
+typedef void (*result_log_visitor_t)(const result_record_t *record, void *user_data);
+
+void result_log_init(void);
+bool result_log_append(uint32_t timestamp_ms, uint32_t reaction_us, uint8_t flags, uint8_t mode);
+bool result_log_service(uint32_t now_ms, bool force);
+uint32_t result_log_pending(void);
+uint32_t result_log_idle_flush_at_ms(void);
+uint32_t result_log_dropped(void);
+uint32_t result_log_next_seq(void);
+void result_log_for_each(result_log_visitor_t visitor, void *user_data);
+
+/**
+ * @brief Porta de acesso à região reservada, implementada por cada plataforma.
+ *
+ * No Pico (result_log_flash.c) a leitura é feita pelo XIP e as escritas rodam da RAM com
+ * o outro núcleo estacionado; no host (host/result_log_file.c) a região é um arquivo.
+ * Os offsets são relativos ao início da região.
+ */
+const uint8_t *result_log_port_region(void);
+bool result_log_port_erase_sector(uint32_t offset);
+bool result_log_port_program_page(uint32_t offset, const uint8_t *data);
+
+#endif
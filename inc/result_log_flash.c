@@ -0,0 +1,56 @@
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include "result_log.h"
+
+// A região ocupa os últimos 64 KB da flash da placa
+#define result_log_flash_offset (PICO_FLASH_SIZE_BYTES - result_log_size)
+
+_Static_assert(result_log_page_size == FLASH_PAGE_SIZE, "página da flash divergente");
+_Static_assert(result_log_sector_size == FLASH_SECTOR_SIZE, "setor da flash divergente");
+
+// Tempo máximo para estacionar o outro núcleo antes de desistir da escrita
+#define result_log_flash_timeout_ms 100
+
+typedef struct
+{
+    uint32_t offset;
+    const uint8_t *data;
+} flash_op_t;
+
+// Executadas com o XIP suspenso: precisam estar na RAM (as rotinas da SDK também estão)
+static void __no_inline_not_in_flash_func(flash_op_erase)(void *param)
+{
+    const flash_op_t *op = param;
+    flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+}
+
+static void __no_inline_not_in_flash_func(flash_op_program)(void *param)
+{
+    const flash_op_t *op = param;
+    flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+}
+
+// Fim do binário gravado na flash (definido pelo linker script da SDK)
+extern char __flash_binary_end;
+
+// Leitura direta pelo mapeamento XIP
+const uint8_t *result_log_port_region(void)
+{
+    // O firmware não pode invadir a região reservada
+    hard_assert((uintptr_t)&__flash_binary_end <= XIP_BASE + result_log_flash_offset);
+    return (const uint8_t *)(XIP_BASE + result_log_flash_offset);
+}
+
+// flash_safe_execute desabilita as interrupções e estaciona o outro núcleo (se ativo)
+bool result_log_port_erase_sector(uint32_t offset)
+{
+    flash_op_t op = {.offset = result_log_flash_offset + offset, .data = NULL};
+    return flash_safe_execute(flash_op_erase, &op, result_log_flash_timeout_ms) == PICO_OK;
+}
+
+bool result_log_port_program_page(uint32_t offset, const uint8_t *data)
+{
+    flash_op_t op = {.offset = result_log_flash_offset + offset, .data = data};
+    return flash_safe_execute(flash_op_program, &op, result_log_flash_timeout_ms) == PICO_OK;
+}
@@ -1,5 +1,15 @@
 #include "ssd1306_i2c.h"
 
+extern void ssd1306_bus_init(uint sda, uint scl, uint32_t baudrate);
+extern bool ssd1306_bus_service(uint32_t now_ms);
+extern uint32_t ssd1306_retry_at_ms(void);
+extern bool ssd1306_online(void);
+extern bool ssd1306_probe(void);
+extern bool ssd1306_write(const uint8_t *data, size_t length);
+extern const ssd1306_bus_stats_t *ssd1306_bus_stats(void);
+extern uint32_t ssd1306_write_timeout_us(size_t length);
+extern uint32_t ssd1306_block_bound_us(size_t length);
+extern void ssd1306_bus_report(void);
 extern void calculate_render_area_buffer_length(struct render_area *area);
 extern void ssd1306_send_command(uint8_t cmd);
 extern void ssd1306_send_command_list(uint8_t *ssd, int number);
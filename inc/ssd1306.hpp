@@ -0,0 +1,187 @@
+// Driver do SSD1306 em C++17 com a geometria fixa em tempo de compilação (só cabeçalho).
+//
+// Ssd1306<Largura, Altura, Barramento> guarda o quadro num array do próprio objeto (estático
+// quando o objeto é), precedido do byte de controle 0x40: o quadro vai ao painel numa única
+// transação, sem cópia nem malloc. Páginas, tamanho do quadro e índices são constantes, e as
+// contas de posição viram deslocamentos fixos. O mesmo código serve painéis de 128x64 e
+// 128x32: a inicialização ajusta o multiplex e a configuração dos pinos COM à altura.
+//
+// O barramento é um tipo com `static bool write(const uint8_t *data, size_t length)`, uma
+// transação I2C completa. Ssd1306FirmwareBus passa pelo driver em C (prazos, recuperação e
+// painel fora de linha; inc/ssd1306_i2c.c). Desenho e fonte são os do driver em C, exceto
+// que coordenadas fora da tela são ignoradas em vez de violar o assert de ssd1306_set_pixel.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+extern "C"
+{
+#include "ssd1306.h"
+}
+#include "ssd1306_font.h"
+
+namespace ligeirinho
+{
+
+// Barramento da firmware: escritas com prazo pelo driver em C
+struct Ssd1306FirmwareBus
+{
+    static bool write(const uint8_t *data, size_t length) { return ssd1306_write(data, length); }
+};
+
+template <uint8_t Width, uint8_t Height, typename Bus = Ssd1306FirmwareBus>
+class Ssd1306
+{
+    static_assert(Width == 128, "SSD1306: 128 colunas");
+    static_assert(Height == 32 || Height == 64, "SSD1306: 32 ou 64 linhas");
+
+public:
+    static constexpr uint8_t kWidth = Width;
+    static constexpr uint8_t kHeight = Height;
+    static constexpr uint8_t kPages = Height / ssd1306_page_height;
+    static constexpr size_t kBufferLength = size_t(kPages) * Width;
+
+    // Quadro de kBufferLength bytes: página a página, bit 0 de cada byte na linha de cima
+    uint8_t *frame() { return buffer_ + 1; }
+    const uint8_t *frame() const { return buffer_ + 1; }
+
+    // Configura o painel numa transação (mesma sequência de ssd1306_init)
+    bool init() const
+    {
+        static constexpr uint8_t kCommands[] = {
+            0x00, // Co = 0: todos os bytes seguintes são comandos
+            ssd1306_set_display,
+            ssd1306_set_memory_mode,
+            0x00,
+            ssd1306_set_display_start_line,
+            ssd1306_set_segment_remap | 0x01,
+            ssd1306_set_mux_ratio,
+            Height - 1,
+            ssd1306_set_common_output_direction | 0x08,
+            ssd1306_set_display_offset,
+            0x00,
+            ssd1306_set_common_pin_configuration,
+            Height == 64 ? 0x12 : 0x02,
+            ssd1306_set_display_clock_divide_ratio,
+            0x80,
+            ssd1306_set_precharge,
+            0xF1,
+            ssd1306_set_vcomh_deselect_level,
+            0x30,
+            ssd1306_set_contrast,
+            0xFF,
+            ssd1306_set_entire_on,
+            ssd1306_set_normal_display,
+            ssd1306_set_charge_pump,
+            0x14,
+            ssd1306_set_scroll | 0x00,
+            ssd1306_set_display | 0x01,
+        };
+        return Bus::write(kCommands, sizeof(kCommands));
+    }
+
+    void clear() { memset(frame(), 0, kBufferLength); }
+
+    void set_pixel(int x, int y, bool set)
+    {
+        if (unsigned(x) >= Width || unsigned(y) >= Height)
+            return;
+
+        uint8_t &byte = frame()[(unsigned(y) / 8) * Width + unsigned(x)];
+        uint8_t mask = uint8_t(1u << (unsigned(y) % 8));
+        byte = set ? byte | mask : byte & uint8_t(~mask);
+    }
+
+    // Caractere de 8x8 na página de y (y é arredondado para baixo a um múltiplo de 8)
+    void draw_char(int x, int y, char character)
+    {
+        if (unsigned(x) > Width - 8u || unsigned(y) > Height - 8u)
+            return;
+
+        memcpy(frame() + (unsigned(y) / 8) * Width + unsigned(x), font + glyph(character) * 8, 8);
+    }
+
+    void draw_string(int x, int y, const char *string)
+    {
+        if (unsigned(x) > Width - 8u || unsigned(y) > Height - 8u)
+            return;
+
+        for (; *string; string++, x += 8)
+            draw_char(x, y, *string);
+    }
+
+    // Algoritmo de Bresenham, como ssd1306_draw_line
+    void draw_line(int x_0, int y_0, int x_1, int y_1, bool set)
+    {
+        int dx = x_1 > x_0 ? x_1 - x_0 : x_0 - x_1;
+        int dy = y_1 > y_0 ? y_0 - y_1 : y_1 - y_0;
+        int sx = x_0 < x_1 ? 1 : -1;
+        int sy = y_0 < y_1 ? 1 : -1;
+        int error = dx + dy;
+
+        while (true)
+        {
+            set_pixel(x_0, y_0, set);
+            if (x_0 == x_1 && y_0 == y_1)
+                break;
+
+            int error_2 = 2 * error;
+            if (error_2 >= dy)
+            {
+                error += dy;
+                x_0 += sx;
+            }
+            if (error_2 <= dx)
+            {
+                error += dx;
+                y_0 += sy;
+            }
+        }
+    }
+
+    bool flush() { return flush_pages(0, kPages - 1); }
+
+    /**
+     * @brief Envia as páginas first a last (inteiras): uma transação de endereçamento e uma
+     * com os dados.
+     *
+     * O byte antes da primeira página vira o de controle durante o envio e é restaurado em
+     * seguida; o quadro não pode ser desenhado de outro contexto no meio.
+     */
+    bool flush_pages(uint8_t first, uint8_t last)
+    {
+        if (first > last || last >= kPages)
+            return false;
+
+        const uint8_t commands[] = {
+            0x00, ssd1306_set_column_address, 0, Width - 1, ssd1306_set_page_address, first, last};
+        if (!Bus::write(commands, sizeof(commands)))
+            return false;
+
+        uint8_t *start = buffer_ + size_t(first) * Width;
+        uint8_t saved = *start;
+        *start = 0x40;
+        bool ok = Bus::write(start, size_t(last - first + 1) * Width + 1);
+        *start = saved;
+        return ok;
+    }
+
+private:
+    // Índice na fonte (ssd1306_font.h): espaço, A-Z (sem distinção de caixa), 0-9
+    static constexpr unsigned glyph(char character)
+    {
+        if (character >= 'a' && character <= 'z')
+            return unsigned(character - 'a') + 1;
+        if (character >= 'A' && character <= 'Z')
+            return unsigned(character - 'A') + 1;
+        if (character >= '0' && character <= '9')
+            return unsigned(character - '0') + 27;
+        return 0;
+    }
+
+    uint8_t buffer_[1 + kBufferLength] = {0x40};
+};
+
+} // namespace ligeirinho
@@ -7,6 +7,209 @@
 #include "hardware/i2c.h"
 #include "ssd1306_font.h"
 #include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "hal.h"
+#include "trace.h"
+#include "telemetry.h"
+
+// ---------------------------------------------------------------------------------------
+// Barramento: toda escrita ao painel passa por ssd1306_write, com prazo. Uma falha tira o
+// painel de linha: as escritas seguintes são descartadas na hora, sem travar o laço, e com o
+// barramento preso roda a recuperação de 9 pulsos de SCL. ssd1306_bus_service procura o
+// painel de novo em segundo plano, com espera crescente, e o reinicializa quando ele
+// responde. Sem painel no boot (ssd1306_probe), a unidade começa sem display: o mesmo estado
+// fora de linha, em que a firmware nem desenha as telas (ssd1306_online).
+// Escritas também saem de IRQ (a tela invertida de inc/stimulus.c): os contadores são só
+// diagnóstico, e uma corrida rara entre os dois contextos custa no máximo uma contagem.
+
+static uint bus_sda, bus_scl;
+static uint32_t bus_baudrate = ssd1306_i2c_clock * 1000;
+static volatile bool online = true;
+static uint32_t retry_at_ms, retry_ms = ssd1306_retry_min_ms;
+static ssd1306_bus_stats_t stats;
+
+// Configura o I2C do display; o painel em si é inicializado por ssd1306_init
+void ssd1306_bus_init(uint sda, uint scl, uint32_t baudrate)
+{
+    bus_sda = sda;
+    bus_scl = scl;
+    bus_baudrate = baudrate;
+    hal_display_bus_init(sda, scl, baudrate);
+}
+
+// Prazo de uma escrita de length bytes: o dobro da transmissão (9 bits por byte, mais o
+// endereço), mais a margem
+uint32_t ssd1306_write_timeout_us(size_t length)
+{
+    return (uint32_t)(2ull * (length + 1) * 9 * 1000000 / bus_baudrate) + ssd1306_write_timeout_margin_us;
+}
+
+/**
+ * @brief Maior bloqueio de uma chamada do driver que envia length bytes de quadro.
+ *
+ * render_on_display é a mais longa: a lista de comandos e o quadro, cada um no máximo até o
+ * seu prazo, mais uma recuperação do barramento. Com o painel fora, a chamada não bloqueia.
+ */
+uint32_t ssd1306_block_bound_us(size_t length)
+{
+    return ssd1306_write_timeout_us(7) + ssd1306_write_timeout_us(length + 1) + ssd1306_recovery_max_us;
+}
+
+bool ssd1306_online(void)
+{
+    return online;
+}
+
+const ssd1306_bus_stats_t *ssd1306_bus_stats(void)
+{
+    return &stats;
+}
+
+static void bus_event(ssd1306_bus_event_t event, uint32_t value)
+{
+    telemetry_push(telemetry_type_display_bus, event, value);
+}
+
+static void block_done(uint64_t start_us)
+{
+    uint64_t blocked = hal_time_us() - start_us;
+    if (blocked > stats.max_block_us)
+        stats.max_block_us = blocked > UINT32_MAX ? UINT32_MAX : (uint32_t)blocked;
+}
+
+// Tira o painel de linha depois de uma falha e deixa o controlador pronto para a próxima tentativa
+static void bus_fault(int result)
+{
+    online = false;
+    retry_at_ms = hal_time_ms() + retry_ms;
+    if (result == PICO_ERROR_TIMEOUT)
+        bus_event(ssd1306_bus_timeout, ++stats.timeouts);
+    else
+        bus_event(ssd1306_bus_nack, ++stats.nacks);
+
+    if (hal_display_bus_stuck(bus_sda, bus_scl))
+    {
+        bool released = hal_display_bus_recover(bus_sda, bus_scl, bus_baudrate);
+        stats.recoveries++;
+        bus_event(ssd1306_bus_recovery, released);
+    }
+    else if (result == PICO_ERROR_TIMEOUT)
+    {
+        // A transação foi interrompida no meio: o controlador recomeça do zero
+        hal_display_bus_init(bus_sda, bus_scl, bus_baudrate);
+    }
+}
+
+// Uma transação ao painel (byte de controle e dados), com prazo; false se falhou ou foi
+// descartada (painel fora). Também é o barramento do driver em C++ (inc/ssd1306.hpp)
+bool ssd1306_write(const uint8_t *data, size_t length)
+{
+    if (!online)
+    {
+        stats.skipped++;
+        return false;
+    }
+
+    uint64_t start = hal_time_us();
+    int result = hal_display_write(ssd1306_i2c_address, data, length, ssd1306_write_timeout_us(length));
+    bool ok = result == (int)length;
+    if (ok)
+        stats.writes++;
+    else
+        bus_fault(result);
+    block_done(start);
+    return ok;
+}
+
+/**
+ * @brief Procura o painel no endereço (um byte de status lido, ~50 µs a 400 kHz).
+ *
+ * Sem resposta, o painel fica fora de linha até ssd1306_bus_service encontrá-lo; só a
+ * primeira procura sem resposta depois de o painel estar em linha gera um registro.
+ */
+bool ssd1306_probe(void)
+{
+    uint64_t start = hal_time_us();
+    int result = hal_display_probe(ssd1306_i2c_address, ssd1306_write_timeout_us(1));
+    block_done(start);
+    if (result == 1)
+        return true;
+
+    stats.absent++;
+    if (online)
+        bus_event(ssd1306_bus_absent, stats.absent);
+    online = false;
+    retry_at_ms = hal_time_ms() + retry_ms;
+    return false;
+}
+
+// Próxima procura depois de uma tentativa sem resposta: a espera dobra até o limite
+static void retry_later(uint32_t now_ms)
+{
+    retry_ms = retry_ms * 2 > ssd1306_retry_max_ms ? ssd1306_retry_max_ms : retry_ms * 2;
+    retry_at_ms = now_ms + retry_ms;
+}
+
+/**
+ * @brief Nova tentativa com o painel fora (laço principal, fora da janela de reação).
+ *
+ * Recupera o barramento se ainda estiver preso, procura o painel e reenvia a inicialização;
+ * a espera até a próxima tentativa dobra a cada falha, de ssd1306_retry_min_ms a
+ * ssd1306_retry_max_ms. Numa unidade sem display, custa uma procura a cada poucos segundos.
+ *
+ * @return true quando o painel acabou de voltar: a GDDRAM se perdeu e a tela deve ser redesenhada.
+ */
+bool ssd1306_bus_service(uint32_t now_ms)
+{
+    if (online || (int32_t)(now_ms - retry_at_ms) < 0)
+        return false;
+
+    if (hal_display_bus_stuck(bus_sda, bus_scl))
+    {
+        bus_event(ssd1306_bus_recovery, hal_display_bus_recover(bus_sda, bus_scl, bus_baudrate));
+        stats.recoveries++;
+    }
+
+    if (!ssd1306_probe())
+    {
+        retry_later(now_ms);
+        return false;
+    }
+
+    online = true;
+    ssd1306_init();
+    if (!online)
+    {
+        retry_later(now_ms);
+        return false;
+    }
+
+    retry_ms = ssd1306_retry_min_ms;
+    bus_event(ssd1306_bus_reinit, ++stats.reinits);
+    return true;
+}
+
+// Instante da próxima tentativa de ssd1306_bus_service (só vale com o painel fora de linha)
+uint32_t ssd1306_retry_at_ms(void)
+{
+    return retry_at_ms;
+}
+
+// Contadores, maior bloqueio medido e o limite de um quadro inteiro pela telemetria
+void ssd1306_bus_report(void)
+{
+    bus_event(ssd1306_bus_nack, stats.nacks);
+    bus_event(ssd1306_bus_timeout, stats.timeouts);
+    bus_event(ssd1306_bus_recovery, stats.recoveries);
+    bus_event(ssd1306_bus_reinit, stats.reinits);
+    bus_event(ssd1306_bus_skipped, stats.skipped);
+    bus_event(ssd1306_bus_absent, stats.absent);
+    bus_event(ssd1306_bus_max_block, stats.max_block_us);
+    bus_event(ssd1306_bus_bound, ssd1306_block_bound_us(ssd1306_buffer_length));
+}
+
+// ---------------------------------------------------------------------------------------
+// Painel
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area)
@@ -18,15 +221,21 @@ void calculate_render_area_buffer_length(struct render_area *area)
 void ssd1306_send_command(uint8_t command)
 {
     uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+    ssd1306_write(buffer, 2);
 }
 
-// Envia uma lista de comandos ao hardware
+// Envia uma lista de comandos ao hardware numa única transação: com o byte de controle
+// 0x00 (Co = 0) todos os bytes seguintes são comandos, sem endereço e controle a cada um
 void ssd1306_send_command_list(uint8_t *ssd, int number)
 {
-    for (int i = 0; i < number; i++)
+    uint8_t buffer[ssd1306_command_list_max + 1];
+
+    for (int sent = 0; sent < number; sent += ssd1306_command_list_max)
     {
-        ssd1306_send_command(ssd[i]);
+        int count = number - sent < ssd1306_command_list_max ? number - sent : ssd1306_command_list_max;
+        buffer[0] = 0x00;
+        memcpy(buffer + 1, ssd + sent, count);
+        ssd1306_write(buffer, count + 1);
     }
 }
 
@@ -38,7 +247,7 @@ void ssd1306_send_buffer(uint8_t ssd[], int buffer_length)
     temp_buffer[0] = 0x40;
     memcpy(temp_buffer + 1, ssd, buffer_length);
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    ssd1306_write(temp_buffer, buffer_length + 1);
 
     free(temp_buffer);
 }
@@ -102,8 +311,12 @@ void render_on_display(uint8_t *ssd, struct render_area *area)
         ssd1306_set_column_address, area->start_column, area->end_column,
         ssd1306_set_page_address, area->start_page, area->end_page};
 
+    uint64_t start = hal_time_us();
+    trace_event(trace_flush_begin, area->buffer_length);
     ssd1306_send_command_list(commands, count_of(commands));
     ssd1306_send_buffer(ssd, area->buffer_length);
+    trace_event(trace_flush_end, area->buffer_length);
+    block_done(start);
 }
 
 // Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
@@ -162,7 +375,7 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
 }
 
 // Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
+static inline int ssd1306_get_font(uint8_t character)
 {
     if (character >= 'A' && character <= 'Z')
     {
@@ -188,7 +401,7 @@ void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character)
 
     character = toupper(character);
     int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
+    int fb_idx = y * ssd1306_width + x;
 
     for (int i = 0; i < 8; i++)
     {
@@ -211,12 +424,12 @@ void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string)
     }
 }
 
-// Comando de configuração com base na estrutura ssd1306_t
+// Comando de configuração com base na estrutura ssd1306_t; como as demais escritas, passa por
+// ssd1306_write (prazo, painel fora de linha e contadores do barramento)
 void ssd1306_command(ssd1306_t *ssd, uint8_t command)
 {
     ssd->port_buffer[1] = command;
-    i2c_write_blocking(
-        ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+    ssd1306_write(ssd->port_buffer, 2);
 }
 
 // Função de configuração do display para o caso do bitmap
@@ -228,12 +441,12 @@ void ssd1306_config(ssd1306_t *ssd)
     ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
     ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
     ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
+    ssd1306_command(ssd, ssd->height - 1);
     ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
     ssd1306_command(ssd, ssd1306_set_display_offset);
     ssd1306_command(ssd, 0x00);
     ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
+    ssd1306_command(ssd, ssd->height == 32 ? 0x02 : 0x12);
     ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
     ssd1306_command(ssd, 0x80);
     ssd1306_command(ssd, ssd1306_set_precharge);
@@ -249,12 +462,14 @@ void ssd1306_config(ssd1306_t *ssd)
     ssd1306_command(ssd, ssd1306_set_display | 0x01);
 }
 
-// Inicializa o display para o caso de exibição de bitmap
+// Inicializa o display para o caso de exibição de bitmap. As escritas saem pelo barramento
+// de ssd1306_bus_init (ssd1306_write): i2c e address ficam só como registro da configuração
 void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
 {
     ssd->width = width;
     ssd->height = height;
     ssd->pages = height / 8U;
+    ssd->external_vcc = external_vcc;
     ssd->address = address;
     ssd->i2c_port = i2c;
     ssd->bufsize = ssd->pages * ssd->width + 1;
@@ -272,14 +487,13 @@ void ssd1306_send_data(ssd1306_t *ssd)
     ssd1306_command(ssd, ssd1306_set_page_address);
     ssd1306_command(ssd, 0);
     ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-        ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false);
+    ssd1306_write(ssd->ram_buffer, ssd->bufsize);
 }
 
 // Desenha o bitmap (a ser fornecido em display_oled.c) no display
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap)
 {
-    for (int i = 0; i < ssd->bufsize - 1; i++)
+    for (size_t i = 0; i < ssd->bufsize - 1; i++)
     {
         ssd->ram_buffer[i + 1] = bitmap[i];
 
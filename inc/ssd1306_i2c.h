@@ -43,6 +43,46 @@
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Período de varredura do painel com a inicialização de ssd1306_init (divisor 1, oscilador
+// nominal de ~370 kHz, pré-carga de 1 + 15 clocks e 64 linhas: 370 kHz / (66 * 64) ≈ 88 Hz).
+// Um comando só aparece em cada linha quando a varredura passa por ela
+#define ssd1306_frame_us 11400
+
+// Comandos por transação em ssd1306_send_command_list (cabe a inicialização inteira)
+#define ssd1306_command_list_max 32
+
+// Escritas com prazo (ssd1306_write_timeout_us): o dobro do tempo de transmissão, mais a margem
+#define ssd1306_write_timeout_margin_us 1000
+
+// Recuperação do barramento (hal_display_bus_recover), com folga
+#define ssd1306_recovery_max_us 150
+
+// Novas tentativas com o painel fora: a espera dobra a cada falha, entre estes limites
+#define ssd1306_retry_min_ms 250
+#define ssd1306_retry_max_ms 4000
+
+// Eventos do barramento no campo a de telemetry_type_display_bus
+typedef enum
+{
+  ssd1306_bus_nack,      // Escrita sem ACK (painel ausente ou sem alimentação)
+  ssd1306_bus_timeout,   // Escrita além do prazo (barramento travado)
+  ssd1306_bus_recovery,  // Recuperação com pulsos de SCL
+  ssd1306_bus_reinit,    // Painel de volta e reinicializado
+  ssd1306_bus_skipped,   // Escritas descartadas com o painel fora
+  ssd1306_bus_max_block, // Maior bloqueio de uma chamada do driver, em µs
+  ssd1306_bus_bound,     // Limite de bloqueio de um quadro inteiro, em µs
+  ssd1306_bus_absent,    // Procura sem resposta (ssd1306_probe): unidade sem display
+} ssd1306_bus_event_t;
+
+/**
+ * @brief Contadores do barramento do display (ssd1306_bus_stats).
+ */
+typedef struct
+{
+  uint32_t writes, nacks, timeouts, recoveries, reinits, skipped, absent;
+  uint32_t max_block_us; // Maior bloqueio (uma escrita ou render_on_display), inclusive prazo e recuperação
+} ssd1306_bus_stats_t;
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
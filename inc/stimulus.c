@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include "stimulus.h"
+#include "random.h"
+#include "led_fx.h"
+#include "ssd1306.h"
+#include "ssd1306_i2c.h"
+#include "result_log.h"
+#include "ram_capture.h"
+
+/**
+ * @brief Sorteia um estímulo da tabela, com probabilidade proporcional ao peso.
+ *
+ * @return Índice na tabela (0 se todos os pesos forem 0).
+ */
+size_t stimulus_pick(const stimulus_t *table, size_t count)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; i++)
+        total += table[i].weight;
+
+    uint32_t draw = random_below(total);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (draw < table[i].weight)
+            return i;
+        draw -= table[i].weight;
+    }
+    return 0;
+}
+
+/**
+ * @brief Apresenta um estímulo de LED ou de nota (chamada no alarme do início; seguro em IRQ).
+ *
+ * A tela não sai daqui: ela usa stimulus_screen_on, no laço principal.
+ */
+void capture_func(stimulus_on)(const stimulus_t *stimulus)
+{
+    switch (stimulus->kind)
+    {
+    case stimulus_led:
+        led_fx_set(stimulus->pin, stimulus->level);
+        break;
+    case stimulus_tone:
+        tone_play(&stimulus->note, 1);
+        break;
+    case stimulus_screen:
+        break;
+    }
+}
+
+/**
+ * @brief Inverte a tela (estímulo stimulus_screen): um único comando I2C, ~70 µs a 400 kHz.
+ *
+ * Só fora de IRQ: a escrita bloqueia e, se falhar, ssd1306_write recupera o barramento
+ * ali mesmo, no mesmo estado que o laço principal usa para as telas. O painel mostra a
+ * inversão quando a varredura chega a cada linha, de 0 a um quadro (ssd1306_frame_us)
+ * depois do fim da escrita.
+ */
+void stimulus_screen_on(void)
+{
+    ssd1306_send_command(ssd1306_set_inverse_display);
+}
+
+/**
+ * @brief Retira o estímulo no fim da rodada (a nota termina sozinha).
+ */
+void stimulus_off(const stimulus_t *stimulus)
+{
+    switch (stimulus->kind)
+    {
+    case stimulus_led:
+        led_fx_set(stimulus->pin, 0);
+        break;
+    case stimulus_tone:
+        tone_cancel();
+        break;
+    case stimulus_screen:
+        ssd1306_send_command(ssd1306_set_normal_display);
+        break;
+    }
+}
+
+/**
+ * @brief Classifica a resposta da rodada.
+ *
+ * @param response_pin GPIO do primeiro botão pressionado depois do estímulo, ou
+ *                     stimulus_no_response se o prazo terminou sem resposta.
+ */
+stimulus_outcome_t stimulus_judge(const stimulus_t *stimulus, uint8_t response_pin)
+{
+    if (stimulus->button == stimulus_no_go)
+        return response_pin == stimulus_no_response ? stimulus_withheld : stimulus_error;
+    if (response_pin == stimulus_no_response)
+        return stimulus_miss;
+    return response_pin == stimulus->button ? stimulus_hit : stimulus_error;
+}
+
+// Bits de result_record_t.flags (e da telemetria da rodada) para cada resultado
+uint8_t stimulus_result_flags(stimulus_outcome_t outcome)
+{
+    switch (outcome)
+    {
+    case stimulus_error:
+        return result_flag_error;
+    case stimulus_miss:
+        return result_flag_miss;
+    default:
+        return 0;
+    }
+}
+
+void stimulus_stats_reset(stimulus_stats_t *stats, size_t count)
+{
+    memset(stats, 0, count * sizeof(*stats));
+}
+
+/**
+ * @brief Soma o resultado de uma rodada às estatísticas do tipo de estímulo.
+ *
+ * @param reaction_us Tempo até o botão (só entra na média e no mínimo dos acertos).
+ */
+void stimulus_stats_add(stimulus_stats_t *stats, stimulus_outcome_t outcome, uint32_t reaction_us)
+{
+    stats->trials++;
+    switch (outcome)
+    {
+    case stimulus_hit:
+        stats->hits++;
+        stats->sum_us += reaction_us;
+        if (stats->hits == 1 || reaction_us < stats->min_us)
+            stats->min_us = reaction_us;
+        break;
+    case stimulus_error:
+        stats->errors++;
+        break;
+    case stimulus_miss:
+        stats->misses++;
+        break;
+    case stimulus_withheld:
+        stats->withheld++;
+        break;
+    }
+}
+
+/**
+ * @brief Uma linha da tela (15 caracteres): nome, acertos, rodadas e média dos acertos em ms,
+ * nas colunas de stimulus_stats_header.
+ *
+ * Ex.: "VERM  5  6  262"; sem acertos com botão (ou num "não vai"), a média fica em branco.
+ */
+int stimulus_stats_format(const stimulus_stats_t *stats, const char *name, char *buffer, size_t length)
+{
+    char line[48];
+    unsigned long correct = stats->hits + stats->withheld;
+
+    if (stats->hits)
+        snprintf(line, sizeof(line), "%-5.5s%2lu %2lu %4lu", name, correct, (unsigned long)stats->trials,
+                 (unsigned long)(uint32_t)(stats->sum_us / stats->hits / 1000));
+    else
+        snprintf(line, sizeof(line), "%-5.5s%2lu %2lu", name, correct, (unsigned long)stats->trials);
+    return snprintf(buffer, length, "%-15.15s", line);
+}
@@ -0,0 +1,82 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "tone.h"
+
+#ifndef stimulus_h
+#define stimulus_h
+
+/*
+ * Estímulos dos modos de escolha e vai/não vai: cada tipo (LED, nota no buzzer ou a tela
+ * invertida) tem um botão correto, ou nenhum nos estímulos "não vai". O sorteio é por peso
+ * numa tabela da firmware. LED e nota saem de stimulus_on, no alarme do início do estímulo
+ * (seguro em IRQ). A tela sai de stimulus_screen_on, no laço principal, porque a escrita
+ * I2C bloqueia e pode recuperar o barramento. Nos dois casos o instante real é lido logo
+ * depois da apresentação (no caso da tela, depois de a escrita terminar), e a reação conta
+ * a partir dele. O painel ainda leva de 0 a um quadro (ssd1306_frame_us, ~11 ms) para
+ * mostrar a tela invertida, conforme a linha: esse atraso entra nos tempos de TELA e não é
+ * descontado.
+ *
+ * O julgamento e as estatísticas por tipo não dependem da SDK.
+ */
+
+// Tipos cabem nos bits 4-7 do modo no log de resultados
+#define stimulus_max 8
+
+// Botão de um estímulo "não vai": o certo é não pressionar nada
+#define stimulus_no_go 0xFF
+
+// Resposta ausente em stimulus_judge
+#define stimulus_no_response 0xFF
+
+// Cabeçalho das colunas de stimulus_stats_format
+#define stimulus_stats_header "TIPO OK  N   MS"
+
+typedef enum
+{
+  stimulus_led,    // LED por PWM (led_fx), aceso até stimulus_off
+  stimulus_tone,   // Uma nota no buzzer (tone_play)
+  stimulus_screen, // Tela invertida (um comando do SSD1306, fora de IRQ) até stimulus_off
+} stimulus_kind_t;
+
+typedef struct
+{
+  const char *name; // Até 5 caracteres na tela de resultado
+  uint8_t kind;     // stimulus_kind_t
+  uint8_t pin;      // GPIO do LED
+  uint8_t level;    // Brilho do LED (led_fx_set)
+  tone_note_t note; // Nota de stimulus_tone (precisa continuar válida: a tabela é const)
+  uint8_t button;   // GPIO do botão correto, ou stimulus_no_go
+  uint8_t weight;   // Peso no sorteio
+} stimulus_t;
+
+typedef enum
+{
+  stimulus_hit,      // Botão certo no prazo
+  stimulus_error,    // Botão errado, ou qualquer botão num "não vai"
+  stimulus_miss,     // "Vai" sem resposta no prazo
+  stimulus_withheld, // "Não vai" sem resposta: acerto
+} stimulus_outcome_t;
+
+/**
+ * @brief Resultados de um tipo de estímulo.
+ */
+typedef struct
+{
+  uint32_t trials;
+  uint32_t hits, errors, misses, withheld;
+  uint64_t sum_us; // Soma dos tempos dos acertos com botão
+  uint32_t min_us;
+} stimulus_stats_t;
+
+size_t stimulus_pick(const stimulus_t *table, size_t count);
+void stimulus_on(const stimulus_t *stimulus);
+void stimulus_screen_on(void);
+void stimulus_off(const stimulus_t *stimulus);
+stimulus_outcome_t stimulus_judge(const stimulus_t *stimulus, uint8_t response_pin);
+uint8_t stimulus_result_flags(stimulus_outcome_t outcome);
+void stimulus_stats_reset(stimulus_stats_t *stats, size_t count);
+void stimulus_stats_add(stimulus_stats_t *stats, stimulus_outcome_t outcome, uint32_t reaction_us);
+int stimulus_stats_format(const stimulus_stats_t *stats, const char *name, char *buffer, size_t length);
+
+#endif
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#include "hardware/sync.h"
+#include "telemetry.h"
+#include "ram_capture.h"
+
+// Registro bruto: os produtores (inclusive IRQs) só copiam estes campos; toda a
+// codificação acontece em telemetry_service, no laço principal
+typedef struct
+{
+    uint64_t time_us;
+    uint32_t a, b;
+    uint8_t type;
+} telemetry_record_t;
+
+static telemetry_record_t queue[telemetry_queue_length];
+static volatile uint32_t queue_head, queue_tail;
+static volatile uint32_t dropped;
+static volatile bool resync = true; // Próximo quadro leva tempo absoluto
+static uint32_t frames_since_sync;
+
+static uint64_t last_sent_us;
+static uint8_t frame[telemetry_max_frame];
+static size_t frame_length, frame_sent;
+
+// Enfileira um registro com o instante informado (seguro em IRQ)
+void capture_func(telemetry_push_at)(uint64_t time_us, uint8_t type, uint32_t a, uint32_t b)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+
+    if (queue_head - queue_tail < telemetry_queue_length)
+    {
+        telemetry_record_t *record = &queue[queue_head % telemetry_queue_length];
+        record->time_us = time_us;
+        record->type = type;
+        record->a = a;
+        record->b = b;
+        queue_head++;
+    }
+    else
+    {
+        dropped++;
+    }
+
+    restore_interrupts(irq_state);
+}
+
+// Enfileira um registro com o instante atual
+void telemetry_push(uint8_t type, uint32_t a, uint32_t b)
+{
+    telemetry_push_at(time_us_64(), type, a, b);
+}
+
+uint32_t telemetry_dropped(void)
+{
+    return dropped;
+}
+
+// Registros que ainda cabem na fila (produtores em lote, como o envio do trace)
+uint32_t telemetry_free(void)
+{
+    return telemetry_queue_length - (queue_head - queue_tail);
+}
+
+// Registros ou parte de um quadro aguardando telemetry_service
+bool telemetry_pending(void)
+{
+    return queue_tail != queue_head || frame_sent != frame_length;
+}
+
+// Espaço na FIFO do CDC: sem ele, telemetry_service não envia nada até o host ler
+bool telemetry_writable(void)
+{
+    return tud_cdc_write_available() > 0;
+}
+
+static size_t put_varint(uint8_t *out, uint64_t value)
+{
+    size_t n = 0;
+
+    while (value >= 0x80)
+    {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+/**
+ * @brief Codifica um quadro completo (COBS + delimitador) em out.
+ *
+ * @param type Tipo do registro, com telemetry_absolute_time se time_us for absoluto.
+ * @param time_us Delta (ou tempo absoluto) em µs.
+ * @return size_t Bytes escritos (no máximo telemetry_max_frame).
+ */
+size_t telemetry_encode(uint8_t type, uint64_t time_us, uint32_t a, uint32_t b, uint8_t *out)
+{
+    uint8_t raw[telemetry_max_frame];
+    size_t n = 0;
+
+    raw[n++] = type;
+    n += put_varint(raw + n, time_us);
+    n += put_varint(raw + n, a);
+    n += put_varint(raw + n, b);
+    raw[n] = telemetry_crc8(raw, n);
+    n++;
+
+    // COBS: cada bloco começa com a distância até o próximo zero
+    size_t code_idx = 0, length = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (raw[i] == 0)
+        {
+            out[code_idx] = code;
+            code_idx = length++;
+            code = 1;
+        }
+        else
+        {
+            out[length++] = raw[i];
+            code++;
+        }
+    }
+    out[code_idx] = code;
+    out[length++] = 0x00;
+
+    return length;
+}
+
+/**
+ * @brief Envia parte da fila pela USB; chamada apenas do laço principal.
+ *
+ * No máximo telemetry_service_budget bytes por chamada, e só o que cabe na FIFO do CDC:
+ * putchar_raw com a FIFO cheia esperaria o host ler (ou o timeout do stdio_usb).
+ * Sem host conectado a fila é descartada e o próximo quadro volta a ter tempo absoluto,
+ * assim como a cada telemetry_sync_interval quadros (para decodificadores que entram no meio).
+ */
+void telemetry_service(void)
+{
+    if (!stdio_usb_connected())
+    {
+        queue_tail = queue_head;
+        frame_length = frame_sent = 0;
+        resync = true;
+        return;
+    }
+
+    size_t budget = tud_cdc_write_available();
+    if (budget > telemetry_service_budget)
+        budget = telemetry_service_budget;
+
+    for (; budget > 0; budget--)
+    {
+        if (frame_sent == frame_length)
+        {
+            if (queue_tail == queue_head)
+                return;
+
+            telemetry_record_t record = queue[queue_tail % telemetry_queue_length];
+            queue_tail++;
+
+            uint8_t type = record.type;
+            uint64_t time_us = record.time_us - last_sent_us;
+            if (resync || frames_since_sync >= telemetry_sync_interval || record.time_us < last_sent_us)
+            {
+                resync = false;
+                frames_since_sync = 0;
+                type |= telemetry_absolute_time;
+                time_us = record.time_us;
+            }
+            last_sent_us = record.time_us;
+            frames_since_sync++;
+
+            frame_length = telemetry_encode(type, time_us, record.a, record.b, frame);
+            frame_sent = 0;
+        }
+
+        putchar_raw(frame[frame_sent++]);
+    }
+}
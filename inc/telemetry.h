@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef telemetry_h
+#define telemetry_h
+
+/*
+ * Formato do fluxo de telemetria (USB CDC):
+ *
+ *   quadro = COBS(tipo, varint(tempo), varint(a), varint(b), crc8) seguido de 0x00
+ *
+ * O tempo é o delta em µs desde o quadro anterior; quando o bit telemetry_absolute_time
+ * está presente no tipo, é o tempo absoluto desde o boot (primeiro quadro, após reconexão
+ * e periodicamente).
+ * Os campos a e b dependem do tipo (ver abaixo). O CRC-8 (polinômio 0x07) cobre todos os
+ * bytes anteriores do quadro decodificado. Quadros que falham no CRC (por exemplo, texto
+ * de printf intercalado) devem ser ignorados pelo decodificador.
+ */
+
+#define telemetry_absolute_time 0x80
+
+// Tipos de registro                 campo a          campo b
+#define telemetry_type_round 0x01   // tempo (µs)       flags | (modo << 8)
+#define telemetry_type_input 0x02   // GPIO             nível (0/1)
+#define telemetry_type_display 0x03 // duração (µs)     bytes enviados
+#define telemetry_type_state 0x04   // novo estado      estado anterior
+#define telemetry_type_trace 0x05   // evento do trace  argumento (ver inc/trace.h)
+#define telemetry_type_boot 0x06    // fase (inc/boot.h) µs desde o início do timer
+#define telemetry_type_stimulus 0x07 // estímulo (0xFF: simples) atraso do início real (µs)
+#define telemetry_type_latency 0x08  // carga << 8 | faixa  amostras (ver inc/irq_latency.h)
+#define telemetry_type_display_bus 0x09 // evento (ssd1306_bus_*) contagem ou µs (inc/ssd1306_i2c.h)
+
+// Estados do jogo reportados por telemetry_type_state
+#define telemetry_state_idle 0
+#define telemetry_state_foreperiod 1
+#define telemetry_state_reaction 2
+#define telemetry_state_result 3
+#define telemetry_state_false_start 4
+
+// Registros aguardando envio (potência de 2)
+#define telemetry_queue_length 64
+
+// Maior quadro codificado: tipo + 3 varints de 64 bits + CRC, mais o overhead do COBS e o 0x00
+#define telemetry_max_frame 36
+
+// Quadros entre tempos absolutos, para que um decodificador possa entrar no meio do fluxo
+#define telemetry_sync_interval 64
+
+// Máximo de bytes enviados por chamada de telemetry_service (limitado também pelo espaço livre no CDC)
+#define telemetry_service_budget 64
+
+/**
+ * @brief CRC-8 (polinômio 0x07, valor inicial 0) usado no fim de cada quadro.
+ */
+static inline uint8_t telemetry_crc8(const uint8_t *data, size_t length)
+{
+  uint8_t crc = 0;
+
+  for (size_t i = 0; i < length; i++)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+void telemetry_push(uint8_t type, uint32_t a, uint32_t b);
+void telemetry_push_at(uint64_t time_us, uint8_t type, uint32_t a, uint32_t b);
+void telemetry_service(void);
+uint32_t telemetry_dropped(void);
+uint32_t telemetry_free(void);
+bool telemetry_pending(void);
+bool telemetry_writable(void);
+size_t telemetry_encode(uint8_t type, uint64_t time_us, uint32_t a, uint32_t b, uint8_t *out);
+
+#endif
@@ -0,0 +1,172 @@
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "tone.h"
+#include "pcm.h"
+#include "trace.h"
+#include "ram_capture.h"
+#include "hal.h"
+
+static uint tone_pin;
+static const tone_note_t *sequence;
+static size_t sequence_length, sequence_next;
+static hal_alarm_t sequence_alarm;
+static volatile bool playing;
+static uint32_t sys_clock_hz; // clk_sys em cache: o alarme não consulta os clocks na flash
+
+/**
+ * @brief Calcula divisor e wrap para uma frequência.
+ *
+ * O período em 16 avos de ciclo é clock_hz * 16 / frequency_hz = div * (top + 1). O menor
+ * divisor que deixa top em 16 bits dá a maior resolução; os tone_div_candidates seguintes
+ * também são testados, porque um deles pode dividir o período com resto menor.
+ *
+ * @return false se a frequência estiver fora do alcance do PWM.
+ */
+bool capture_func(tone_divider)(uint32_t clock_hz, uint32_t frequency_hz, tone_divider_t *divider)
+{
+    if (frequency_hz == 0 || frequency_hz > clock_hz / 2)
+        return false;
+
+    uint64_t period = (uint64_t)clock_hz * 16;
+    uint64_t div_first = (period + (uint64_t)frequency_hz * 65536 - 1) / ((uint64_t)frequency_hz * 65536);
+    if (div_first < tone_div_min)
+        div_first = tone_div_min;
+    if (div_first > tone_div_max)
+        return false;
+
+    uint64_t best_error = UINT64_MAX, best_span = 1;
+    for (uint64_t div = div_first; div <= tone_div_max && div < div_first + tone_div_candidates; div++)
+    {
+        uint64_t step = (uint64_t)frequency_hz * div;
+        uint64_t wraps = (period + step / 2) / step; // top + 1, arredondado
+        if (wraps > 65536)
+            wraps = 65536;
+        if (wraps < 2)
+            wraps = 2;
+
+        // Erro relativo |div * wraps * f - período| / (div * wraps), comparado em frações cruzadas
+        uint64_t span = div * wraps;
+        uint64_t actual = span * frequency_hz;
+        uint64_t error = actual > period ? actual - period : period - actual;
+        if (best_error == UINT64_MAX || error * best_span < best_error * span)
+        {
+            best_error = error;
+            best_span = span;
+            divider->div = (uint16_t)div;
+            divider->top = (uint16_t)(wraps - 1);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Configura o pino do buzzer como saída PWM, em silêncio.
+ */
+void tone_init(uint pin)
+{
+    tone_pin = pin;
+    sys_clock_hz = clock_get_hz(clk_sys);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_init(pwm_gpio_to_slice_num(pin), &config, true);
+    pwm_set_gpio_level(pin, 0);
+}
+
+/**
+ * @brief Toca uma frequência até tone_stop (seguro em IRQ).
+ *
+ * @param volume 0 a 255; o duty cycle vai de 0 a 50%.
+ */
+void capture_func(tone_start)(uint32_t frequency_hz, uint8_t volume)
+{
+    tone_divider_t divider;
+    if (volume == 0 || !tone_divider(sys_clock_hz, frequency_hz, &divider))
+    {
+        tone_stop();
+        return;
+    }
+
+    uint slice_num = pwm_gpio_to_slice_num(tone_pin);
+    pwm_set_clkdiv_int_frac(slice_num, divider.div >> 4, divider.div & 0xF);
+    pwm_set_wrap(slice_num, divider.top);
+    pwm_set_gpio_level(tone_pin, (uint16_t)(((uint32_t)divider.top + 1) * volume >> 9));
+}
+
+void capture_func(tone_stop)(void)
+{
+    pwm_set_gpio_level(tone_pin, 0);
+}
+
+/**
+ * @brief Atualiza o clk_sys em cache e refaz divisor e wrap da nota em andamento depois
+ * de uma troca de clk_sys.
+ */
+void tone_clock_changed(void)
+{
+    uint32_t status = save_and_disable_interrupts();
+    sys_clock_hz = clock_get_hz(clk_sys);
+    if (playing)
+    {
+        const tone_note_t *note = &sequence[sequence_next];
+        tone_start(note->frequency_hz, note->volume);
+    }
+    restore_interrupts(status);
+}
+
+// Alarme do sequenciador: passa para a próxima nota ou encerra
+static int64_t capture_func(tone_step)(hal_alarm_t id, void *user_data)
+{
+    (void)id;
+    (void)user_data;
+
+    if (++sequence_next >= sequence_length)
+    {
+        trace_event(trace_alarm, trace_alarm_stop_buzzer);
+        tone_stop();
+        sequence_alarm = 0;
+        playing = false;
+        return 0;
+    }
+
+    trace_event(trace_alarm, trace_alarm_tone_note);
+    const tone_note_t *note = &sequence[sequence_next];
+    tone_start(note->frequency_hz, note->volume);
+    return -(int64_t)(note->duration_ms ? note->duration_ms : 1) * 1000; // 0 encerraria o alarme
+}
+
+/**
+ * @brief Começa a tocar uma lista de notas, interrompendo a anterior (e um clipe PCM);
+ * retorna em seguida.
+ */
+void capture_func(tone_play)(const tone_note_t *notes, size_t count)
+{
+    pcm_stop();
+    tone_cancel();
+    if (count == 0)
+        return;
+
+    sequence = notes;
+    sequence_length = count;
+    sequence_next = 0;
+    playing = true;
+    tone_start(notes[0].frequency_hz, notes[0].volume);
+    sequence_alarm = hal_alarm_in_ms(notes[0].duration_ms, tone_step, NULL);
+}
+
+/**
+ * @brief Interrompe a lista em andamento e silencia o buzzer.
+ */
+void capture_func(tone_cancel)(void)
+{
+    hal_alarm_cancel(sequence_alarm);
+    sequence_alarm = 0;
+    playing = false;
+    tone_stop();
+}
+
+bool capture_func(tone_playing)(void)
+{
+    return playing;
+}
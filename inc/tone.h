@@ -0,0 +1,47 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef tone_h
+#define tone_h
+
+/*
+ * Tons no buzzer por PWM: f = clk_sys / (div * (top + 1)), com div em ponto fixo 8.4
+ * (1 a 255 + 15/16) e top de 16 bits. tone_divider escolhe o par com menor erro de
+ * frequência, preferindo o maior top (mais resolução de volume); de ~8 Hz a clk_sys / 2.
+ *
+ * O sequenciador toca listas de notas a partir de um alarme: cada callback só troca o
+ * divisor, o wrap e o nível do PWM e reagenda a próxima nota relativa ao horário previsto,
+ * sem acumular atraso. A lista precisa continuar válida até o fim da reprodução.
+ */
+
+// Menor divisor (1.0) e maior (255 + 15/16), em 16 avos
+#define tone_div_min 16u
+#define tone_div_max 4095u
+
+// Divisores testados acima do mínimo que ainda cabe em 16 bits
+#define tone_div_candidates 16u
+
+typedef struct
+{
+  uint16_t div;  // Divisor 8.4 (inteiro << 4 | fração)
+  uint16_t top;  // Wrap do contador
+} tone_divider_t;
+
+typedef struct
+{
+  uint16_t frequency_hz; // 0: pausa
+  uint16_t duration_ms;
+  uint8_t volume;        // 0 a 255 (255 = 50% de duty)
+} tone_note_t;
+
+bool tone_divider(uint32_t clock_hz, uint32_t frequency_hz, tone_divider_t *divider);
+void tone_init(unsigned pin);
+void tone_start(uint32_t frequency_hz, uint8_t volume);
+void tone_stop(void);
+void tone_clock_changed(void);
+void tone_play(const tone_note_t *notes, size_t count);
+void tone_cancel(void);
+bool tone_playing(void);
+
+#endif
@@ -0,0 +1,55 @@
+#include "pico/stdlib.h"
+#include "trace.h"
+#include "telemetry.h"
+
+trace_record_t trace_ring[trace_ring_length];
+volatile uint32_t trace_head;
+
+// Envio em andamento: [dump_next, dump_end) do anel, com a base para estender os tempos
+static uint32_t dump_next, dump_end;
+static uint64_t dump_base_us;
+static uint32_t dump_base_32;
+static bool dumping;
+
+/**
+ * @brief Inicia o envio do anel pela telemetria (os eventos até este instante).
+ */
+void trace_request_dump(void)
+{
+    if (dumping)
+        return;
+
+    dump_end = trace_head;
+    dump_next = dump_end > trace_ring_length ? dump_end - trace_ring_length : 0;
+    dump_base_us = time_us_64();
+    dump_base_32 = (uint32_t)dump_base_us;
+    dumping = dump_next != dump_end;
+}
+
+/**
+ * @brief Repassa registros do anel à fila de telemetria, só até onde houver espaço.
+ *
+ * Chamada do laço principal. Os tempos de 32 bits são estendidos para o relógio de 64 bits
+ * (válido para eventos das últimas ~71 min). Se o anel der a volta durante o envio, os
+ * registros sobrescritos são pulados.
+ */
+void trace_service(void)
+{
+    while (dumping && telemetry_free() > 0)
+    {
+        if (trace_head - dump_next > trace_ring_length)
+            dump_next = trace_head - trace_ring_length;
+
+        trace_record_t record = trace_ring[dump_next % trace_ring_length];
+        uint64_t time_us = dump_base_us - (uint32_t)(dump_base_32 - record.time_us);
+        telemetry_push_at(time_us, telemetry_type_trace, record.id, record.arg);
+
+        dumping = ++dump_next != dump_end;
+    }
+}
+
+// Envio do anel em andamento (trace_service ainda tem registros a repassar)
+bool trace_dumping(void)
+{
+    return dumping;
+}
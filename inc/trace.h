@@ -0,0 +1,53 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "trace_events.h"
+
+#ifndef trace_h
+#define trace_h
+
+/*
+ * Trace em RAM: anel de registros de 8 bytes (instante em µs do temporizador, evento e
+ * argumento) gravados por trace_event() nos pontos instrumentados. Custa uma leitura de
+ * TIMERAWL, uma máscara de IRQs e uma escrita de 8 bytes; pode ser chamado de IRQ.
+ *
+ * O anel guarda os últimos trace_ring_length eventos e é enviado sob demanda ('T' recebido
+ * pela USB) como registros telemetry_type_trace; tools/trace_export converte a captura em
+ * JSON do Chrome/Perfetto. Compile com LIGEIRINHO_TRACE=0 para remover a instrumentação.
+ */
+
+#ifndef LIGEIRINHO_TRACE
+#define LIGEIRINHO_TRACE 1
+#endif
+
+// Registros no anel (potência de 2): 512 * 8 bytes = 4 KB de RAM
+#define trace_ring_length 512
+
+extern trace_record_t trace_ring[trace_ring_length];
+extern volatile uint32_t trace_head;
+
+/**
+ * @brief Registra um evento no anel (seguro em IRQ).
+ */
+static inline void trace_event(uint16_t id, uint16_t arg)
+{
+#if LIGEIRINHO_TRACE
+  uint32_t time_us = time_us_32();
+  uint32_t irq_state = save_and_disable_interrupts();
+  trace_record_t *record = &trace_ring[trace_head++ % trace_ring_length];
+  record->time_us = time_us;
+  record->id = id;
+  record->arg = arg;
+  restore_interrupts(irq_state);
+#else
+  (void)id;
+  (void)arg;
+#endif
+}
+
+void trace_request_dump(void);
+void trace_service(void);
+bool trace_dumping(void);
+
+#endif
@@ -0,0 +1,30 @@
+#include <stdint.h>
+
+#ifndef trace_events_h
+#define trace_events_h
+
+// Formato dos registros do trace em RAM (inc/trace.h), compartilhado com tools/trace_export
+
+// Eventos                    argumento
+#define trace_gpio_irq 1     // GPIO | (eventos << 8), na entrada do callback
+#define trace_alarm 2        // Alarme disparado (trace_alarm_*)
+#define trace_state 3        // Novo estado do jogo (telemetry_state_*)
+#define trace_flush_begin 4  // Bytes enviados ao display
+#define trace_flush_end 5    // Bytes enviados ao display
+#define trace_round 6        // Tempo de reação em ms (saturado em 65535)
+#define trace_wake 7         // Do despertar até a firmware pronta, em µs (registrado no fim)
+#define trace_clock 8        // Novo clk_sys, em MHz
+#define trace_boot 9         // Fase do boot concluída (boot_phase_*, inc/boot.h)
+
+// Alarmes identificados em trace_alarm
+#define trace_alarm_stop_buzzer 1 // Fim do som (última nota do sequenciador, inc/tone.h)
+#define trace_alarm_tone_note 2   // Próxima nota do sequenciador
+
+typedef struct
+{
+  uint32_t time_us;
+  uint16_t id;
+  uint16_t arg;
+} trace_record_t;
+
+#endif
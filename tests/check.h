@@ -0,0 +1,35 @@
+#include <stdio.h>
+
+#ifndef check_h
+#define check_h
+
+/*
+ * Verificações dos testes no host (tests/, rodados pelo ctest): uma falha imprime o arquivo,
+ * a linha e a mensagem, e o teste continua para mostrar as demais. main() termina com
+ * check_result(), que dá o código de saída.
+ */
+
+static int check_failures;
+
+#define check(condition, ...)                                                                \
+  do                                                                                         \
+  {                                                                                          \
+    if (!(condition))                                                                        \
+    {                                                                                        \
+      fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);                                        \
+      fprintf(stderr, __VA_ARGS__);                                                          \
+      fputc('\n', stderr);                                                                   \
+      check_failures++;                                                                      \
+    }                                                                                        \
+  } while (0)
+
+static inline int check_result(const char *name)
+{
+  if (check_failures)
+    fprintf(stderr, "%s: %d falha(s)\n", name, check_failures);
+  else
+    printf("%s: ok\n", name);
+  return check_failures ? 1 : 0;
+}
+
+#endif
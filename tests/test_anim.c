@@ -0,0 +1,519 @@
+// Formato das animações (inc/anim.h) de ponta a ponta: quadros gerados aqui viram PNGs, o
+// tools/anim_encode os codifica, e anim_apply (inc/anim.c) os reconstrói, conferidos pixel a
+// pixel. Os PNGs variam tipo de cor, profundidade, filtros e compressão (blocos sem compressão e
+// Huffman fixo com repetições), para passar pelo inflate e pelo decodificador do encoder. Depois,
+// quadros truncados e operações que saem da tela, que anim_apply recusa.
+//
+// Uso: test_anim <anim_encode> <diretório de trabalho>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+#include "inc/anim.h"
+
+#define frame_count 10
+
+// Pixels de um quadro de 128x64 (1: aceso)
+typedef uint8_t pixels_t[ssd1306_height][ssd1306_width];
+
+static pixels_t frames[frame_count];
+static char path[512];
+
+static uint32_t lcg = 12345;
+
+static uint32_t next_random(void)
+{
+    lcg = lcg * 1664525u + 1013904223u;
+    return lcg >> 8;
+}
+
+// ---------------------------------------------------------------------------------------
+// Quadros de teste: tela apagada, formas em movimento, tela cheia, ruído (cópias de 128
+// colunas), quadro repetido (sem páginas alteradas) e listras de colunas curtas
+
+static void fill_rect(pixels_t p, int x0, int y0, int w, int h, uint8_t on)
+{
+    for (int y = y0; y < y0 + h && y < ssd1306_height; y++)
+        for (int x = x0; x < x0 + w && x < ssd1306_width; x++)
+            p[y][x] = on;
+}
+
+static void generate_frames(void)
+{
+    memset(frames, 0, sizeof(frames));
+    for (int f = 1; f <= 3; f++)
+    {
+        fill_rect(frames[f], f * 30, f * 9, 20, 14, 1);
+        fill_rect(frames[f], 0, 60, 128, 4, f & 1);
+        frames[f][5][127] = 1;
+    }
+    fill_rect(frames[4], 0, 0, 128, 64, 1);
+    fill_rect(frames[4], 60, 20, 3, 24, 0);
+    for (int y = 0; y < ssd1306_height; y++)
+        for (int x = 0; x < ssd1306_width; x++)
+            frames[5][y][x] = next_random() & 1;
+    memcpy(frames[6], frames[5], sizeof(pixels_t));
+    for (int y = 0; y < ssd1306_height; y++)
+        for (int x = 0; x < ssd1306_width; x++)
+            frames[7][y][x] = (x / 2 + y / 16) % 2;
+    fill_rect(frames[8], 126, 62, 2, 2, 1);
+    for (int y = 0; y < 32; y++)
+        for (int x = 0; x < ssd1306_width; x++)
+            frames[9][y][x] = (x ^ y) % 3 == 0;
+}
+
+// Quadro no formato do display: página a página, bit n = linha 8 * página + n
+static void to_display(const pixels_t p, uint8_t *frame)
+{
+    memset(frame, 0, ssd1306_buffer_length);
+    for (int y = 0; y < ssd1306_height; y++)
+        for (int x = 0; x < ssd1306_width; x++)
+            if (p[y][x])
+                frame[(y / 8) * ssd1306_width + x] |= 1u << (y % 8);
+}
+
+// ---------------------------------------------------------------------------------------
+// Escrita de PNG
+
+static uint32_t crc_table[256];
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length)
+{
+    if (!crc_table[1])
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            crc_table[n] = c;
+        }
+    }
+    for (size_t i = 0; i < length; i++)
+        crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void put32(uint8_t *p, uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = value >> 16;
+    p[2] = value >> 8;
+    p[3] = value;
+}
+
+static void write_chunk(FILE *file, const char *type, const uint8_t *data, size_t length)
+{
+    uint8_t header[8];
+    put32(header, (uint32_t)length);
+    memcpy(header + 4, type, 4);
+    fwrite(header, 1, 8, file);
+    if (length)
+        fwrite(data, 1, length, file);
+    uint32_t crc = crc32_update(0xFFFFFFFFu, (const uint8_t *)type, 4);
+    crc = (length ? crc32_update(crc, data, length) : crc) ^ 0xFFFFFFFFu;
+    put32(header, crc);
+    fwrite(header, 1, 4, file);
+}
+
+// Fluxo de bits do deflate (LSB primeiro)
+typedef struct
+{
+    uint8_t *out;
+    size_t length;
+    uint32_t bits;
+    int count;
+} bit_writer_t;
+
+static void put_bits(bit_writer_t *w, uint32_t value, int count)
+{
+    w->bits |= value << w->count;
+    w->count += count;
+    while (w->count >= 8)
+    {
+        w->out[w->length++] = (uint8_t)w->bits;
+        w->bits >>= 8;
+        w->count -= 8;
+    }
+}
+
+// Códigos de Huffman vão do bit mais alto ao mais baixo
+static void put_code(bit_writer_t *w, uint32_t code, int count)
+{
+    for (int i = count - 1; i >= 0; i--)
+        put_bits(w, (code >> i) & 1, 1);
+}
+
+static void put_literal(bit_writer_t *w, int symbol)
+{
+    if (symbol < 144)
+        put_code(w, 0x30 + symbol, 8);
+    else if (symbol < 256)
+        put_code(w, 0x190 + symbol - 144, 9);
+    else if (symbol < 280)
+        put_code(w, symbol - 256, 7);
+    else
+        put_code(w, 0xC0 + symbol - 280, 8);
+}
+
+// Repetição do byte anterior (distância 1), length de 3 a 258
+static void put_repeat(bit_writer_t *w, int length)
+{
+    static const uint16_t base[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    int code = 28;
+    while (base[code] > length)
+        code--;
+    put_literal(w, 257 + code);
+    put_bits(w, length - base[code], extra[code]);
+    put_code(w, 0, 5); // Distância 1
+}
+
+// zlib com blocos sem compressão (fixed = false) ou um bloco de Huffman fixo com repetições
+static size_t deflate(const uint8_t *data, size_t length, bool fixed, uint8_t *out)
+{
+    size_t pos = 0;
+    out[pos++] = 0x78;
+    out[pos++] = 0x01;
+
+    if (!fixed)
+    {
+        // Blocos de até 1000 bytes, para ter mais de um
+        for (size_t start = 0; start < length || start == 0; start += 1000)
+        {
+            size_t count = length - start > 1000 ? 1000 : length - start;
+            out[pos++] = start + count >= length;
+            out[pos++] = count & 0xFF;
+            out[pos++] = count >> 8;
+            out[pos++] = ~count & 0xFF;
+            out[pos++] = (~count >> 8) & 0xFF;
+            memcpy(out + pos, data + start, count);
+            pos += count;
+            if (start + count >= length)
+                break;
+        }
+    }
+    else
+    {
+        bit_writer_t w = {.out = out + pos};
+        put_bits(&w, 1, 1); // Último bloco
+        put_bits(&w, 1, 2); // Huffman fixo
+        for (size_t i = 0; i < length;)
+        {
+            size_t run = 0;
+            while (i > 0 && i + run < length && run < 258 && data[i + run] == data[i - 1])
+                run++;
+            if (run >= 3)
+            {
+                put_repeat(&w, (int)run);
+                i += run;
+            }
+            else
+            {
+                put_literal(&w, data[i++]);
+            }
+        }
+        put_literal(&w, 256);
+        put_bits(&w, 0, 7); // Completa o último byte
+        pos += w.length;
+    }
+
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32(out + pos, b << 16 | a);
+    return pos + 4;
+}
+
+static int paeth(int a, int b, int c)
+{
+    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/**
+ * Grava o quadro como PNG de 128 x height, no tipo de cor e profundidade dados (0: cinza,
+ * 2: RGB, 3: paleta, 4: cinza com alfa, 6: RGBA). Pixels apagados recebem valores abaixo do
+ * limiar (ou alfa baixo); cada linha usa um dos cinco filtros.
+ */
+static bool write_png(const char *file_path, const pixels_t p, int height, int color, int depth, bool fixed)
+{
+    static const int channels_of[7] = {1, 0, 3, 1, 2, 0, 4};
+    int channels = channels_of[color];
+    size_t bpp = (size_t)channels * depth / 8 ? (size_t)channels * depth / 8 : 1;
+    size_t stride = ((size_t)ssd1306_width * channels * depth + 7) / 8;
+    static uint8_t raw[ssd1306_height][ssd1306_width * 8];
+    static uint8_t filtered[ssd1306_height * (ssd1306_width * 8 + 1)];
+    static uint8_t compressed[2 * sizeof(filtered) + 1024];
+
+    memset(raw, 0, sizeof(raw));
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < ssd1306_width; x++)
+        {
+            bool on = p[y][x];
+            uint32_t samples[4];
+            uint32_t max = (1u << depth) - 1;
+            if (color == 3)
+                samples[0] = on ? 1 + (x + y) % 2 : (x % 3 == 0 ? 3 : 0);
+            else if (color == 4 || color == 6)
+            {
+                // Apagado: claro mas transparente em metade dos pixels
+                bool transparent = !on && (x + y) % 2;
+                uint32_t value = on || transparent ? max : max / 4;
+                for (int ch = 0; ch < channels - 1; ch++)
+                    samples[ch] = value;
+                samples[channels - 1] = transparent ? max / 8 : max;
+            }
+            else
+            {
+                for (int ch = 0; ch < channels; ch++)
+                    samples[ch] = on ? max - ch : (depth == 1 ? 0 : max / 3);
+            }
+
+            for (int ch = 0; ch < channels; ch++)
+            {
+                size_t bit = ((size_t)x * channels + ch) * depth;
+                if (depth == 16)
+                {
+                    raw[y][bit / 8] = samples[ch] >> 8;
+                    raw[y][bit / 8 + 1] = samples[ch] & 0xFF;
+                }
+                else
+                {
+                    raw[y][bit / 8] |= samples[ch] << (8 - depth - bit % 8);
+                }
+            }
+        }
+    }
+
+    size_t length = 0;
+    for (int y = 0; y < height; y++)
+    {
+        int filter = y % 5;
+        filtered[length++] = filter;
+        for (size_t i = 0; i < stride; i++)
+        {
+            int a = i >= bpp ? raw[y][i - bpp] : 0, b = y ? raw[y - 1][i] : 0;
+            int c = i >= bpp && y ? raw[y - 1][i - bpp] : 0;
+            int predictor = filter == 1 ? a : filter == 2 ? b : filter == 3 ? (a + b) / 2 : filter == 4 ? paeth(a, b, c) : 0;
+            filtered[length++] = (uint8_t)(raw[y][i] - predictor);
+        }
+    }
+    size_t size = deflate(filtered, length, fixed, compressed);
+
+    FILE *file = fopen(file_path, "wb");
+    if (!file)
+        return false;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    fwrite(signature, 1, 8, file);
+    uint8_t header[13] = {0};
+    put32(header, ssd1306_width);
+    put32(header + 4, height);
+    header[8] = depth;
+    header[9] = color;
+    write_chunk(file, "IHDR", header, sizeof(header));
+    if (color == 3)
+    {
+        static const uint8_t palette[] = {0, 0, 0, 255, 255, 255, 200, 180, 160, 40, 40, 40};
+        write_chunk(file, "PLTE", palette, sizeof(palette));
+    }
+    // Dados em dois IDAT, que o encoder junta
+    write_chunk(file, "IDAT", compressed, size / 2);
+    write_chunk(file, "IDAT", compressed + size / 2, size - size / 2);
+    write_chunk(file, "IEND", NULL, 0);
+    return fclose(file) == 0;
+}
+
+// ---------------------------------------------------------------------------------------
+// Saída do encoder: os bytes e o número de quadros do cabeçalho C gerado
+
+static uint8_t clip_data[64 * 1024];
+
+static size_t read_clip(const char *file_path, uint32_t *frame_total)
+{
+    static char text[512 * 1024];
+    FILE *file = fopen(file_path, "r");
+    if (!file)
+        return 0;
+    size_t size = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    text[size] = '\0';
+
+    const char *frames_field = strstr(text, ".frames = ");
+    const char *start = strstr(text, "_data[");
+    start = start ? strchr(start, '{') : NULL;
+    if (!frames_field || !start)
+        return 0;
+    *frame_total = (uint32_t)strtoul(frames_field + 10, NULL, 10);
+
+    size_t length = 0;
+    char *end;
+    for (const char *p = start + 1; length < sizeof(clip_data); p = end + 1)
+    {
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p)
+            break;
+        clip_data[length++] = (uint8_t)value;
+    }
+    return length;
+}
+
+/**
+ * Codifica os quadros [first, first + count) com PNGs de height linhas (cada quadro num tipo
+ * de PNG da tabela) e confere a reconstrução por anim_apply, quadro a quadro.
+ *
+ * @return Bytes do clipe (em clip_data), 0 se algo falhou.
+ */
+static size_t encode_and_check(const char *encoder, const char *dir, int first, int count, int height)
+{
+    static const struct
+    {
+        int color, depth;
+        bool fixed;
+    } formats[] = {{0, 8, false}, {0, 1, true}, {2, 8, true}, {3, 2, false}, {4, 8, true},
+                   {6, 8, false}, {0, 16, true}, {6, 16, true}, {3, 4, true}, {0, 4, false}};
+    char command[16384];
+    int len = snprintf(command, sizeof(command), "%s --name test_clip --frame-ms 40", encoder);
+
+    for (int f = first; f < first + count; f++)
+    {
+        int format = f % (int)(sizeof(formats) / sizeof(formats[0]));
+        snprintf(path, sizeof(path), "%s/quadro%02d.png", dir, f);
+        check(write_png(path, frames[f], height, formats[format].color, formats[format].depth, formats[format].fixed),
+              "PNG %s não gravado", path);
+        len += snprintf(command + len, sizeof(command) - len, " %s", path);
+    }
+    snprintf(path, sizeof(path), "%s/clipe%d.h", dir, height);
+    snprintf(command + len, sizeof(command) - len, " > %s", path);
+    if (system(command) != 0)
+    {
+        check(false, "anim_encode falhou: %s", command);
+        return 0;
+    }
+
+    uint32_t frame_total = 0;
+    size_t length = read_clip(path, &frame_total);
+    check(length > 0 && frame_total == (uint32_t)count, "%s: %zu bytes, %u quadros", path, length, frame_total);
+
+    uint8_t frame[ssd1306_buffer_length] = {0}, expected[ssd1306_buffer_length];
+    size_t offset = 0;
+    for (int f = first; f < first + count && offset < length; f++)
+    {
+        uint8_t before[ssd1306_buffer_length];
+        anim_span_t spans[ssd1306_n_pages];
+        memcpy(before, frame, sizeof(before));
+        size_t used = anim_apply(frame, clip_data + offset, length - offset, spans);
+        check(used > 0, "altura %d, quadro %d recusado por anim_apply", height, f);
+        if (!used)
+            return 0;
+        offset += used;
+
+        pixels_t cropped;
+        memset(cropped, 0, sizeof(cropped));
+        memcpy(cropped, frames[f], (size_t)height * ssd1306_width);
+        to_display(cropped, expected);
+        for (int y = 0; y < ssd1306_height; y++)
+        {
+            for (int x = 0; x < ssd1306_width; x++)
+            {
+                bool got = frame[(y / 8) * ssd1306_width + x] >> (y % 8) & 1;
+                if (got != cropped[y][x])
+                {
+                    check(false, "altura %d, quadro %d: pixel (%d, %d) %d, esperado %d", height, f, x, y, got,
+                          cropped[y][x]);
+                    y = ssd1306_height;
+                    break;
+                }
+            }
+        }
+
+        // As faixas cobrem toda coluna que mudou
+        for (int page = 0; page < ssd1306_n_pages; page++)
+        {
+            for (int x = 0; x < ssd1306_width; x++)
+            {
+                int index = page * ssd1306_width + x;
+                if (before[index] != frame[index] && (x < spans[page].first || x > spans[page].last))
+                    check(false, "altura %d, quadro %d: coluna %d da página %d fora da faixa %u-%u", height, f, x,
+                          page, spans[page].first, spans[page].last);
+            }
+        }
+    }
+    check(offset == length, "altura %d: %zu de %zu bytes consumidos", height, offset, length);
+    return length;
+}
+
+// Um quadro montado à mão deve ser recusado (0) sem escrever fora do quadro
+static void check_rejected(const char *what, const uint8_t *delta, size_t length)
+{
+    uint8_t frame[ssd1306_buffer_length + 16];
+    anim_span_t spans[ssd1306_n_pages];
+    memset(frame, 0xA5, sizeof(frame));
+    check(anim_apply(frame, delta, length, spans) == 0, "%s aceito", what);
+    for (size_t i = ssd1306_buffer_length; i < sizeof(frame); i++)
+    {
+        if (frame[i] != 0xA5)
+        {
+            check(false, "%s escreveu além do quadro", what);
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "uso: test_anim <anim_encode> <diretório>\n");
+        return 2;
+    }
+    generate_frames();
+
+    // Clipes de 64 linhas (todos os quadros) e de 32 linhas (as páginas de baixo ficam apagadas)
+    size_t length = encode_and_check(argv[1], argv[2], 0, frame_count, 64);
+    encode_and_check(argv[1], argv[2], 1, 5, 32);
+
+    // Todo prefixo de cada quadro do clipe de 64 linhas é truncado
+    uint8_t frame[ssd1306_buffer_length] = {0};
+    anim_span_t spans[ssd1306_n_pages];
+    for (size_t offset = 0, used; offset < length; offset += used)
+    {
+        uint8_t scratch[ssd1306_buffer_length];
+        used = anim_apply(frame, clip_data + offset, length - offset, spans);
+        if (!used)
+            break;
+        for (size_t cut = 0; cut < used; cut++)
+        {
+            memcpy(scratch, frame, sizeof(scratch));
+            if (anim_apply(scratch, clip_data + offset, cut, spans) != 0)
+            {
+                check(false, "quadro em %zu truncado em %zu bytes aceito", offset, cut);
+                break;
+            }
+        }
+    }
+    check_rejected("quadro vazio", (const uint8_t[]){0}, 0);
+
+    // Operações que passam da coluna 127
+    check_rejected("cópia além da tela", (const uint8_t[]){0x01, 0x3F, 0x3F, 0x01, 0x81, 1, 2, 0x00}, 8);
+    check_rejected("repetição além da tela", (const uint8_t[]){0x80, 0x3F, 0x3F, 0x7F, 0xFF, 0x00}, 6);
+    check_rejected("salto e cópia de 128", (const uint8_t[]){0x01, 0x01, 0xFF}, 3);
+    check_rejected("cópia sem os bytes", (const uint8_t[]){0x01, 0x83, 1, 2}, 4);
+
+    // No limite: 64 + 63 colunas puladas e a última repetida vale
+    uint8_t last[] = {0x01, 0x3F, 0x3F, 0x01, 0x40, 0x80, 0x00};
+    memset(frame, 0, sizeof(frame));
+    check(anim_apply(frame, last, sizeof(last), spans) == sizeof(last) && frame[127] == 0x80 &&
+              spans[0].first == 127 && spans[0].last == 127,
+          "repetição na coluna 127 recusada");
+
+    return check_result("anim");
+}
@@ -0,0 +1,160 @@
+// Máquina de estados da rodada (inc/game.c) com entradas e instantes montados à mão: início,
+// queima de largada, estímulo, captura, tempo limite e a sessão (resultado, próxima
+// preparação depois do intervalo e resumo no fim).
+
+#include <stdint.h>
+#include <stdio.h>
+#include "check.h"
+#include "inc/game.h"
+
+#define player_pin (1u << 6)
+#define other_pin (1u << 22)
+#define round_timeout_ms 3000
+#define session_iti_ms 1500
+#define round_foreperiod_ms 2000
+
+static game_t game;
+static game_input_t input;
+
+static const char *const state_names[] = {"idle", "foreperiod", "reaction", "result", "false_start"};
+
+static const char *state_name(uint8_t state)
+{
+    return state < sizeof(state_names) / sizeof(state_names[0]) ? state_names[state] : "?";
+}
+
+// Um passo da máquina, conferindo a ação e o estado seguinte
+static void step(const char *what, uint64_t now_us, game_action_t action, uint8_t state)
+{
+    uint8_t before = game.state;
+    game_action_t result = game_step(&game, &input, now_us);
+
+    check(result == action && game.state == state, "%s em %llu µs (%s): ação %d e estado %s, esperados %d e %s", what,
+          (unsigned long long)now_us, state_name(before), result, state_name(game.state), action, state_name(state));
+}
+
+static void reset_input(void)
+{
+    input = (game_input_t){.foreperiod_ms = round_foreperiod_ms};
+}
+
+int main(void)
+{
+    game_init(&game, player_pin, round_timeout_ms);
+    reset_input();
+
+    // Rodada avulsa: nada acontece sem o botão A
+    step("espera", 1000, game_action_none, telemetry_state_idle);
+    input.pressed = player_pin;
+    step("botão B na espera", 2000, game_action_none, telemetry_state_idle);
+    reset_input();
+    input.start = true;
+    step("botão A", 10000, game_action_prepare, telemetry_state_foreperiod);
+    check(game.phase_end_us == 10000 + round_foreperiod_ms * 1000, "prazo do estímulo em %llu µs",
+          (unsigned long long)game.phase_end_us);
+
+    // Queima de largada: só pinos dos jogadores contam
+    reset_input();
+    input.pressed = other_pin;
+    step("outro pino na preparação", 500000, game_action_none, telemetry_state_foreperiod);
+    input.pressed = player_pin | other_pin;
+    step("botão B na preparação", 600000, game_action_false_start, telemetry_state_false_start);
+    check(game.early == player_pin, "pinos da queima 0x%08x", game.early);
+    check(game.phase_end_us == 600000 + game_false_start_ms * 1000, "fim da tela de queima em %llu µs",
+          (unsigned long long)game.phase_end_us);
+    reset_input();
+    step("tela de queima", 600000 + game_false_start_ms * 1000 - 1, game_action_none, telemetry_state_false_start);
+    input.start = true;
+    step("botão A na tela de queima", 600000 + game_false_start_ms * 1000 - 1, game_action_none,
+         telemetry_state_false_start);
+    reset_input();
+    step("fim da tela de queima", 600000 + game_false_start_ms * 1000, game_action_idle, telemetry_state_idle);
+
+    // Estímulo, captura e tempo limite
+    input.start = true;
+    step("botão A", 3000000, game_action_prepare, telemetry_state_foreperiod);
+    reset_input();
+    step("prazo sem estímulo apresentado", 5000000, game_action_none, telemetry_state_foreperiod);
+    input.onset_us = 5000120;
+    step("estímulo", 5000130, game_action_stimulus, telemetry_state_reaction);
+    check(game.phase_start_us == 5000120 && game.phase_end_us == 5000120 + round_timeout_ms * 1000,
+          "reação de %llu a %llu µs", (unsigned long long)game.phase_start_us, (unsigned long long)game.phase_end_us);
+    input.pressed = player_pin;
+    step("botão B sem captura", 5200000, game_action_none, telemetry_state_reaction);
+    reset_input();
+    step("tempo limite", 5000120 + round_timeout_ms * 1000, game_action_result, telemetry_state_result);
+    check(game.phase_end_us == 5000120 + (round_timeout_ms + game_result_ms) * 1000,
+          "fim da tela de resultado em %llu µs", (unsigned long long)game.phase_end_us);
+    step("fim da tela de resultado", game.phase_end_us, game_action_idle, telemetry_state_idle);
+
+    input.start = true;
+    step("botão A", 20000000, game_action_prepare, telemetry_state_foreperiod);
+    reset_input();
+    input.onset_us = 22000000;
+    step("estímulo", 22000010, game_action_stimulus, telemetry_state_reaction);
+    input.captured = true;
+    step("captura", 22250000, game_action_result, telemetry_state_result);
+
+    // Sem tempo limite, a reação só termina na captura
+    game_init(&game, player_pin, 0);
+    input.start = true;
+    step("botão A sem tempo limite", 40000000, game_action_prepare, telemetry_state_foreperiod);
+    reset_input();
+    input.onset_us = 42000000;
+    step("estímulo sem tempo limite", 42000000, game_action_stimulus, telemetry_state_reaction);
+    check(game.phase_end_us == 0, "prazo da reação sem tempo limite: %llu µs", (unsigned long long)game.phase_end_us);
+    step("uma hora depois", 42000000 + 3600000000ull, game_action_none, telemetry_state_reaction);
+    input.captured = true;
+    step("captura sem tempo limite", 42000000 + 3600000001ull, game_action_result, telemetry_state_result);
+
+    // Sessão de três rodadas: resultado, queima e resultado, cada tela durando o intervalo
+    game_init(&game, player_pin, round_timeout_ms);
+    game_session(&game, 3, session_iti_ms);
+    reset_input();
+    input.start = true;
+    uint64_t now_us = 100000000;
+    step("botão A na sessão", now_us, game_action_prepare, telemetry_state_foreperiod);
+    check(game.session_round == 1, "rodada %u da sessão", game.session_round);
+
+    reset_input();
+    input.onset_us = now_us + round_foreperiod_ms * 1000;
+    step("estímulo da 1ª rodada", input.onset_us, game_action_stimulus, telemetry_state_reaction);
+    input.captured = true;
+    now_us = input.onset_us + 300000;
+    step("captura da 1ª rodada", now_us, game_action_result, telemetry_state_result);
+    check(game.phase_end_us == now_us + session_iti_ms * 1000, "resultado na sessão até %llu µs",
+          (unsigned long long)game.phase_end_us);
+
+    reset_input();
+    step("intervalo", now_us + session_iti_ms * 1000 - 1, game_action_none, telemetry_state_result);
+    now_us += session_iti_ms * 1000;
+    step("resultado -> preparação", now_us, game_action_prepare, telemetry_state_foreperiod);
+    check(game.session_round == 2 && game.phase_end_us == now_us + round_foreperiod_ms * 1000,
+          "rodada %u com estímulo em %llu µs", game.session_round, (unsigned long long)game.phase_end_us);
+
+    input.pressed = player_pin;
+    now_us += 400000;
+    step("queima da 2ª rodada", now_us, game_action_false_start, telemetry_state_false_start);
+    check(game.phase_end_us == now_us + session_iti_ms * 1000, "queima na sessão até %llu µs",
+          (unsigned long long)game.phase_end_us);
+    reset_input();
+    now_us += session_iti_ms * 1000;
+    step("queima -> preparação", now_us, game_action_prepare, telemetry_state_foreperiod);
+    check(game.session_round == 3 && game.early == 0, "rodada %u, pinos da queima 0x%08x", game.session_round,
+          game.early);
+
+    input.onset_us = now_us + round_foreperiod_ms * 1000;
+    step("estímulo da 3ª rodada", input.onset_us, game_action_stimulus, telemetry_state_reaction);
+    reset_input();
+    now_us = game.phase_end_us;
+    step("tempo limite da 3ª rodada", now_us, game_action_result, telemetry_state_result);
+    now_us += session_iti_ms * 1000;
+    step("fim da sessão", now_us, game_action_summary, telemetry_state_idle);
+
+    // Depois do resumo, o botão A começa outra sessão da rodada 1
+    input.start = true;
+    step("nova sessão", now_us + 1000000, game_action_prepare, telemetry_state_foreperiod);
+    check(game.session_round == 1, "nova sessão na rodada %u", game.session_round);
+
+    return check_result("game");
+}
@@ -0,0 +1,111 @@
+// Captura de vários jogadores (inc/multi_capture.c) com leituras do banco de GPIOs montadas
+// à mão: pressões a 1 µs, pressões na mesma leitura (empate) e bounce depois da captura.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+#include "inc/multi_capture.h"
+
+// Os GPIOs da firmware: B, botão do joystick e os dois conectores extras
+static const uint8_t pins[] = {6, 22, 16, 17};
+#define player_pin(player) (1u << pins[player])
+
+#define stimulus_us 5000000ull
+
+static multi_capture_t capture;
+
+static void check_rank(const char *step, size_t expected_ranked, const uint8_t *expected_order)
+{
+    uint8_t order[multi_capture_max_players];
+    size_t ranked = multi_capture_rank(&capture, order);
+
+    check(ranked == expected_ranked, "%s: %zu jogadores classificados, esperados %zu", step, ranked,
+          expected_ranked);
+    for (size_t place = 0; place < capture.count; place++)
+    {
+        check(order[place] == expected_order[place], "%s: %zuº lugar J%u, esperado J%u", step, place + 1,
+              order[place] + 1, expected_order[place] + 1);
+    }
+}
+
+static void check_gap(const char *step, uint8_t ahead, uint8_t behind, uint64_t expected_us)
+{
+    uint64_t gap_us = capture.time_us[behind] - capture.time_us[ahead];
+    check(gap_us == expected_us, "%s: diferença J%u-J%u de %llu µs, esperada %llu", step, behind + 1, ahead + 1,
+          (unsigned long long)gap_us, (unsigned long long)expected_us);
+}
+
+// Linha de uma colocação no texto do display (15 caracteres por linha, depois do cabeçalho)
+static void check_line(const char *step, size_t place, const char *expected)
+{
+    char text[16 * (multi_capture_max_players + 1)];
+    char line[16];
+
+    multi_capture_format(&capture, text, sizeof(text));
+    snprintf(line, sizeof(line), "%-15.15s", expected);
+    check(!strncmp(text + 15 * place, line, 15), "%s: linha %zu \"%.15s\", esperada \"%s\"", step, place,
+          text + 15 * place, line);
+}
+
+int main(void)
+{
+    multi_capture_init(&capture, pins, 3);
+    check(capture.count == 3 && capture.pin_mask == (player_pin(0) | player_pin(1) | player_pin(2)),
+          "três jogadores: máscara 0x%08x", capture.pin_mask);
+
+    // Desarmado (antes do estímulo) nada é capturado
+    check(multi_capture_sample(&capture, player_pin(0), stimulus_us - 1000) == 0, "captura antes de armar");
+    multi_capture_arm(&capture, stimulus_us);
+    check(multi_capture_sample(&capture, 1u << 5, stimulus_us + 1000) == 0, "captura de um GPIO sem jogador");
+
+    // Pressões a 1 µs: J2 primeiro; na leitura seguinte J2 continua pressionado junto com J1
+    check(multi_capture_sample(&capture, player_pin(1), stimulus_us + 183402) == 1u << 1, "J2 não capturado");
+    check(multi_capture_sample(&capture, player_pin(0) | player_pin(1), stimulus_us + 183403) == 1u << 0,
+          "segunda leitura capturou outro jogador além de J1");
+    check(!multi_capture_complete(&capture), "rodada completa sem J3");
+    check_rank("1 µs", 2, (const uint8_t[]){1, 0, 2});
+    check_gap("1 µs", 1, 0, 1);
+    check(multi_capture_reaction_us(&capture, 1) == 183402, "tempo de J2: %u",
+          multi_capture_reaction_us(&capture, 1));
+    check_line("1 µs", 1, "1 J2 183402");
+    check_line("1 µs", 2, "2 J1 D 1");
+    check_line("1 µs", 3, "3 J3 SEM");
+
+    // Mesma leitura do banco: empate, desfeito pelo número do jogador, qualquer que seja a
+    // ordem em que os IRQs foram despachados
+    multi_capture_arm(&capture, stimulus_us);
+    check(multi_capture_sample(&capture, player_pin(2) | player_pin(0), stimulus_us + 250000) ==
+              ((1u << 0) | (1u << 2)),
+          "leitura única não capturou J1 e J3 juntos");
+    check(multi_capture_sample(&capture, player_pin(2) | player_pin(0), stimulus_us + 250004) == 0,
+          "o segundo IRQ da mesma pressão recapturou");
+    check(multi_capture_sample(&capture, player_pin(1), stimulus_us + 400000) == 1u << 1, "J2 não capturado");
+    check(multi_capture_complete(&capture), "rodada incompleta com os três jogadores");
+    check_rank("empate", 3, (const uint8_t[]){0, 2, 1});
+    check_gap("empate", 0, 2, 0);
+    check_gap("empate", 2, 1, 150000);
+    check_line("empate", 2, "2 J3 D 0");
+
+    // Bounce depois da captura: soltar e pressionar de novo não muda o tempo de J1
+    multi_capture_arm(&capture, stimulus_us);
+    check(multi_capture_sample(&capture, player_pin(0), stimulus_us + 210000) == 1u << 0, "J1 não capturado");
+    for (uint64_t bounce_us = 50; bounce_us <= 2000; bounce_us += 150)
+    {
+        check(multi_capture_sample(&capture, player_pin(0), stimulus_us + 210000 + bounce_us) == 0,
+              "bounce de J1 a %llu µs recapturado", (unsigned long long)bounce_us);
+    }
+    check(multi_capture_sample(&capture, player_pin(0) | player_pin(2), stimulus_us + 215000) == 1u << 2,
+          "J3 não capturado durante o bounce de J1");
+    check(multi_capture_reaction_us(&capture, 0) == 210000, "tempo de J1 mudou com o bounce: %u",
+          multi_capture_reaction_us(&capture, 0));
+    check_rank("bounce", 2, (const uint8_t[]){0, 2, 1});
+    check_gap("bounce", 0, 2, 5000);
+
+    // Depois do fim da rodada nada mais entra
+    multi_capture_disarm(&capture);
+    check(multi_capture_sample(&capture, player_pin(1), stimulus_us + 300000) == 0, "captura depois de desarmar");
+    check_rank("desarmado", 2, (const uint8_t[]){0, 2, 1});
+
+    return check_result("multi_capture");
+}
@@ -0,0 +1,283 @@
+// Clipes de áudio (inc/pcm.h) de ponta a ponta: um WAV gerado aqui passa por tools/pcm_encode,
+// em PCM de 8 bits e em IMA-ADPCM, e pcm_decode reconstrói os níveis do PWM, conferidos contra
+// as amostras do WAV: exatos no PCM de 8 bits, dentro do erro de quantização no ADPCM. Os blocos
+// de decodificação variam de tamanho sem mudar o resultado. Por fim, pcm_init não reserva DMA:
+// os canais e o DMA timer só saem no primeiro pcm_play.
+//
+// Uso: test_pcm <pcm_encode> <diretório de trabalho>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+#include "sim.h"
+#include "hardware/dma.h"
+#include "inc/pcm.h"
+
+#define wav_rate 8000
+#define sample_count 6000
+
+static int16_t samples[sample_count];
+
+// Amostras com salto no sinal, e quantas o ADPCM leva para alcançá-lo
+static const int jumps[] = {200, 2000, 2100, 2200, 2300, 2400, 2500, 2600, 2700, 2800, 4400};
+#define settle_samples 16
+
+// Silêncio, seno de 440 Hz, degraus, seno quase no fundo de escala e um decaimento
+static void generate_samples(void)
+{
+    for (int i = 0; i < sample_count; i++)
+    {
+        double t = (double)i / wav_rate;
+        double value = 0;
+        if (i < 200)
+            value = 0;
+        else if (i < 2000)
+            value = 12000 * sin(2 * M_PI * 440 * t);
+        else if (i < 2800)
+            value = (i / 100) % 2 ? 20000 : -20000;
+        else if (i < 4400)
+            value = 32000 * sin(2 * M_PI * 1000 * t);
+        else
+            value = 25000 * exp(-(i - 4400) / 300.0) * sin(2 * M_PI * 300 * t);
+        samples[i] = (int16_t)lround(value);
+    }
+}
+
+static void put16(uint8_t *p, uint16_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t value)
+{
+    put16(p, value & 0xFFFF);
+    put16(p + 2, value >> 16);
+}
+
+// WAV mono de 16 bits, com um bloco desconhecido antes do fmt (o encoder deve pulá-lo)
+static bool write_wav(const char *path)
+{
+    uint8_t header[56];
+    memcpy(header, "RIFF", 4);
+    put32(header + 4, sizeof(header) - 8 + sample_count * 2);
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "LIST", 4);
+    put32(header + 16, 4);
+    memcpy(header + 20, "INFO", 4);
+    memcpy(header + 24, "fmt ", 4);
+    put32(header + 28, 16);
+    put16(header + 32, 1);
+    put16(header + 34, 1);
+    put32(header + 36, wav_rate);
+    put32(header + 40, wav_rate * 2);
+    put16(header + 44, 2);
+    put16(header + 46, 16);
+    memcpy(header + 48, "data", 4);
+    put32(header + 52, sample_count * 2);
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fwrite(header, 1, sizeof(header), file);
+    for (int i = 0; i < sample_count; i++)
+    {
+        uint8_t bytes[2];
+        put16(bytes, (uint16_t)samples[i]);
+        fwrite(bytes, 1, 2, file);
+    }
+    return fclose(file) == 0;
+}
+
+static uint8_t clip_data[sample_count];
+
+// Lê o cabeçalho C gerado: os bytes e os campos do pcm_clip_t
+static bool read_clip(const char *path, pcm_clip_t *clip)
+{
+    static char text[128 * 1024];
+    FILE *file = fopen(path, "r");
+    if (!file)
+        return false;
+    size_t size = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    text[size] = '\0';
+
+    const char *start = strstr(text, "_data[");
+    const char *rate = strstr(text, ".sample_rate = ");
+    const char *count = strstr(text, ".samples = ");
+    start = start ? strchr(start, '{') : NULL;
+    if (!start || !rate || !count)
+        return false;
+
+    size_t length = 0;
+    char *end;
+    for (const char *p = start + 1; length < sizeof(clip_data); p = end + 1)
+    {
+        unsigned long value = strtoul(p, &end, 10);
+        if (end == p)
+            break;
+        clip_data[length++] = (uint8_t)value;
+    }
+
+    *clip = (pcm_clip_t){
+        .format = strstr(text, ".format = pcm_format_u8") ? pcm_format_u8 : pcm_format_ima_adpcm,
+        .sample_rate = (uint32_t)strtoul(rate + 15, NULL, 10),
+        .samples = (uint32_t)strtoul(count + 11, NULL, 10),
+        .data = clip_data,
+    };
+    size_t expected = clip->format == pcm_format_u8 ? clip->samples : (clip->samples + 1) / 2;
+    check(length == expected, "%s: %zu bytes para %u amostras", path, length, clip->samples);
+    return length == expected;
+}
+
+static bool encode(const char *encoder, const char *wav, const char *flags, const char *out, pcm_clip_t *clip)
+{
+    char command[2048];
+    snprintf(command, sizeof(command), "%s %s --name test_clip %s > %s", encoder, flags, wav, out);
+    if (system(command) != 0)
+    {
+        check(false, "pcm_encode falhou: %s", command);
+        return false;
+    }
+    return read_clip(out, clip) && clip->sample_rate == wav_rate && clip->samples == sample_count;
+}
+
+// Decodifica o clipe inteiro em blocos de chunk amostras
+static size_t decode_all(const pcm_clip_t *clip, uint8_t volume, size_t chunk, uint16_t *levels)
+{
+    pcm_decoder_t decoder;
+    pcm_decoder_init(&decoder, clip, volume);
+    size_t total = 0, count;
+    while ((count = pcm_decode(&decoder, levels + total, chunk)) > 0)
+        total += count;
+    return total;
+}
+
+// Nível do PWM de uma amostra de 16 bits, como o decodificador calcula
+static int reference_level(int32_t sample, uint8_t volume)
+{
+    return pcm_level_silence + ((sample * volume) >> 16);
+}
+
+static void check_clip(const char *name, const pcm_clip_t *clip, uint8_t volume)
+{
+    static uint16_t levels[sample_count], chunked[sample_count];
+    static const size_t chunks[] = {1, 7, 100};
+
+    size_t total = decode_all(clip, volume, pcm_chunk_samples, levels);
+    check(total == sample_count, "%s: %zu amostras decodificadas", name, total);
+    for (size_t c = 0; c < count_of(chunks); c++)
+    {
+        decode_all(clip, volume, chunks[c], chunked);
+        check(!memcmp(levels, chunked, sizeof(levels)), "%s: blocos de %zu amostras mudam o resultado", name,
+              chunks[c]);
+    }
+
+    // O ADPCM começa com passo mínimo e leva algumas amostras para alcançar cada salto (início
+    // de trecho, bordas dos degraus): o erro conta depois de settle_samples de cada salto
+    int worst = 0, worst_at = 0, settled = 0;
+    double squares = 0;
+    for (int i = 0; i < sample_count; i++)
+    {
+        bool settling = false;
+        for (size_t j = 0; j < count_of(jumps); j++)
+            settling = settling || (i >= jumps[j] && i < jumps[j] + settle_samples);
+        if (settling && clip->format == pcm_format_ima_adpcm)
+            continue;
+
+        // PCM de 8 bits: o byte guarda os 8 bits altos da amostra
+        int32_t stored = clip->format == pcm_format_u8 ? (samples[i] >> 8) * 256 : samples[i];
+        int error = abs((int)levels[i] - reference_level(stored, volume));
+        squares += (double)error * error;
+        settled++;
+        if (error > worst)
+        {
+            worst = error;
+            worst_at = i;
+        }
+    }
+    double rms = sqrt(squares / settled);
+    printf("%s: erro máximo %d níveis (amostra %d), RMS %.3f\n", name, worst, worst_at, rms);
+
+    if (clip->format == pcm_format_u8)
+    {
+        check(worst == 0, "%s: amostra %d com %d níveis de erro", name, worst_at, worst);
+    }
+    else
+    {
+        // O pior caso é o seno de 1 kHz quase no fundo de escala (~25% da escala por amostra)
+        check(worst <= volume / 16, "%s: erro de %d níveis na amostra %d", name, worst, worst_at);
+        check(rms <= volume / 32.0, "%s: erro RMS de %.3f níveis", name, rms);
+    }
+
+    // Silêncio no início sai no nível de silêncio, com ou sem volume
+    check(levels[0] == pcm_level_silence && levels[199] == pcm_level_silence, "%s: silêncio em %u e %u", name,
+          levels[0], levels[199]);
+}
+
+// Canais de DMA livres agora (reservados e devolvidos na hora)
+static int free_dma_channels(void)
+{
+    int claimed[NUM_DMA_CHANNELS], count = 0;
+    while (count < NUM_DMA_CHANNELS && (claimed[count] = dma_claim_unused_channel(false)) >= 0)
+        count++;
+    for (int i = 0; i < count; i++)
+        dma_channel_unclaim(claimed[i]);
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "uso: test_pcm <pcm_encode> <diretório>\n");
+        return 2;
+    }
+    generate_samples();
+
+    char wav[512], out[512];
+    snprintf(wav, sizeof(wav), "%s/pcm_test.wav", argv[2]);
+    check(write_wav(wav), "WAV %s não gravado", wav);
+
+    pcm_clip_t u8, adpcm;
+    snprintf(out, sizeof(out), "%s/pcm_u8.h", argv[2]);
+    if (encode(argv[1], wav, "--u8", out, &u8))
+    {
+        check(u8.format == pcm_format_u8, "--u8 gerou outro formato");
+        check_clip("PCM de 8 bits, volume 255", &u8, 255);
+        check_clip("PCM de 8 bits, volume 64", &u8, 64);
+    }
+    else
+    {
+        check(false, "clipe PCM de 8 bits inválido");
+    }
+
+    snprintf(out, sizeof(out), "%s/pcm_adpcm.h", argv[2]);
+    if (encode(argv[1], wav, "", out, &adpcm))
+    {
+        check(adpcm.format == pcm_format_ima_adpcm, "o padrão não gerou IMA-ADPCM");
+        check_clip("IMA-ADPCM, volume 255", &adpcm, 255);
+        check_clip("IMA-ADPCM, volume 64", &adpcm, 64);
+    }
+    else
+    {
+        check(false, "clipe IMA-ADPCM inválido");
+    }
+
+    // Os recursos do DMA só são reservados quando um clipe toca, e uma vez só
+    int before = free_dma_channels();
+    pcm_init(10);
+    check(free_dma_channels() == before, "pcm_init reservou canais de DMA");
+    check(pcm_play(&adpcm, 255) && pcm_playing(), "pcm_play recusou o clipe");
+    check(free_dma_channels() == before - 2, "pcm_play reservou %d canais", before - free_dma_channels());
+    pcm_stop();
+    check(pcm_play(&u8, 255), "segundo pcm_play recusado");
+    check(free_dma_channels() == before - 2, "segundo pcm_play reservou mais canais");
+    pcm_stop();
+    check(!pcm_playing(), "pcm_stop não parou o clipe");
+
+    return check_result("pcm");
+}
@@ -0,0 +1,178 @@
+// Sorteios do atraso (inc/random.c): limites das distribuições uniforme e exponencial, a média
+// da exponencial truncada contra a fórmula, os pesos da tabela e a independência das sementes,
+// entre sementes vizinhas e entre os estados dos dois núcleos.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "check.h"
+#include "sim.h"
+#include "inc/random.h"
+
+#define samples 200000
+
+// Média amostral de (atraso - min_ms), conferindo que todo atraso fica na faixa
+static double sample_excess(const char *name, const foreperiod_dist_t *dist, uint32_t *lowest, uint32_t *highest)
+{
+    uint64_t sum = 0;
+    *lowest = UINT32_MAX;
+    *highest = 0;
+
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        uint32_t ms = foreperiod_sample_ms(dist);
+        if (ms < *lowest)
+            *lowest = ms;
+        if (ms > *highest)
+            *highest = ms;
+        sum += ms - dist->min_ms;
+    }
+    check(*lowest >= dist->min_ms && *highest <= dist->max_ms, "%s: atrasos de %u a %u ms fora de [%u, %u]", name,
+          *lowest, *highest, dist->min_ms, dist->max_ms);
+    return (double)sum / samples;
+}
+
+// Exponencial de média mean truncada (por rejeição) em span: mean - span / (e^(span/mean) - 1)
+static double truncated_mean(double mean, double span)
+{
+    return mean - span / expm1(span / mean);
+}
+
+static void check_exponential(const char *name, uint32_t min_ms, uint32_t max_ms, uint32_t mean_ms)
+{
+    const foreperiod_dist_t dist = {.kind = foreperiod_exponential, .min_ms = min_ms, .max_ms = max_ms, .mean_ms = mean_ms};
+    uint32_t lowest, highest;
+    double mean = sample_excess(name, &dist, &lowest, &highest);
+    double expected = truncated_mean(mean_ms, max_ms - min_ms);
+
+    printf("%s: média do excesso %.1f ms, esperada %.1f\n", name, mean, expected);
+    check(fabs(mean - expected) <= expected * 0.01, "%s: média do excesso %.1f ms, esperada %.1f", name, mean,
+          expected);
+    check(lowest < min_ms + mean_ms / 100, "%s: menor atraso %u ms longe de min_ms", name, lowest);
+}
+
+// Fração de bits iguais entre dois geradores semeados com seed_a e seed_b no núcleo 0
+static double matching_bits(uint64_t seed_a, uint64_t seed_b)
+{
+    uint32_t a[4096];
+    uint64_t equal = 0;
+
+    random_seed(0, seed_a);
+    for (size_t i = 0; i < count_of(a); i++)
+        a[i] = random_u32();
+    random_seed(0, seed_b);
+    for (size_t i = 0; i < count_of(a); i++)
+        equal += 32 - __builtin_popcount(a[i] ^ random_u32());
+    return (double)equal / (32.0 * count_of(a));
+}
+
+int main(void)
+{
+    random_seed(0, 1);
+
+    // random_below: sempre abaixo do limite, inclusive nos extremos
+    static const uint32_t bounds[] = {1, 2, 3, 7, 1000, 0x80000001u, UINT32_MAX};
+    for (size_t b = 0; b < count_of(bounds); b++)
+    {
+        for (uint32_t i = 0; i < 20000; i++)
+        {
+            uint32_t value = random_below(bounds[b]);
+            if (value >= bounds[b])
+            {
+                check(false, "random_below(%u) = %u", bounds[b], value);
+                break;
+            }
+        }
+    }
+    check(random_below(0) == 0, "random_below(0) diferente de 0");
+
+    // Uniforme: faixa [min, max), média no centro e cada décimo da faixa com ~10% dos atrasos
+    const foreperiod_dist_t uniform = {.kind = foreperiod_uniform, .min_ms = 1000, .max_ms = 5000};
+    uint32_t lowest, highest;
+    double mean = sample_excess("uniforme", &uniform, &lowest, &highest);
+    check(highest < uniform.max_ms, "uniforme: max_ms sorteado");
+    check(lowest < 1010 && highest > 4990, "uniforme: atrasos só de %u a %u ms", lowest, highest);
+    check(fabs(mean - 2000) < 2000 * 0.01, "uniforme: média do excesso %.1f ms, esperada 2000", mean);
+
+    uint32_t tenths[10] = {0};
+    const foreperiod_dist_t digits = {.kind = foreperiod_uniform, .min_ms = 0, .max_ms = 10};
+    for (uint32_t i = 0; i < samples; i++)
+        tenths[foreperiod_sample_ms(&digits)]++;
+    for (int d = 0; d < 10; d++)
+        check(fabs(tenths[d] / (double)samples - 0.1) < 0.005, "uniforme em [0, 10): %d com %u de %u", d, tenths[d],
+              samples);
+
+    // Exponencial: média 1 em Q16 e, truncada, a média da fórmula com pouco e muito corte
+    uint64_t q16_sum = 0;
+    for (uint32_t i = 0; i < samples; i++)
+        q16_sum += random_exponential_q16();
+    check(fabs(q16_sum / (double)samples / 65536.0 - 1.0) < 0.01, "exponencial de média 1: %.4f",
+          q16_sum / (double)samples / 65536.0);
+    check_exponential("exponencial 1000-5000 ms, média 1200", 1000, 5000, 1200);
+    check_exponential("exponencial 500-2500 ms, média 2000", 500, 2500, 2000);
+
+    // Tabela: frequências nos pesos
+    static const uint32_t values_ms[] = {1500, 2500, 4000};
+    static const uint32_t cumulative[] = {1, 3, 6};
+    const foreperiod_dist_t table = {.kind = foreperiod_table, .values_ms = values_ms, .cumulative = cumulative,
+                                     .count = count_of(values_ms)};
+    uint32_t hits[3] = {0};
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        uint32_t ms = foreperiod_sample_ms(&table);
+        for (size_t v = 0; v < count_of(values_ms); v++)
+            hits[v] += ms == values_ms[v];
+    }
+    for (size_t v = 0; v < count_of(values_ms); v++)
+    {
+        double expected = (cumulative[v] - (v ? cumulative[v - 1] : 0)) / 6.0;
+        check(fabs(hits[v] / (double)samples - expected) < 0.005, "tabela: %u ms em %u de %u sorteios", values_ms[v],
+              hits[v], samples);
+    }
+
+    // Sementes vizinhas dão sequências sem relação: ~50% dos bits iguais
+    for (uint64_t seed = 0; seed < 8; seed++)
+    {
+        double equal = matching_bits(seed, seed + 1);
+        check(fabs(equal - 0.5) < 0.01, "sementes %llu e %llu: %.4f dos bits iguais", (unsigned long long)seed,
+              (unsigned long long)seed + 1, equal);
+    }
+
+    // Um estado por núcleo: sorteios do núcleo 1 não mexem na sequência do núcleo 0
+    uint32_t alone[64];
+    random_seed(0, 42);
+    for (size_t i = 0; i < count_of(alone); i++)
+        alone[i] = random_u32();
+    random_seed(0, 42);
+    random_seed(1, 42);
+    for (size_t i = 0; i < count_of(alone); i++)
+    {
+        sim_set_core(1);
+        random_u32();
+        sim_set_core(0);
+        uint32_t value = random_u32();
+        if (value != alone[i])
+        {
+            check(false, "sorteio %zu do núcleo 0 mudou com o núcleo 1 sorteando", i);
+            break;
+        }
+    }
+
+    // random_init semeia os núcleos com bits diferentes do ROSC, e cada boot com outros
+    uint32_t first[2][2];
+    for (int boot = 0; boot < 2; boot++)
+    {
+        sim_set_entropy_seed(1000 + boot);
+        random_init();
+        for (uint core = 0; core < NUM_CORES; core++)
+        {
+            sim_set_core(core);
+            first[boot][core] = random_u32();
+        }
+        sim_set_core(0);
+        check(first[boot][0] != first[boot][1], "boot %d: os dois núcleos começam com 0x%08x", boot, first[boot][0]);
+    }
+    check(first[0][0] != first[1][0], "dois boots com a mesma sequência no núcleo 0");
+
+    return check_result("random");
+}
@@ -0,0 +1,173 @@
+// Estimativas de inc/reaction_stats.c contra os valores exatos, em milhões de amostras de
+// distribuições parecidas com tempos de reação.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+#include "inc/reaction_stats.h"
+
+#define samples 2000000
+
+// Erros aceitos: média e desvio vêm de somas exatas; os quantis são estimativas P²
+#define mean_tolerance_us 1
+#define stddev_tolerance 0.001
+#define quantile_tolerance 0.002
+
+static uint32_t values[samples];
+static uint64_t rng_state;
+
+// splitmix64: sequência reproduzível em qualquer host
+static uint64_t next_random(void)
+{
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double uniform(void)
+{
+    return ((next_random() >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static double gaussian(double mean, double sd)
+{
+    return mean + sd * sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+static uint32_t clamp_us(double us)
+{
+    return us < 1 ? 1 : (uint32_t)us;
+}
+
+// Ex-gaussiana: a forma típica de tempos de reação (cauda longa à direita)
+static uint32_t ex_gaussian(void)
+{
+    return clamp_us(gaussian(250000, 30000) - 80000 * log(uniform()));
+}
+
+static uint32_t flat(void)
+{
+    return 150000 + next_random() % 300000;
+}
+
+// Duas populações: respostas atentas e distraídas
+static uint32_t bimodal(void)
+{
+    return next_random() % 10 < 7 ? clamp_us(gaussian(220000, 25000)) : clamp_us(gaussian(600000, 60000));
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Quantil exato pelo posto mais próximo
+static uint32_t exact_quantile(const uint32_t *sorted, size_t n, double p)
+{
+    size_t rank = (size_t)ceil(p * n);
+    return sorted[rank ? rank - 1 : 0];
+}
+
+static void check_quantile(const char *name, const char *label, uint32_t estimate, uint32_t exact)
+{
+    double error = fabs((double)estimate - exact) / exact;
+    check(error <= quantile_tolerance, "%s: %s estimado %u, exato %u (erro %.3f%%)", name, label, estimate, exact,
+          error * 100);
+}
+
+static void check_distribution(const char *name, uint32_t (*draw)(void), uint64_t seed)
+{
+    static reaction_stats_t stats;
+    reaction_stats_init(&stats);
+    rng_state = seed;
+
+    double sum = 0;
+    for (size_t i = 0; i < samples; i++)
+    {
+        values[i] = draw();
+        sum += values[i];
+        reaction_stats_add(&stats, values[i]);
+    }
+
+    double mean = sum / samples, m2 = 0;
+    for (size_t i = 0; i < samples; i++)
+    {
+        m2 += (values[i] - mean) * (values[i] - mean);
+    }
+    double stddev = sqrt(m2 / (samples - 1));
+    qsort(values, samples, sizeof(values[0]), compare_u32);
+
+    check(stats.count == samples, "%s: contagem %u", name, stats.count);
+    check(stats.min_us == values[0] && stats.max_us == values[samples - 1], "%s: min %u max %u, exatos %u %u",
+          name, stats.min_us, stats.max_us, values[0], values[samples - 1]);
+    check(fabs(reaction_stats_mean_us(&stats) - mean) <= mean_tolerance_us, "%s: média %u, exata %.1f", name,
+          reaction_stats_mean_us(&stats), mean);
+    check(fabs(reaction_stats_stddev_us(&stats) - stddev) <= stddev * stddev_tolerance,
+          "%s: desvio %u, exato %.1f", name, reaction_stats_stddev_us(&stats), stddev);
+
+    check_quantile(name, "P50", reaction_stats_quantile_us(&stats.p50, stats.count),
+                   exact_quantile(values, samples, 0.50));
+    check_quantile(name, "P90", reaction_stats_quantile_us(&stats.p90, stats.count),
+                   exact_quantile(values, samples, 0.90));
+    check_quantile(name, "P99", reaction_stats_quantile_us(&stats.p99, stats.count),
+                   exact_quantile(values, samples, 0.99));
+
+    // Histograma: todas as amostras, cada uma na faixa do próprio valor
+    uint64_t total = 0;
+    for (uint32_t bucket = 0; bucket < reaction_stats_buckets; bucket++)
+    {
+        total += stats.histogram[bucket];
+    }
+    check(total == samples, "%s: histograma com %llu amostras", name, (unsigned long long)total);
+    uint32_t below = 0;
+    for (uint32_t bucket = 0; bucket < reaction_stats_bucket(values[samples / 2]); bucket++)
+    {
+        below += stats.histogram[bucket];
+    }
+    check(below <= samples / 2, "%s: %u amostras abaixo da faixa da mediana", name, below);
+}
+
+int main(void)
+{
+    check_distribution("ex-gaussiana", ex_gaussian, 1);
+    check_distribution("uniforme", flat, 2);
+    check_distribution("bimodal", bimodal, 3);
+
+    // Até cinco amostras os quantis são exatos
+    reaction_stats_t stats;
+    reaction_stats_init(&stats);
+    reaction_stats_add(&stats, 300000);
+    reaction_stats_add(&stats, 100000);
+    reaction_stats_add(&stats, 200000);
+    check(reaction_stats_quantile_us(&stats.p50, stats.count) == 200000, "P50 de 3 amostras: %u",
+          reaction_stats_quantile_us(&stats.p50, stats.count));
+    check(reaction_stats_quantile_us(&stats.p99, stats.count) == 300000, "P99 de 3 amostras: %u",
+          reaction_stats_quantile_us(&stats.p99, stats.count));
+    check(reaction_stats_stddev_us(&stats) == 100000, "desvio de 3 amostras: %u", reaction_stats_stddev_us(&stats));
+    reaction_stats_add(&stats, 500000);
+    reaction_stats_add(&stats, 400000);
+    check(reaction_stats_quantile_us(&stats.p50, stats.count) == 300000, "P50 de 5 amostras: %u",
+          reaction_stats_quantile_us(&stats.p50, stats.count));
+    check(reaction_stats_quantile_us(&stats.p90, stats.count) == 500000, "P90 de 5 amostras: %u",
+          reaction_stats_quantile_us(&stats.p90, stats.count));
+    check(reaction_stats_quantile_us(&stats.p99, stats.count) == 500000, "P99 de 5 amostras: %u",
+          reaction_stats_quantile_us(&stats.p99, stats.count));
+
+    // Valores acima do limite saturam
+    reaction_stats_add(&stats, UINT32_MAX);
+    check(stats.max_us == reaction_stats_max_us, "saturação: max %u", stats.max_us);
+
+    // As faixas do histograma são contíguas e crescentes
+    for (uint32_t bucket = 1; bucket < reaction_stats_buckets; bucket++)
+    {
+        uint32_t floor_us = reaction_stats_bucket_floor_us(bucket);
+        check(reaction_stats_bucket(floor_us) == bucket && reaction_stats_bucket(floor_us - 1) == bucket - 1,
+              "faixa %u começa em %u", bucket, floor_us);
+    }
+
+    return check_result("reaction_stats");
+}
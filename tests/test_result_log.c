@@ -0,0 +1,129 @@
+// Registro de resultados (inc/result_log.c) sobre a porta de arquivo do host: lote cheio,
+// programação e apagamento interrompidos por uma "queda de energia" e a retomada depois dela.
+//
+// Uso: test_result_log imagem.bin (recriada a cada execução)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+#include "inc/result_log.h"
+#include "host/result_log_file.h"
+
+static const char *image_path;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t first, last;
+    bool increasing;
+} survivors_t;
+
+static void collect(const result_record_t *record, void *user_data)
+{
+    survivors_t *survivors = user_data;
+
+    if (survivors->count == 0)
+        survivors->first = record->seq;
+    else if (record->seq <= survivors->last)
+        survivors->increasing = false;
+    survivors->last = record->seq;
+    survivors->count++;
+}
+
+// Queda de energia: a RAM se perde, e o registro é retomado da imagem gravada
+static survivors_t power_cycle(void)
+{
+    survivors_t survivors = {.increasing = true};
+
+    result_log_file_open(image_path);
+    result_log_init();
+    result_log_for_each(collect, &survivors);
+    return survivors;
+}
+
+static void check_survivors(const char *step, survivors_t survivors, uint32_t first, uint32_t last)
+{
+    check(survivors.increasing, "%s: registros fora de ordem", step);
+    check(survivors.count == last - first + 1 && survivors.first == first && survivors.last == last,
+          "%s: %u registros (%u a %u), esperados %u a %u", step, survivors.count, survivors.first, survivors.last,
+          first, last);
+    check(result_log_next_seq() == last + 1, "%s: próxima sequência %u, esperada %u", step, result_log_next_seq(),
+          last + 1);
+    check(result_log_pending() == 0, "%s: %u registros pendentes", step, result_log_pending());
+}
+
+// Um registro por página, gravado na hora
+static bool write_one(uint32_t timestamp_ms)
+{
+    return result_log_append(timestamp_ms, 250000, 0, 0) && result_log_service(timestamp_ms, true);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "uso: test_result_log imagem.bin\n");
+        return 2;
+    }
+    image_path = argv[1];
+    remove(image_path);
+
+    survivors_t empty = power_cycle();
+    check(empty.count == 0 && result_log_next_seq() == 0, "região apagada: %u registros", empty.count);
+
+    // Lote cheio: o 17º registro não entra, e o descarte é contado
+    uint32_t now_ms = 1000;
+    for (uint32_t i = 0; i < result_log_records_per_page; i++)
+    {
+        check(result_log_append(now_ms++, 200000 + i, 0, 0), "registro %u recusado com lote vazio", i);
+    }
+    check(!result_log_append(now_ms, 1, 0, 0) && result_log_dropped() == 1, "lote cheio aceitou um registro");
+    check(result_log_service(now_ms, false), "lote cheio não foi gravado");
+
+    // Página 1: lote incompleto, forçado
+    for (int i = 0; i < 5; i++)
+    {
+        result_log_append(now_ms++, 300000, 0, 0);
+    }
+    check(!result_log_service(now_ms, false), "lote incompleto gravado antes do tempo ocioso");
+    check(result_log_service(now_ms + result_log_idle_flush_ms, false), "lote incompleto não gravado depois do tempo ocioso");
+    check_survivors("dois lotes", power_cycle(), 0, 20);
+
+    // Programação interrompida na página 2 depois de 20 bytes: o registro 21 ficou inteiro,
+    // o 22 pela metade (CRC inválido) e o 23 nem começou
+    for (int i = 0; i < 3; i++)
+    {
+        result_log_append(now_ms++, 400000, 0, 0);
+    }
+    result_log_file_tear_after(20);
+    check(!result_log_service(now_ms, true), "programação interrompida informada como completa");
+    check_survivors("programação interrompida", power_cycle(), 0, 21);
+
+    // A página suja nunca é reprogramada: o próximo registro vai para a página 3
+    check(write_one(now_ms++), "gravação depois da programação interrompida");
+    check_survivors("depois da programação interrompida", power_cycle(), 0, 22);
+
+    // Páginas 4 a 255 com um registro cada: o anel inteiro ocupado
+    for (uint32_t page = 4; page < result_log_pages; page++)
+    {
+        check(write_one(now_ms++), "gravação da página %u", page);
+    }
+    check_survivors("anel cheio", power_cycle(), 0, 22 + result_log_pages - 4);
+
+    // A volta ao setor 0 o apaga, e o apagamento cai depois de 1000 bytes: as páginas 0 a 3
+    // voltam a 0xFF, e os registros das páginas 4 a 15 (23 a 34) continuam lá
+    uint32_t last = 22 + result_log_pages - 4;
+    result_log_append(now_ms++, 500000, 0, 0);
+    result_log_file_tear_after(1000);
+    check(!result_log_service(now_ms, true), "apagamento interrompido informado como completo");
+    check_survivors("apagamento interrompido", power_cycle(), 23, last);
+
+    // Depois da queda o setor 0 é apagado de novo, por inteiro, antes da gravação
+    check(write_one(now_ms++), "gravação depois do apagamento interrompido");
+    check_survivors("depois do apagamento interrompido", power_cycle(), 23 + result_log_pages_per_sector - 4,
+                    last + 1);
+
+    remove(image_path);
+    return check_result("result_log");
+}
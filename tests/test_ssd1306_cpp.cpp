@@ -0,0 +1,81 @@
+// Driver do display em C++ (inc/ssd1306.hpp) contra o driver em C: o mesmo quadro de 128x64
+// e a geometria de 128x32 (última página, comandos de inicialização e envio parcial).
+
+#include <cstring>
+
+extern "C"
+{
+#include "check.h"
+}
+#include "inc/ssd1306.hpp"
+
+namespace
+{
+
+using Display64 = ligeirinho::Ssd1306<128, 64>;
+
+// Barramento que só guarda a última transação (conferência da inicialização)
+struct RecordingBus
+{
+    static inline uint8_t last[32];
+    static inline size_t length;
+
+    static bool write(const uint8_t *data, size_t size)
+    {
+        length = size;
+        memcpy(last, data, size < sizeof(last) ? size : sizeof(last));
+        return true;
+    }
+};
+
+using Display32 = ligeirinho::Ssd1306<128, 32, RecordingBus>;
+
+static_assert(Display64::kBufferLength == ssd1306_buffer_length, "mesmo quadro do driver em C");
+static_assert(Display32::kPages == 4 && Display32::kBufferLength == 512, "geometria de 128x32");
+
+Display64 display;
+Display32 display32;
+
+uint8_t c_frame[ssd1306_buffer_length];
+
+} // namespace
+
+int main()
+{
+    char text[] = "PRESSIONE A 09z";
+
+    ssd1306_draw_string(c_frame, 2, 8, text);
+    ssd1306_draw_string(c_frame, 0, 56, text);
+    ssd1306_draw_line(c_frame, 0, 0, ssd1306_width - 1, ssd1306_height - 1, true);
+    ssd1306_draw_line(c_frame, 100, 60, 3, 2, true);
+    ssd1306_set_pixel(c_frame, 77, 21, false);
+
+    display.clear();
+    display.draw_string(2, 8, text);
+    display.draw_string(0, 56, text);
+    display.draw_line(0, 0, Display64::kWidth - 1, Display64::kHeight - 1, true);
+    display.draw_line(100, 60, 3, 2, true);
+    display.set_pixel(77, 21, false);
+    check(memcmp(c_frame, display.frame(), sizeof(c_frame)) == 0, "quadro de 128x64 diferente do driver em C");
+
+    // 128x32: a última linha é a 31 (página 3), e o que passa dela é ignorado
+    display32.clear();
+    display32.draw_string(0, 24, "AB");
+    display32.draw_string(0, 32, "AB");
+    display32.draw_line(0, 31, 127, 31, true);
+    display32.draw_line(120, 20, 127, 40, true);
+    display32.set_pixel(127, 23, true);
+    check(display32.frame()[3 * 128 + 8] == (font[2 * 8] | 0x80), "128x32: 'B' na página 3 com a linha 31");
+    check(display32.frame()[3 * 128 + 79] == 0x80, "128x32: linha 31 ausente ou texto além da tela");
+
+    check(display32.init(), "128x32: inicialização recusada pelo barramento");
+    check(RecordingBus::last[7] == 31, "128x32: multiplex %u, esperado 31", RecordingBus::last[7]);
+    check(RecordingBus::last[12] == 0x02, "128x32: pinos COM 0x%02x, esperado 0x02", RecordingBus::last[12]);
+
+    check(display32.flush_pages(3, 3), "128x32: envio da página 3 recusado");
+    check(RecordingBus::length == 129 && RecordingBus::last[0] == 0x40, "128x32: envio de %zu bytes, esperados 129",
+          RecordingBus::length);
+    check(display32.frame()[2 * 128 + 127] & 0x80, "128x32: byte emprestado ao controle não foi restaurado");
+
+    return check_result("ssd1306_cpp");
+}
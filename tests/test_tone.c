@@ -0,0 +1,72 @@
+// Divisor do PWM do buzzer (tone_divider, inc/tone.c): erro de frequência em cada Hz da faixa
+// audível, nos dois clk_sys da firmware (inc/clock_scale.h), e os limites do alcance.
+
+#include <stdint.h>
+#include <stdio.h>
+#include "check.h"
+#include "inc/tone.h"
+#include "inc/clock_scale.h"
+
+// Varredura na faixa audível e erro máximo aceito com clk_sys de 125 MHz; o erro de
+// quantização do período cresce na proporção inversa do clock
+#define tone_sweep_min_hz 20
+#define tone_sweep_max_hz 20000
+#define tone_sweep_max_ppm 100
+#define tone_sweep_reference_khz 125000
+
+static double frequency_of(uint32_t clock_hz, tone_divider_t divider)
+{
+    return (double)clock_hz * 16.0 / ((double)divider.div * ((double)divider.top + 1.0));
+}
+
+static void check_sweep(uint32_t clock_hz)
+{
+    double worst_ppm = 0;
+    uint32_t worst_hz = 0;
+
+    for (uint32_t hz = tone_sweep_min_hz; hz <= tone_sweep_max_hz; hz++)
+    {
+        tone_divider_t divider;
+        if (!tone_divider(clock_hz, hz, &divider))
+        {
+            check(false, "%u Hz fora do alcance com clk_sys de %u Hz", hz, clock_hz);
+            continue;
+        }
+        check(divider.div >= tone_div_min && divider.div <= tone_div_max, "%u Hz: divisor %u fora do PWM", hz,
+              divider.div);
+
+        double actual = frequency_of(clock_hz, divider);
+        double ppm = (actual > hz ? actual - hz : hz - actual) / hz * 1e6;
+        if (ppm > worst_ppm)
+        {
+            worst_ppm = ppm;
+            worst_hz = hz;
+        }
+    }
+
+    printf("clk_sys %u Hz: erro máximo %.2f ppm (%u Hz) em %u..%u Hz\n", clock_hz, worst_ppm, worst_hz,
+           tone_sweep_min_hz, tone_sweep_max_hz);
+    double max_ppm = tone_sweep_max_ppm * tone_sweep_reference_khz * 1000.0 / clock_hz;
+    check(worst_ppm <= max_ppm, "clk_sys %u Hz: erro de %.2f ppm em %u Hz (máximo %.0f)", clock_hz, worst_ppm,
+          worst_hz, max_ppm);
+}
+
+int main(void)
+{
+    check_sweep(clock_scale_high_khz * 1000);
+    check_sweep(clock_scale_low_khz * 1000);
+
+    // Alcance: de ~8 Hz (maior divisor, top cheio) a clk_sys / 2
+    const uint32_t clock_hz = clock_scale_high_khz * 1000;
+    tone_divider_t divider;
+    check(!tone_divider(clock_hz, 0, &divider), "0 Hz aceito");
+    check(tone_divider(clock_hz, 8, &divider) && frequency_of(clock_hz, divider) > 7.99 &&
+              frequency_of(clock_hz, divider) < 8.01,
+          "8 Hz: divisor %u, top %u", divider.div, divider.top);
+    check(!tone_divider(clock_hz, 7, &divider), "7 Hz aceito");
+    check(tone_divider(clock_hz, clock_hz / 2, &divider) && divider.div == tone_div_min && divider.top == 1,
+          "clk_sys / 2: divisor %u, top %u", divider.div, divider.top);
+    check(!tone_divider(clock_hz, clock_hz / 2 + 1, &divider), "acima de clk_sys / 2 aceito");
+
+    return check_result("tone");
+}
@@ -0,0 +1,623 @@
+// Converte uma sequência de PNGs num clipe de animação para inc/anim.h.
+//
+// Uso: anim_encode [--name nome] [--frame-ms ms] [--threshold 0-255] [--invert]
+//                  quadro0.png quadro1.png ... > clipe.h
+//
+// Cada PNG tem 128 colunas e 8 a 64 linhas, múltiplo de 8 (as páginas de cima da tela);
+// qualquer tipo de cor, 1 a 16 bits, sem entrelaçamento. Um pixel acende com luminância a
+// partir de --threshold (padrão 128) e alfa a partir de 128; --invert acende os escuros.
+// Cada quadro vira a diferença para o anterior (o primeiro, para a tela apagada) no formato
+// de inc/anim.h, conferida decodificando de volta. A saída é um cabeçalho C com os bytes em
+// flash e a estrutura anim_clip_t pronta para anim_start.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// Geometria do display e operações do formato (inc/ssd1306_i2c.h e inc/anim.h)
+constexpr int kWidth = 128;
+constexpr int kMaxPages = 8;
+
+constexpr uint8_t kOpEnd = 0x00;
+constexpr uint8_t kOpSkip = 0x00;
+constexpr uint8_t kOpRepeat = 0x40;
+constexpr uint8_t kOpCopy = 0x80;
+
+// ---------------------------------------------------------------------------------------
+// Inflate (RFC 1951), o suficiente para o zlib dos PNGs
+
+class Inflater
+{
+public:
+    Inflater(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    bool run(std::vector<uint8_t> &out)
+    {
+        bool last = false;
+        while (!last)
+        {
+            last = bits(1);
+            int type = bits(2);
+            bool ok = type == 0 ? stored(out) : type == 1 ? fixed(out) : type == 2 ? dynamic(out) : false;
+            if (!ok || error_)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    struct Huffman
+    {
+        uint16_t count[16] = {};
+        uint16_t symbol[288] = {};
+    };
+
+    int bits(int need)
+    {
+        int value = 0;
+        for (int i = 0; i < need; i++)
+        {
+            if (pos_ >= size_)
+            {
+                error_ = true;
+                return 0;
+            }
+            value |= ((data_[pos_] >> bit_) & 1) << i;
+            if (++bit_ == 8)
+            {
+                bit_ = 0;
+                pos_++;
+            }
+        }
+        return value;
+    }
+
+    bool stored(std::vector<uint8_t> &out)
+    {
+        if (bit_)
+        {
+            bit_ = 0;
+            pos_++;
+        }
+        if (pos_ + 4 > size_)
+            return false;
+        unsigned length = data_[pos_] | (data_[pos_ + 1] << 8);
+        unsigned complement = data_[pos_ + 2] | (data_[pos_ + 3] << 8);
+        pos_ += 4;
+        if (length != (~complement & 0xFFFF) || pos_ + length > size_)
+            return false;
+        out.insert(out.end(), data_ + pos_, data_ + pos_ + length);
+        pos_ += length;
+        return true;
+    }
+
+    static bool build(Huffman &h, const uint8_t *lengths, int n)
+    {
+        memset(h.count, 0, sizeof(h.count));
+        for (int i = 0; i < n; i++)
+            h.count[lengths[i]]++;
+        h.count[0] = 0;
+
+        uint16_t offsets[16] = {};
+        for (int len = 1; len < 15; len++)
+            offsets[len + 1] = offsets[len] + h.count[len];
+        for (int i = 0; i < n; i++)
+        {
+            if (lengths[i])
+                h.symbol[offsets[lengths[i]]++] = i;
+        }
+        return true;
+    }
+
+    int decode(const Huffman &h)
+    {
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len < 16; len++)
+        {
+            code |= bits(1);
+            int count = h.count[len];
+            if (code - count < first)
+                return h.symbol[index + (code - first)];
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        error_ = true;
+        return -1;
+    }
+
+    bool codes(std::vector<uint8_t> &out, const Huffman &lengths, const Huffman &distances)
+    {
+        static const uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const uint16_t kDistanceBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                                   33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                                   1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                   6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        while (true)
+        {
+            int symbol = decode(lengths);
+            if (symbol < 0)
+                return false;
+            if (symbol < 256)
+            {
+                out.push_back(uint8_t(symbol));
+                continue;
+            }
+            if (symbol == 256)
+                return true;
+
+            symbol -= 257;
+            if (symbol >= 29)
+                return false;
+            size_t length = kLengthBase[symbol] + bits(kLengthExtra[symbol]);
+            int code = decode(distances);
+            if (code < 0 || code >= 30)
+                return false;
+            size_t distance = kDistanceBase[code] + bits(kDistanceExtra[code]);
+            if (distance > out.size() || error_)
+                return false;
+            for (size_t i = 0; i < length; i++)
+                out.push_back(out[out.size() - distance]);
+        }
+    }
+
+    bool fixed(std::vector<uint8_t> &out)
+    {
+        uint8_t lengths[288 + 30];
+        int i = 0;
+        for (; i < 144; i++)
+            lengths[i] = 8;
+        for (; i < 256; i++)
+            lengths[i] = 9;
+        for (; i < 280; i++)
+            lengths[i] = 7;
+        for (; i < 288; i++)
+            lengths[i] = 8;
+        for (; i < 288 + 30; i++)
+            lengths[i] = 5;
+
+        Huffman literal, distance;
+        build(literal, lengths, 288);
+        build(distance, lengths + 288, 30);
+        return codes(out, literal, distance);
+    }
+
+    bool dynamic(std::vector<uint8_t> &out)
+    {
+        static const uint8_t kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        int literals = bits(5) + 257, distances = bits(5) + 1, code_lengths = bits(4) + 4;
+        if (literals > 286 || distances > 30)
+            return false;
+
+        uint8_t lengths[288 + 30] = {};
+        for (int i = 0; i < code_lengths; i++)
+            lengths[kOrder[i]] = uint8_t(bits(3));
+        Huffman lencode;
+        build(lencode, lengths, 19);
+
+        memset(lengths, 0, sizeof(lengths));
+        int index = 0;
+        while (index < literals + distances)
+        {
+            int symbol = decode(lencode);
+            if (symbol < 0)
+                return false;
+            if (symbol < 16)
+            {
+                lengths[index++] = uint8_t(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            int repeat;
+            if (symbol == 16)
+            {
+                if (index == 0)
+                    return false;
+                value = lengths[index - 1];
+                repeat = 3 + bits(2);
+            }
+            else
+            {
+                repeat = symbol == 17 ? 3 + bits(3) : 11 + bits(7);
+            }
+            if (index + repeat > literals + distances)
+                return false;
+            while (repeat--)
+                lengths[index++] = value;
+        }
+
+        Huffman literal, distance;
+        build(literal, lengths, literals);
+        build(distance, lengths + literals, distances);
+        return codes(out, literal, distance);
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+    int bit_ = 0;
+    bool error_ = false;
+};
+
+// ---------------------------------------------------------------------------------------
+// PNG
+
+struct Image
+{
+    int width = 0, height = 0;
+    std::vector<uint8_t> luma, alpha; // Um byte por pixel
+};
+
+uint32_t be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+int paeth(int a, int b, int c)
+{
+    int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+bool read_png(const char *path, Image &image)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "anim_encode: nao foi possivel abrir %s\n", path);
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        raw.insert(raw.end(), chunk, chunk + n);
+    fclose(file);
+
+    static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (raw.size() < 8 || memcmp(raw.data(), kSignature, 8))
+    {
+        fprintf(stderr, "anim_encode: %s nao e um PNG\n", path);
+        return false;
+    }
+
+    int depth = 0, color = -1, interlace = 0;
+    std::vector<uint8_t> idat, palette, transparency;
+    for (size_t pos = 8; pos + 12 <= raw.size();)
+    {
+        uint32_t length = be32(&raw[pos]);
+        if (pos + 12 + length > raw.size())
+            break;
+        const uint8_t *type = &raw[pos + 4], *body = &raw[pos + 8];
+        if (!memcmp(type, "IHDR", 4) && length >= 13)
+        {
+            image.width = (int)be32(body);
+            image.height = (int)be32(body + 4);
+            depth = body[8];
+            color = body[9];
+            interlace = body[12];
+        }
+        else if (!memcmp(type, "PLTE", 4))
+            palette.assign(body, body + length);
+        else if (!memcmp(type, "tRNS", 4))
+            transparency.assign(body, body + length);
+        else if (!memcmp(type, "IDAT", 4))
+            idat.insert(idat.end(), body, body + length);
+        else if (!memcmp(type, "IEND", 4))
+            break;
+        pos += 12 + length;
+    }
+
+    static const int kChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+    if (color < 0 || color > 6 || !kChannels[color] || interlace || (depth != 1 && depth != 2 && depth != 4 &&
+                                                                      depth != 8 && depth != 16))
+    {
+        fprintf(stderr, "anim_encode: %s: tipo de PNG nao suportado (cor %d, %d bits%s)\n", path, color, depth,
+                interlace ? ", entrelacado" : "");
+        return false;
+    }
+
+    std::vector<uint8_t> pixels;
+    if (idat.size() < 2 || !Inflater(idat.data() + 2, idat.size() - 2).run(pixels))
+    {
+        fprintf(stderr, "anim_encode: %s: dados compactados invalidos\n", path);
+        return false;
+    }
+
+    int channels = kChannels[color];
+    size_t stride = ((size_t)image.width * channels * depth + 7) / 8;
+    size_t bpp = (size_t)channels * depth / 8 ? (size_t)channels * depth / 8 : 1;
+    if (pixels.size() < (stride + 1) * image.height)
+    {
+        fprintf(stderr, "anim_encode: %s: dados incompletos\n", path);
+        return false;
+    }
+
+    // Desfaz os filtros linha a linha, no próprio buffer
+    std::vector<uint8_t> previous(stride, 0);
+    image.luma.assign((size_t)image.width * image.height, 0);
+    image.alpha.assign((size_t)image.width * image.height, 255);
+    for (int y = 0; y < image.height; y++)
+    {
+        uint8_t filter = pixels[y * (stride + 1)];
+        uint8_t *line = &pixels[y * (stride + 1) + 1];
+        for (size_t i = 0; i < stride; i++)
+        {
+            int a = i >= bpp ? line[i - bpp] : 0, b = previous[i], c = i >= bpp ? previous[i - bpp] : 0;
+            int predictor = filter == 1 ? a : filter == 2 ? b : filter == 3 ? (a + b) / 2 : filter == 4 ? paeth(a, b, c) : 0;
+            line[i] = uint8_t(line[i] + predictor);
+        }
+        previous.assign(line, line + stride);
+
+        for (int x = 0; x < image.width; x++)
+        {
+            // Amostra s do canal ch, reduzida a 8 bits
+            auto sample = [&](int ch) -> int {
+                size_t bit = ((size_t)x * channels + ch) * depth;
+                if (depth == 16)
+                    return line[bit / 8];
+                int value = (line[bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+                return color == 3 ? value : value * 255 / ((1 << depth) - 1);
+            };
+
+            size_t index = (size_t)y * image.width + x;
+            int r, g, b, alpha = 255;
+            if (color == 3)
+            {
+                int entry = sample(0);
+                if ((size_t)entry * 3 + 2 >= palette.size())
+                    return false;
+                r = palette[entry * 3], g = palette[entry * 3 + 1], b = palette[entry * 3 + 2];
+                if ((size_t)entry < transparency.size())
+                    alpha = transparency[entry];
+            }
+            else if (color == 0 || color == 4)
+            {
+                r = g = b = sample(0);
+                if (color == 4)
+                    alpha = sample(1);
+            }
+            else
+            {
+                r = sample(0), g = sample(1), b = sample(2);
+                if (color == 6)
+                    alpha = sample(3);
+            }
+            image.luma[index] = uint8_t((r * 299 + g * 587 + b * 114) / 1000);
+            image.alpha[index] = uint8_t(alpha);
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------
+// Codificação (formato em inc/anim.h)
+
+using Frame = std::vector<uint8_t>; // kMaxPages * kWidth bytes, página a página
+
+void encode_page(const uint8_t *previous, const uint8_t *current, std::vector<uint8_t> &out)
+{
+    int column = 0;
+    while (column < kWidth)
+    {
+        // Colunas sem mudança: até o fim da página basta o 0x00
+        int same = 0;
+        while (column + same < kWidth && previous[column + same] == current[column + same])
+            same++;
+        if (column + same == kWidth)
+            break;
+        column += same;
+        for (; same > 0; same -= 63)
+            out.push_back(uint8_t(kOpSkip | (same > 63 ? 63 : same)));
+
+        // Trecho alterado: termina em 3 colunas iguais seguidas (pular sai mais barato)
+        int end = column;
+        for (int unchanged = 0; end < kWidth && unchanged < 3; end++)
+            unchanged = previous[end] == current[end] ? unchanged + 1 : 0;
+        while (previous[end - 1] == current[end - 1])
+            end--;
+
+        // Repetições de 3 ou mais bytes viram repeat; o resto, cópias
+        int literal = column;
+        while (column < end)
+        {
+            int run = 1;
+            while (column + run < end && run < 64 && current[column + run] == current[column])
+                run++;
+            if (run < 3 && column + run < end)
+            {
+                column += run;
+                continue;
+            }
+            if (run < 3)
+                column = end;
+
+            for (int start = literal; start < column;)
+            {
+                int count = column - start > 128 ? 128 : column - start;
+                out.push_back(uint8_t(kOpCopy | (count - 1)));
+                out.insert(out.end(), current + start, current + start + count);
+                start += count;
+            }
+            if (column < end)
+            {
+                out.push_back(uint8_t(kOpRepeat | (run - 1)));
+                out.push_back(current[column]);
+                column += run;
+            }
+            literal = column;
+        }
+    }
+    out.push_back(kOpEnd);
+}
+
+std::vector<uint8_t> encode_frame(const Frame &previous, const Frame &current)
+{
+    std::vector<uint8_t> out(1, 0);
+    for (int page = 0; page < kMaxPages; page++)
+    {
+        const uint8_t *p = &previous[page * kWidth], *c = &current[page * kWidth];
+        if (!memcmp(p, c, kWidth))
+            continue;
+        out[0] |= uint8_t(1u << page);
+        encode_page(p, c, out);
+    }
+    return out;
+}
+
+// Mesmo decodificador de anim_apply, para conferir a saída; false se o quadro for inválido
+bool apply_frame(Frame &frame, const std::vector<uint8_t> &delta)
+{
+    size_t pos = 1;
+    for (int page = 0; page < kMaxPages; page++)
+    {
+        if (!(delta[0] & (1u << page)))
+            continue;
+
+        uint8_t *row = &frame[page * kWidth];
+        unsigned column = 0;
+        while (true)
+        {
+            if (pos >= delta.size())
+                return false;
+            uint8_t op = delta[pos++];
+            if (op == kOpEnd)
+                break;
+            if (!(op & (kOpCopy | kOpRepeat)))
+            {
+                column += op;
+                continue;
+            }
+
+            bool copy = op & kOpCopy;
+            unsigned count = copy ? (op & 0x7Fu) + 1 : (op & 0x3Fu) + 1;
+            if (column + count > kWidth || pos + (copy ? count : 1) > delta.size())
+                return false;
+            if (copy)
+            {
+                memcpy(row + column, &delta[pos], count);
+                pos += count;
+            }
+            else
+            {
+                memset(row + column, delta[pos++], count);
+            }
+            column += count;
+        }
+    }
+    return pos == delta.size();
+}
+
+bool to_frame(const Image &image, int threshold, bool invert, Frame &frame)
+{
+    frame.assign(kMaxPages * kWidth, 0);
+    for (int y = 0; y < image.height; y++)
+    {
+        for (int x = 0; x < image.width; x++)
+        {
+            size_t index = (size_t)y * image.width + x;
+            bool on = (image.luma[index] >= threshold) != invert && image.alpha[index] >= 128;
+            if (on)
+                frame[(y / 8) * kWidth + x] |= uint8_t(1u << (y % 8));
+        }
+    }
+    return true;
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: anim_encode [--name nome] [--frame-ms ms] [--threshold 0-255] [--invert] "
+                    "quadro0.png quadro1.png ... > clipe.h\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string name = "anim";
+    long frame_ms = 100, threshold = 128;
+    bool invert = false;
+    std::vector<const char *> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--name") && i + 1 < argc)
+            name = argv[++i];
+        else if (!strcmp(argv[i], "--frame-ms") && i + 1 < argc)
+            frame_ms = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--threshold") && i + 1 < argc)
+            threshold = strtol(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--invert"))
+            invert = true;
+        else if (argv[i][0] != '-')
+            paths.push_back(argv[i]);
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (paths.empty() || paths.size() > 0xFFFF || frame_ms < 1 || frame_ms > 0xFFFF || threshold < 0 ||
+        threshold > 255)
+    {
+        usage();
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    Frame previous(kMaxPages * kWidth, 0), decoded = previous, current;
+    size_t largest = 0;
+    for (const char *path : paths)
+    {
+        Image image;
+        if (!read_png(path, image))
+            return 1;
+        if (image.width != kWidth || image.height < 8 || image.height > kMaxPages * 8 || image.height % 8)
+        {
+            fprintf(stderr, "anim_encode: %s tem %dx%d; o display tem %d colunas e ate %d linhas (multiplo de 8)\n",
+                    path, image.width, image.height, kWidth, kMaxPages * 8);
+            return 1;
+        }
+        to_frame(image, (int)threshold, invert, current);
+
+        std::vector<uint8_t> delta = encode_frame(previous, current);
+        if (!apply_frame(decoded, delta) || decoded != current)
+        {
+            fprintf(stderr, "anim_encode: %s: conferencia da codificacao falhou\n", path);
+            return 1;
+        }
+
+        largest = delta.size() > largest ? delta.size() : largest;
+        data.insert(data.end(), delta.begin(), delta.end());
+        previous = current;
+    }
+
+    printf("// Gerado por tools/anim_encode a partir de %zu quadros (%s ...)\n", paths.size(), paths[0]);
+    printf("#include \"inc/anim.h\"\n\n");
+    printf("static const uint8_t %s_data[%zu] = {", name.c_str(), data.size());
+    for (size_t i = 0; i < data.size(); i++)
+        printf("%s%u,", i % 16 ? " " : "\n    ", data[i]);
+    printf("\n};\n\n");
+    printf("static const anim_clip_t %s = {\n", name.c_str());
+    printf("    .frames = %zu,\n", paths.size());
+    printf("    .frame_ms = %ld,\n", frame_ms);
+    printf("    .length = %zu,\n", data.size());
+    printf("    .data = %s_data,\n", name.c_str());
+    printf("};\n");
+
+    fprintf(stderr, "anim_encode: %zu quadros, %zu bytes (%zu sem compressao), maior quadro %zu bytes\n", paths.size(),
+            data.size(), paths.size() * kMaxPages * kWidth, largest);
+    return 0;
+}
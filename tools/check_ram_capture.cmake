@@ -0,0 +1,118 @@
+# Confere no ELF que o caminho de captura (inc/ram_capture.h) está todo na SRAM.
+#
+# cmake -DELF=Ligeirinho.elf -DNM=arm-none-eabi-nm -DOBJDUMP=arm-none-eabi-objdump
+#       "-DSYMBOLS=gpio_callback;tone_step;..." "-DALLOWED=time_us_64;..." -P tools/check_ram_capture.cmake
+#
+# Falha se algum símbolo da lista (ou um clone dele, nome.constprop.0 etc.) estiver fora da
+# SRAM ou não existir, e se alguma função do conjunto chamar uma função na flash que não
+# esteja em ALLOWED (funções internas da SDK aceitas, comentadas no CMakeLists.txt). As
+# chamadas aceitas são listadas, para mostrar o que ainda passa pelo XIP.
+
+# SRAM do RP2040 (SRAM0-5)
+if (NOT DEFINED RAM_START)
+    set(RAM_START 0x20000000)
+endif()
+if (NOT DEFINED RAM_END)
+    set(RAM_END 0x20042000)
+endif()
+
+foreach (var ELF NM OBJDUMP SYMBOLS)
+    if (NOT ${var})
+        message(FATAL_ERROR "check_ram_capture: falta -D${var}")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${NM} --defined-only ${ELF} OUTPUT_VARIABLE nm_output RESULT_VARIABLE nm_result)
+if (NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "check_ram_capture: ${NM} falhou em ${ELF}")
+endif()
+
+math(EXPR ram_start "${RAM_START}")
+math(EXPR ram_end "${RAM_END}")
+
+# Endereço (inteiro) de cada símbolo definido
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+set(symbol_names)
+foreach (line IN LISTS nm_lines)
+    if (line MATCHES "^([0-9a-fA-F]+) [A-Za-z] ([A-Za-z_][^ ]*)$")
+        set(name ${CMAKE_MATCH_2})
+        math(EXPR address "0x${CMAKE_MATCH_1}")
+        set(address_${name} ${address})
+        list(APPEND symbol_names ${name})
+    endif()
+endforeach()
+
+set(failures)
+set(checked_names)
+foreach (symbol IN LISTS SYMBOLS)
+    set(found FALSE)
+    foreach (name IN LISTS symbol_names)
+        if (name STREQUAL symbol OR name MATCHES "^${symbol}\\.")
+            set(found TRUE)
+            list(APPEND checked_names ${name})
+            if (address_${name} LESS ram_start OR NOT address_${name} LESS ram_end)
+                math(EXPR hex "${address_${name}}" OUTPUT_FORMAT HEXADECIMAL)
+                list(APPEND failures "${name} em ${hex}")
+            endif()
+        endif()
+    endforeach()
+    if (NOT found)
+        list(APPEND failures "${symbol} não encontrado no ELF")
+    endif()
+endforeach()
+
+if (failures)
+    list(JOIN failures "\n  " text)
+    message(FATAL_ERROR "check_ram_capture: fora da SRAM (${RAM_START}-${RAM_END}):\n  ${text}")
+endif()
+list(LENGTH checked_names checked)
+message(STATUS "check_ram_capture: ${checked} símbolos do caminho de captura na SRAM")
+
+# Chamadas (bl, e desvios b para o início de outra função: chamadas de cauda) das funções do
+# conjunto, que o linker junta em .data; veneers de chamadas longas apontam para o destino
+execute_process(COMMAND ${OBJDUMP} -D -j .data --no-show-raw-insn ${ELF} OUTPUT_VARIABLE dump_output)
+string(REPLACE "\n" ";" dump_lines "${dump_output}")
+set(current "")
+set(flash_calls)
+foreach (line IN LISTS dump_lines)
+    if (line MATCHES "^[0-9a-fA-F]+ <([^>]+)>:$")
+        list(FIND checked_names ${CMAKE_MATCH_1} index)
+        if (index LESS 0)
+            set(current "")
+        else()
+            set(current ${CMAKE_MATCH_1})
+        endif()
+    elseif (current AND line MATCHES "\tb(l|\\.n|\\.w)?\t[0-9a-fA-F]+ <([^>+]+)>")
+        set(target ${CMAKE_MATCH_2})
+        if (target MATCHES "^__(.+)_veneer$")
+            set(target ${CMAKE_MATCH_1})
+        endif()
+        if (DEFINED address_${target} AND address_${target} LESS ram_start)
+            list(APPEND flash_calls "${current} -> ${target}")
+        endif()
+    endif()
+endforeach()
+
+set(allowed_calls)
+set(forbidden_calls)
+foreach (call IN LISTS flash_calls)
+    string(REGEX REPLACE "^.* -> " "" target "${call}")
+    list(FIND ALLOWED ${target} index)
+    if (index LESS 0)
+        list(APPEND forbidden_calls "${call}")
+    else()
+        list(APPEND allowed_calls "${call}")
+    endif()
+endforeach()
+
+if (allowed_calls)
+    list(REMOVE_DUPLICATES allowed_calls)
+    list(JOIN allowed_calls "\n  " text)
+    message(STATUS "check_ram_capture: chamadas aceitas para a flash (SDK):\n  ${text}")
+endif()
+if (forbidden_calls)
+    list(REMOVE_DUPLICATES forbidden_calls)
+    list(JOIN forbidden_calls "\n  " text)
+    message(FATAL_ERROR "check_ram_capture: chamadas do caminho de captura para a flash (marque o destino "
+                        "com capture_func ou, se for da SDK, justifique-o em LIGEIRINHO_RAM_CAPTURE_FLASH_ALLOWED):\n  ${text}")
+endif()
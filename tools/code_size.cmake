@@ -0,0 +1,89 @@
+# Compara o tamanho do código de dois conjuntos de funções num binário (nm -S).
+#
+# cmake -DELF=LigeirinhoBench -DNM=nm "-DC_SYMBOLS=ssd1306_init;ssd1306_draw_char;..."
+#       "-DCXX_PREFIX=ligeirinho::Ssd1306<" -P tools/code_size.cmake
+#
+# C_SYMBOLS: funções em C, somadas com os clones (nome.constprop.0 etc.); uma que não aparece
+# foi inlinada em quem a chama. CXX_PREFIX: início do nome demangled das funções de um modelo
+# em C++, somadas por instanciação. Só informa: não falha por tamanho.
+
+foreach (var ELF NM C_SYMBOLS CXX_PREFIX)
+    if (NOT ${var})
+        message(FATAL_ERROR "code_size: falta -D${var}")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${NM} -S -C --defined-only ${ELF} OUTPUT_VARIABLE nm_output RESULT_VARIABLE nm_result)
+if (NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "code_size: ${NM} falhou em ${ELF}")
+endif()
+
+# Só código (tipos t/T/W), com tamanho
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+set(code_lines)
+foreach (line IN LISTS nm_lines)
+    if (line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tTwW] (.+)$")
+        math(EXPR size "0x${CMAKE_MATCH_1}")
+        list(APPEND code_lines "${size}|${CMAKE_MATCH_2}")
+    endif()
+endforeach()
+
+message("driver em C:")
+set(c_total 0)
+foreach (symbol IN LISTS C_SYMBOLS)
+    set(found FALSE)
+    foreach (entry IN LISTS code_lines)
+        string(FIND "${entry}" "|" bar)
+        string(SUBSTRING "${entry}" 0 ${bar} size)
+        math(EXPR start "${bar} + 1")
+        string(SUBSTRING "${entry}" ${start} -1 name)
+        if (name STREQUAL symbol OR name MATCHES "^${symbol}\\.")
+            message("  ${size}\t${name}")
+            math(EXPR c_total "${c_total} + ${size}")
+            set(found TRUE)
+        endif()
+    endforeach()
+    if (NOT found)
+        message("  -\t${symbol} (inlinada)")
+    endif()
+endforeach()
+message("  ${c_total}\ttotal")
+
+# Funções do modelo, agrupadas pela instanciação (o nome até "::" depois dos argumentos)
+string(LENGTH "${CXX_PREFIX}" prefix_length)
+set(classes)
+foreach (entry IN LISTS code_lines)
+    string(FIND "${entry}" "|" bar)
+    string(SUBSTRING "${entry}" 0 ${bar} size)
+    math(EXPR start "${bar} + 1")
+    string(SUBSTRING "${entry}" ${start} -1 name)
+    string(SUBSTRING "${name}" 0 ${prefix_length} head)
+    if (NOT head STREQUAL CXX_PREFIX)
+        continue()
+    endif()
+
+    string(FIND "${name}" ">::" end)
+    math(EXPR end "${end} + 1")
+    string(SUBSTRING "${name}" 0 ${end} class)
+    string(MD5 key "${class}")
+    if (NOT DEFINED total_${key})
+        set(total_${key} 0)
+        set(lines_${key})
+        list(APPEND classes "${key}")
+        set(class_${key} "${class}")
+    endif()
+    math(EXPR total_${key} "${total_${key}} + ${size}")
+    string(REPLACE ";" "\\;" name "${name}")
+    list(APPEND lines_${key} "  ${size}\t${name}")
+endforeach()
+
+if (NOT classes)
+    message("driver em C++: nenhuma função de ${CXX_PREFIX} no binário")
+endif()
+foreach (key IN LISTS classes)
+    message("driver em C++ ${class_${key}}:")
+    foreach (line IN LISTS lines_${key})
+        message("${line}")
+    endforeach()
+    message("  ${total_${key}}\ttotal")
+endforeach()
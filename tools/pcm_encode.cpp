@@ -0,0 +1,218 @@
+// Converte um WAV (PCM de 8 ou 16 bits, mono ou estéreo) num clipe para inc/pcm.h.
+//
+// Uso: pcm_encode [--u8] [--name nome] entrada.wav > clipe.h
+//
+// Por padrão o áudio é codificado em IMA-ADPCM de 4 bits (nibble baixo primeiro); com --u8
+// fica em PCM de 8 bits sem sinal. Canais são misturados em mono e a taxa de amostragem é
+// mantida (reamostre antes, ex.: 8 kHz). A saída é um cabeçalho C com os bytes em flash e
+// a estrutura pcm_clip_t pronta para pcm_play.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int16_t kStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60,
+    66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371,
+    408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707,
+    1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+    7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385,
+    24623, 27086, 29794, 32767};
+
+const int8_t kIndexTable[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+struct Wav
+{
+    uint32_t sample_rate = 0;
+    std::vector<int16_t> samples; // Mono, 16 bits com sinal
+};
+
+uint32_t le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint16_t le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+bool read_wav(const char *path, Wav &wav)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "pcm_encode: nao foi possivel abrir %s\n", path);
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        raw.insert(raw.end(), chunk, chunk + n);
+    fclose(file);
+
+    if (raw.size() < 12 || memcmp(raw.data(), "RIFF", 4) || memcmp(raw.data() + 8, "WAVE", 4))
+    {
+        fprintf(stderr, "pcm_encode: %s nao e um WAV\n", path);
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    for (size_t pos = 12; pos + 8 <= raw.size();)
+    {
+        uint32_t size = le32(&raw[pos + 4]);
+        const uint8_t *body = &raw[pos + 8];
+        if (pos + 8 + size > raw.size())
+            size = (uint32_t)(raw.size() - pos - 8);
+
+        if (!memcmp(&raw[pos], "fmt ", 4) && size >= 16)
+        {
+            format = le16(body);
+            channels = le16(body + 2);
+            wav.sample_rate = le32(body + 4);
+            bits = le16(body + 14);
+        }
+        else if (!memcmp(&raw[pos], "data", 4))
+        {
+            if (format != 1 || (bits != 8 && bits != 16) || channels == 0)
+            {
+                fprintf(stderr, "pcm_encode: %s: so PCM de 8 ou 16 bits\n", path);
+                return false;
+            }
+            size_t frame = (size_t)channels * bits / 8;
+            for (size_t i = 0; i + frame <= size; i += frame)
+            {
+                int32_t sum = 0;
+                for (uint16_t c = 0; c < channels; c++)
+                {
+                    const uint8_t *s = body + i + c * bits / 8;
+                    sum += bits == 8 ? ((int32_t)s[0] - 128) << 8 : (int16_t)le16(s);
+                }
+                wav.samples.push_back((int16_t)(sum / channels));
+            }
+            return true;
+        }
+        pos += 8 + size + (size & 1);
+    }
+
+    fprintf(stderr, "pcm_encode: %s sem bloco data\n", path);
+    return false;
+}
+
+// Codificador IMA-ADPCM: o mesmo preditor do decodificador, para não acumular desvio
+std::vector<uint8_t> encode_adpcm(const std::vector<int16_t> &samples)
+{
+    std::vector<uint8_t> out((samples.size() + 1) / 2);
+    int32_t predictor = 0, index = 0;
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        int32_t step = kStepTable[index];
+        int32_t delta = samples[i] - predictor;
+        uint8_t nibble = 0;
+        if (delta < 0)
+        {
+            nibble = 8;
+            delta = -delta;
+        }
+
+        int32_t diff = step >> 3;
+        if (delta >= step)
+        {
+            nibble |= 4;
+            delta -= step;
+            diff += step;
+        }
+        if (delta >= step >> 1)
+        {
+            nibble |= 2;
+            delta -= step >> 1;
+            diff += step >> 1;
+        }
+        if (delta >= step >> 2)
+        {
+            nibble |= 1;
+            diff += step >> 2;
+        }
+
+        predictor += (nibble & 8) ? -diff : diff;
+        predictor = predictor > 32767 ? 32767 : predictor < -32768 ? -32768 : predictor;
+        index += kIndexTable[nibble & 7];
+        index = index < 0 ? 0 : index > 88 ? 88 : index;
+
+        out[i / 2] |= (i & 1) ? nibble << 4 : nibble;
+    }
+    return out;
+}
+
+void usage()
+{
+    fprintf(stderr, "uso: pcm_encode [--u8] [--name nome] entrada.wav > clipe.h\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool u8 = false;
+    std::string name = "clip";
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--u8"))
+            u8 = true;
+        else if (!strcmp(argv[i], "--name") && i + 1 < argc)
+            name = argv[++i];
+        else if (!path && argv[i][0] != '-')
+            path = argv[i];
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    if (!path)
+    {
+        usage();
+        return 2;
+    }
+
+    Wav wav;
+    if (!read_wav(path, wav))
+        return 1;
+
+    std::vector<uint8_t> data;
+    if (u8)
+    {
+        for (int16_t s : wav.samples)
+            data.push_back((uint8_t)((s >> 8) + 128));
+    }
+    else
+    {
+        data = encode_adpcm(wav.samples);
+    }
+
+    printf("// Gerado por tools/pcm_encode a partir de %s\n", path);
+    printf("#include \"inc/pcm.h\"\n\n");
+    printf("static const uint8_t %s_data[%zu] = {", name.c_str(), data.size());
+    for (size_t i = 0; i < data.size(); i++)
+        printf("%s%u,", i % 16 ? " " : "\n    ", data[i]);
+    printf("\n};\n\n");
+    printf("static const pcm_clip_t %s = {\n", name.c_str());
+    printf("    .format = %s,\n", u8 ? "pcm_format_u8" : "pcm_format_ima_adpcm");
+    printf("    .sample_rate = %u,\n", wav.sample_rate);
+    printf("    .samples = %zu,\n", wav.samples.size());
+    printf("    .data = %s_data,\n", name.c_str());
+    printf("};\n");
+
+    fprintf(stderr, "pcm_encode: %zu amostras a %u Hz, %zu bytes\n", wav.samples.size(), wav.sample_rate,
+            data.size());
+    return 0;
+}
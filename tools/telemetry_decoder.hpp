@@ -0,0 +1,149 @@
+// Decodificador incremental do fluxo de telemetria (formato descrito em inc/telemetry.h)
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "inc/telemetry.h"
+
+namespace ligeirinho
+{
+
+struct TelemetryRecord
+{
+    uint64_t time_us; // Tempo absoluto desde o boot
+    uint8_t type;     // Tipo sem o bit telemetry_absolute_time
+    uint64_t a, b;
+};
+
+struct TelemetryCounters
+{
+    uint64_t frames = 0;
+    uint64_t bad_frames = 0; // COBS/varint inválidos ou CRC incorreto
+    uint64_t unsynced = 0;   // Quadros com delta antes do primeiro tempo absoluto
+};
+
+// Recebe blocos de bytes em qualquer fragmentação e chama sink(record) para cada quadro válido
+class TelemetryDecoder
+{
+public:
+    template <typename Sink>
+    void feed(const uint8_t *data, size_t length, Sink &&sink)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            if (data[i] != 0)
+            {
+                // Quadros maiores que o máximo são lixo (ex.: texto de printf sem zeros)
+                if (encoded_.size() < kMaxEncoded)
+                    encoded_.push_back(data[i]);
+                else
+                    overflow_ = true;
+                continue;
+            }
+
+            if (!encoded_.empty())
+            {
+                TelemetryRecord record;
+                Result result = overflow_ ? Result::Bad : decode(record);
+                if (result == Result::Ok)
+                    sink(record);
+                else if (result == Result::Bad)
+                {
+                    // Um quadro pode ter sido perdido: os deltas só voltam a valer no próximo absoluto
+                    counters_.bad_frames++;
+                    synced_ = false;
+                }
+            }
+            encoded_.clear();
+            overflow_ = false;
+        }
+    }
+
+    const TelemetryCounters &counters() const { return counters_; }
+
+private:
+    static constexpr size_t kMaxEncoded = telemetry_max_frame;
+
+    enum class Result
+    {
+        Ok,
+        Bad,
+        Unsynced,
+    };
+
+    bool unstuff()
+    {
+        raw_.clear();
+        size_t i = 0;
+        while (i < encoded_.size())
+        {
+            uint8_t code = encoded_[i++];
+            if (code == 0 || i + code - 1 > encoded_.size())
+                return false;
+            for (uint8_t k = 1; k < code; k++)
+                raw_.push_back(encoded_[i++]);
+            if (code != 0xFF && i < encoded_.size())
+                raw_.push_back(0);
+        }
+        return true;
+    }
+
+    bool varint(size_t &pos, uint64_t &value) const
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (pos >= raw_.size() - 1) // O último byte é o CRC
+                return false;
+            uint8_t byte = raw_[pos++];
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    Result decode(TelemetryRecord &record)
+    {
+        if (!unstuff() || raw_.size() < 5)
+            return Result::Bad;
+        if (telemetry_crc8(raw_.data(), raw_.size() - 1) != raw_.back())
+            return Result::Bad;
+
+        size_t pos = 1;
+        uint64_t time = 0;
+        if (!varint(pos, time) || !varint(pos, record.a) || !varint(pos, record.b) ||
+            pos != raw_.size() - 1)
+            return Result::Bad;
+
+        counters_.frames++;
+        record.type = raw_[0] & ~telemetry_absolute_time;
+
+        if (raw_[0] & telemetry_absolute_time)
+        {
+            time_us_ = time;
+            synced_ = true;
+        }
+        else if (synced_)
+        {
+            time_us_ += time;
+        }
+        else
+        {
+            counters_.unsynced++;
+            return Result::Unsynced;
+        }
+        record.time_us = time_us_;
+        return Result::Ok;
+    }
+
+    std::vector<uint8_t> encoded_, raw_;
+    bool overflow_ = false;
+    bool synced_ = false;
+    uint64_t time_us_ = 0;
+    TelemetryCounters counters_;
+};
+
+} // namespace ligeirinho
@@ -0,0 +1,206 @@
+// Converte o trace em RAM enviado pela telemetria (registros telemetry_type_trace) em JSON
+// do Chrome Trace Event, aberto em chrome://tracing ou ui.perfetto.dev.
+//
+// Uso: trace_export [arquivo]   (sem arquivo, lê da entrada padrão; o JSON vai para a saída)
+//
+// Linhas do trace: "jogo" (intervalos de cada estado e resultados), "display" (cada envio
+// pelo I2C) e "irq" (callbacks de GPIO e alarmes). Capturas com vários envios do anel
+// são unidas sem repetir eventos.
+
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "inc/boot.h"
+#include "inc/trace_events.h"
+#include "telemetry_decoder.hpp"
+
+namespace
+{
+
+constexpr int kThreadGame = 1;
+constexpr int kThreadDisplay = 2;
+constexpr int kThreadIrq = 3;
+
+const char *boot_phase_name(uint64_t phase)
+{
+    switch (phase)
+    {
+    case boot_phase_main:
+        return "boot: main";
+    case boot_phase_inputs:
+        return "boot: entradas";
+    case boot_phase_display:
+        return "boot: display";
+    case boot_phase_usb:
+        return "boot: usb";
+    default:
+        return "boot";
+    }
+}
+
+const char *state_name(uint64_t state)
+{
+    switch (state)
+    {
+    case telemetry_state_idle:
+        return "ocioso";
+    case telemetry_state_foreperiod:
+        return "preparacao";
+    case telemetry_state_reaction:
+        return "reacao";
+    case telemetry_state_result:
+        return "resultado";
+    case telemetry_state_false_start:
+        return "queima de largada";
+    default:
+        return "estado desconhecido";
+    }
+}
+
+struct TraceEvent
+{
+    uint64_t time_us;
+    uint64_t id;
+    uint64_t arg;
+
+    bool operator<(const TraceEvent &other) const
+    {
+        return std::tie(time_us, id, arg) < std::tie(other.time_us, other.id, other.arg);
+    }
+};
+
+class JsonWriter
+{
+public:
+    void event(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char line[256];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+
+        out_ += first_ ? "\n" : ",\n";
+        out_ += line;
+        first_ = false;
+    }
+
+    void finish()
+    {
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", stdout);
+        fputs(out_.c_str(), stdout);
+        fputs("\n]}\n", stdout);
+    }
+
+private:
+    std::string out_;
+    bool first_ = true;
+};
+
+void thread_name(JsonWriter &json, int tid, const char *name)
+{
+    json.event("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, name);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    FILE *input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!input)
+    {
+        fprintf(stderr, "trace_export: nao foi possivel abrir %s\n", argv[1]);
+        return 1;
+    }
+
+    // Envios repetidos do anel se sobrepõem; o conjunto ordena e remove as repetições
+    std::set<TraceEvent> events;
+    ligeirinho::TelemetryDecoder decoder;
+    std::vector<uint8_t> chunk(1u << 16);
+    size_t count;
+
+    while ((count = fread(chunk.data(), 1, chunk.size(), input)) > 0)
+    {
+        decoder.feed(chunk.data(), count, [&](const ligeirinho::TelemetryRecord &record) {
+            if (record.type == telemetry_type_trace)
+                events.insert({record.time_us, record.a, record.b});
+        });
+    }
+    if (argc > 1)
+        fclose(input);
+
+    JsonWriter json;
+    thread_name(json, kThreadGame, "jogo");
+    thread_name(json, kThreadDisplay, "display");
+    thread_name(json, kThreadIrq, "irq");
+
+    const TraceEvent *state = nullptr;
+    for (const TraceEvent &event : events)
+    {
+        switch (event.id)
+        {
+        case trace_state:
+            // Cada estado vira um intervalo que termina na transição seguinte
+            if (state)
+                json.event("{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}",
+                           state_name(state->arg), kThreadGame, state->time_us, event.time_us - state->time_us);
+            state = &event;
+            break;
+        case trace_round:
+            json.event("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%" PRIu64 " ms\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64
+                       ",\"args\":{\"reaction_ms\":%" PRIu64 "}}",
+                       event.arg, kThreadGame, event.time_us, event.arg);
+            break;
+        case trace_wake:
+            // Registrado quando a firmware fica pronta; o intervalo começa no despertar
+            json.event("{\"ph\":\"X\",\"name\":\"despertar\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64
+                       ",\"dur\":%" PRIu64 "}",
+                       kThreadGame, event.time_us - event.arg, event.arg);
+            break;
+        case trace_boot:
+            json.event("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 "}",
+                       boot_phase_name(event.arg), kThreadGame, event.time_us);
+            break;
+        case trace_clock:
+            json.event("{\"ph\":\"C\",\"name\":\"clk_sys\",\"pid\":1,\"ts\":%" PRIu64 ",\"args\":{\"MHz\":%" PRIu64 "}}",
+                       event.time_us, event.arg);
+            break;
+        case trace_flush_begin:
+            json.event("{\"ph\":\"B\",\"name\":\"flush I2C\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64
+                       ",\"args\":{\"bytes\":%" PRIu64 "}}",
+                       kThreadDisplay, event.time_us, event.arg);
+            break;
+        case trace_flush_end:
+            json.event("{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 "}", kThreadDisplay, event.time_us);
+            break;
+        case trace_gpio_irq:
+            json.event("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"gpio %" PRIu64 "\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64
+                       ",\"args\":{\"events\":%" PRIu64 "}}",
+                       event.arg & 0xFF, kThreadIrq, event.time_us, event.arg >> 8);
+            break;
+        case trace_alarm:
+            json.event("{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 "}",
+                       event.arg == trace_alarm_stop_buzzer ? "stop_buzzer"
+                       : event.arg == trace_alarm_tone_note ? "tone_note"
+                                                            : "alarme",
+                       kThreadIrq, event.time_us);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // O último estado segue aberto até o fim da captura
+    if (state && !events.empty())
+        json.event("{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 "}",
+                   state_name(state->arg), kThreadGame, state->time_us, events.rbegin()->time_us - state->time_us);
+
+    json.finish();
+    fprintf(stderr, "trace_export: %zu eventos\n", events.size());
+    return 0;
+}